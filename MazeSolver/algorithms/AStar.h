@@ -2,13 +2,21 @@
 #include "../core/Maze.h"
 #include "../core/AlgorithmResult.h"
 #include "../core/Types.h"
+#include "SearchEngine.h"
 #include <functional>
+#include <memory>
 
 class AStar {
 public:
-    static AlgorithmResult solve(
-    Maze& maze,
-    std::function<void(Cell*, Cell*)> stepCallback = nullptr
-);
+    static AlgorithmResult solve(Maze& maze, std::function<void(Cell*, Cell*)> stepCallback = nullptr,
+                                 ResultDetail detail = ResultDetail::Full, SolveArena* arena = nullptr);
 
+    // The policies solve() picks from: landmarks when the maze has them, else by movement mode
+    typedef Search::Engine<Search::LandmarkHeuristic, Search::BinaryHeap<Search::PreferHigherG>> LandmarkEngine;
+    typedef Search::Engine<Search::Manhattan, Search::BucketQueue> FourWayEngine;
+    typedef Search::Engine<Search::Octile, Search::BinaryHeap<Search::PreferHigherG>> EightWayEngine;
+
+    // Resumable A*: the engine solve() would run on this maze, a few expansions at a time,
+    // so stepping expands the same cells in the same order
+    static std::unique_ptr<SearchStepper> makeStepper(Maze& maze, SolveArena* arena = nullptr);
 };
\ No newline at end of file
@@ -0,0 +1,244 @@
+#include "BitBFS.h"
+#include "../core/WallGrid.h"
+#include "../core/Profiler.h"
+#include <chrono>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define MAZE_AVX2_KERNEL 1
+#endif
+
+namespace {
+    const uint64_t TOP_BIT = uint64_t(1) << 63;
+
+    // Open-cell mask in WallGrid layout; padding bits past the last column are closed
+    template <class Words>
+    Words openMask(const Maze& maze, size_t wordsPerRow, Words open) {
+        open.resize(wordsPerRow * maze.getHeight());
+        maze.packWalls(open.data());
+        int width = maze.getWidth();
+        uint64_t padding = (width % 64 == 0) ? 0 : ~((uint64_t(1) << (width % 64)) - 1);
+        for (size_t w = 0; w < open.size(); ++w) {
+            open[w] = ~open[w];
+            if (w % wordsPerRow == wordsPerRow - 1) open[w] &= ~padding;
+        }
+        return open;
+    }
+
+    // Edges between cells of 'set': horizontal pairs inside and across words, vertical pairs
+    uint64_t countEdges(const std::pmr::vector<uint64_t>& set, size_t wordsPerRow) {
+        uint64_t edges = 0;
+        for (size_t w = 0; w < set.size(); ++w) {
+            edges += __builtin_popcountll(set[w] & (set[w] >> 1));
+            if (w % wordsPerRow + 1 < wordsPerRow) edges += (set[w] >> 63) & set[w + 1] & 1;
+            if (w + wordsPerRow < set.size()) edges += __builtin_popcountll(set[w] & set[w + wordsPerRow]);
+        }
+        return edges;
+    }
+
+    // Occluded fill (Kogge-Stone): grows 'seed' through the runs of 'open' it touches,
+    // both ways, in 6 shift steps per direction
+    inline uint64_t fillWord(uint64_t seed, uint64_t open) {
+        uint64_t up = seed, upOpen = open;
+        uint64_t down = seed, downOpen = open;
+        for (int shift = 1; shift < 64; shift <<= 1) {
+            up |= upOpen & (up << shift);
+            upOpen &= upOpen << shift;
+            down |= downOpen & (down >> shift);
+            downOpen &= downOpen >> shift;
+        }
+        return up | down;
+    }
+
+    // Closes runs for a batch of words: out[i] = fillWord(seeds[i], open[i])
+    void fillBatchScalar(const uint64_t* seeds, const uint64_t* open, uint64_t* out, size_t count) {
+        for (size_t i = 0; i < count; ++i) out[i] = fillWord(seeds[i], open[i]);
+    }
+
+#ifdef MAZE_AVX2_KERNEL
+    // Same as fillBatchScalar, four words per step
+    __attribute__((target("avx2")))
+    void fillBatchAvx2(const uint64_t* seeds, const uint64_t* open, uint64_t* out, size_t count) {
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m256i o = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(open + i));
+            __m256i up = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(seeds + i));
+            __m256i down = up, upOpen = o, downOpen = o;
+            for (int shift = 1; shift < 64; shift <<= 1) {
+                __m128i bits = _mm_cvtsi32_si128(shift);
+                up = _mm256_or_si256(up, _mm256_and_si256(upOpen, _mm256_sll_epi64(up, bits)));
+                upOpen = _mm256_and_si256(upOpen, _mm256_sll_epi64(upOpen, bits));
+                down = _mm256_or_si256(down, _mm256_and_si256(downOpen, _mm256_srl_epi64(down, bits)));
+                downOpen = _mm256_and_si256(downOpen, _mm256_srl_epi64(downOpen, bits));
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_or_si256(up, down));
+        }
+        for (; i < count; ++i) out[i] = fillWord(seeds[i], open[i]);
+    }
+#endif
+
+    typedef void (*FillKernel)(const uint64_t*, const uint64_t*, uint64_t*, size_t);
+
+    FillKernel pickKernel() {
+#ifdef MAZE_AVX2_KERNEL
+        if (__builtin_cpu_supports("avx2")) return fillBatchAvx2;
+#endif
+        return fillBatchScalar;
+    }
+}
+
+bool BitBFS::usesAvx2() {
+#ifdef MAZE_AVX2_KERNEL
+    return pickKernel() == fillBatchAvx2;
+#else
+    return false;
+#endif
+}
+
+DistanceField BitBFS::distances(const Maze& maze, int sx, int sy, int stopX, int stopY,
+                                std::pmr::vector<uint32_t>* order, std::pmr::memory_resource* memory,
+                                const RobustTimer* deadline) {
+    PROFILE_ZONE("bfs", "bit-parallel bfs");
+    auto began = std::chrono::high_resolution_clock::now();
+    const int width = maze.getWidth();
+    const size_t wordsPerRow = WallGrid::wordsForWidth(width);
+    
+    DistanceField field(memory);
+    field.width = width;
+    field.height = maze.getHeight();
+    field.distance.assign(static_cast<size_t>(width) * field.height, DistanceField::UNREACHED);
+    
+    std::pmr::vector<uint64_t> open = openMask(maze, wordsPerRow, std::pmr::vector<uint64_t>(memory));
+    if (sx >= 0 && sx < width && sy >= 0 && sy < field.height && (open[sy * wordsPerRow + (sx >> 6)] >> (sx & 63) & 1)) {
+        const size_t total = open.size();
+        // Walls count as visited, so "& ~visited" also keeps the flood on open cells
+        std::pmr::vector<uint64_t> visited(total, memory);
+        for (size_t w = 0; w < total; ++w) visited[w] = ~open[w];
+        std::pmr::vector<uint64_t> next(total, 0, memory);
+        std::pmr::vector<size_t> touched(memory);
+        
+        // Frontier as (word, bits); only these words and their neighbours are read per level
+        std::pmr::vector<std::pair<size_t, uint64_t>> frontier(memory), upcoming(memory);
+        size_t sourceWord = sy * wordsPerRow + (sx >> 6);
+        uint64_t sourceBit = uint64_t(1) << (sx & 63);
+        visited[sourceWord] |= sourceBit;
+        frontier.push_back({sourceWord, sourceBit});
+        
+        const bool stopping = stopX >= 0 && stopY >= 0;
+        const size_t stopWord = stopping ? stopY * wordsPerRow + (stopX >> 6) : 0;
+        const uint64_t stopBit = stopping ? uint64_t(1) << (stopX & 63) : 0;
+        
+        auto add = [&](size_t w, uint64_t bits) {
+            bits &= ~visited[w];
+            if (!bits) return;
+            if (!next[w]) touched.push_back(w);
+            next[w] |= bits;
+        };
+        auto record = [&](size_t w, uint64_t bits, uint32_t level) {
+            size_t rowStart = (w / wordsPerRow) * static_cast<size_t>(width);
+            int xBase = static_cast<int>((w % wordsPerRow) * 64);
+            for (; bits; bits &= bits - 1) {
+                size_t index = rowStart + xBase + __builtin_ctzll(bits);
+                field.distance[index] = level;
+                if (order) order->push_back(static_cast<uint32_t>(index));
+            }
+        };
+        
+        record(sourceWord, sourceBit, 0);
+        field.reached = 1;
+        bool done = stopping && sourceWord == stopWord && (sourceBit & stopBit);
+        uint32_t level = 0;
+        while (!frontier.empty() && !done) {
+            for (const auto& [w, f] : frontier) {
+                size_t column = w % wordsPerRow;
+                add(w, (f << 1) | (f >> 1));
+                if (column + 1 < wordsPerRow && (f & TOP_BIT)) add(w + 1, 1);
+                if (column > 0 && (f & 1)) add(w - 1, TOP_BIT);
+                if (w >= wordsPerRow) add(w - wordsPerRow, f);
+                if (w + wordsPerRow < total) add(w + wordsPerRow, f);
+            }
+            
+            level++;
+            upcoming.clear();
+            for (size_t w : touched) {
+                uint64_t bits = next[w];
+                next[w] = 0;
+                visited[w] |= bits;
+                field.reached += __builtin_popcountll(bits);
+                record(w, bits, level);
+                upcoming.push_back({w, bits});
+                if (stopping && w == stopWord && (bits & stopBit)) done = true;
+            }
+            touched.clear();
+            frontier.swap(upcoming);
+            if (!frontier.empty()) field.eccentricity = level;
+            if (deadline && (level & 255) == 0 && deadline->isTimeout()) break;
+        }
+        
+        for (size_t w = 0; w < total; ++w) visited[w] &= open[w];
+        field.edges = countEdges(visited, wordsPerRow);
+    }
+    
+    auto micro = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::high_resolution_clock::now() - began).count();
+    field.timeTakenUs = micro > 0 ? micro : 1;
+    return field;
+}
+
+std::vector<uint64_t> BitBFS::reachable(const Maze& maze, int sx, int sy) {
+    PROFILE_ZONE("bfs", "reachable");
+    const int width = maze.getWidth();
+    const int height = maze.getHeight();
+    const size_t wordsPerRow = WallGrid::wordsForWidth(width);
+    std::vector<uint64_t> open = openMask(maze, wordsPerRow, std::vector<uint64_t>());
+    std::vector<uint64_t> reach(open.size(), 0);
+    if (sx < 0 || sx >= width || sy < 0 || sy >= height) return reach;
+    if (!(open[sy * wordsPerRow + (sx >> 6)] >> (sx & 63) & 1)) return reach;
+    
+    // Like distances(), but without levels to keep: a seed fills its whole run inside the
+    // word at once, so a step only has to cross word edges and rows
+    const size_t total = open.size();
+    FillKernel fill = pickKernel();
+    std::vector<uint64_t> seeds(total, 0);
+    std::vector<size_t> frontier, touched;
+    std::vector<uint64_t> batchSeeds, batchOpen, batchFilled;
+    
+    size_t sourceWord = sy * wordsPerRow + (sx >> 6);
+    seeds[sourceWord] = uint64_t(1) << (sx & 63);
+    frontier.push_back(sourceWord);
+    
+    while (!frontier.empty()) {
+        batchSeeds.clear();
+        batchOpen.clear();
+        for (size_t w : frontier) {
+            batchSeeds.push_back(seeds[w]);
+            batchOpen.push_back(open[w]);
+            seeds[w] = 0;
+        }
+        batchFilled.resize(frontier.size());
+        fill(batchSeeds.data(), batchOpen.data(), batchFilled.data(), frontier.size());
+        
+        for (size_t i = 0; i < frontier.size(); ++i) {
+            size_t w = frontier[i];
+            uint64_t fresh = batchFilled[i] & ~reach[w];
+            reach[w] |= fresh;
+            if (!fresh) continue;
+            
+            auto add = [&](size_t target, uint64_t bits) {
+                bits &= open[target] & ~reach[target];
+                if (!bits) return;
+                if (!seeds[target]) touched.push_back(target);
+                seeds[target] |= bits;
+            };
+            size_t column = w % wordsPerRow;
+            if (column + 1 < wordsPerRow && (fresh & TOP_BIT)) add(w + 1, 1);
+            if (column > 0 && (fresh & 1)) add(w - 1, TOP_BIT);
+            if (w >= wordsPerRow) add(w - wordsPerRow, fresh);
+            if (w + wordsPerRow < total) add(w + wordsPerRow, fresh);
+        }
+        frontier.swap(touched);
+        touched.clear();
+    }
+    return reach;
+
+}
\ No newline at end of file
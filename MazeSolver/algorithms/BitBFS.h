@@ -0,0 +1,37 @@
+#pragma once
+#include "../core/Maze.h"
+#include "../core/DistanceField.h"
+#include "../core/Utility.h"
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+// Bit-parallel BFS over the packed wall layout (1 bit per cell, rows padded to whole
+// 64-bit words), for unit-cost 4-connected grids. One BFS level is word arithmetic:
+//   next = (f << 1 | f >> 1 | f above | f below) & open & ~visited
+// so up to 64 cells advance per operation instead of one cell per queue pop.
+//
+// distances() is scalar word arithmetic, not SIMD: a level's frontier is a handful of
+// scattered words, and every reached cell still needs its own distance store, which is
+// where most of the time goes. Measured against the heap-based 4-way Dijkstra engine on
+// generated 1001x1001 and 2001x2001 mazes it is 2-4x faster, not 64x.
+class BitBFS {
+public:
+    // Levelled flood from (sx, sy): exact step distances. Only words touched by the
+    // frontier are processed, so long corridors cost per level what they would in a queue.
+    // Stops after the level that reaches (stopX, stopY) when given; 'order' collects
+    // row-major cell indices in the order they were reached. The field and all scratch
+    // bitmaps come from 'memory'. Gives up, leaving the rest unreached, once 'deadline'
+    // has passed (checked every 256 levels).
+    static DistanceField distances(const Maze& maze, int sx, int sy,
+                                   int stopX = -1, int stopY = -1, std::pmr::vector<uint32_t>* order = nullptr,
+                                   std::pmr::memory_resource* memory = std::pmr::get_default_resource(),
+                                   const RobustTimer* deadline = nullptr);
+
+    // Cells reachable from (sx, sy) in WallGrid layout. No levels needed, so each sweep
+    // fills whole row runs at once (AVX2 when the CPU has it) until nothing changes.
+    static std::vector<uint64_t> reachable(const Maze& maze, int sx, int sy);
+
+    // Whether reachable() runs its AVX2 kernel on this CPU
+    static bool usesAvx2();
+};
\ No newline at end of file
@@ -1,78 +1,94 @@
 #include "Dijkstra.h"
+#include "BitBFS.h"
 #include "../core/Utility.h"
-#include <queue>
-#include <vector>
-#include <functional>
-#include <algorithm>
-#include <limits>
+#include "../core/Profiler.h"
 
-struct DijkstraCompare {
-    bool operator()(Cell* a, Cell* b) const {
-        return a->g_cost > b->g_cost;
-    }
-};
-
-AlgorithmResult Dijkstra::solve(Maze& maze, std::function<void(Cell*, Cell*)> stepCallback){
-    AlgorithmResult result;
-    RobustTimer timer;
-    
-    maze.reset();
-    Cell* start = maze.getStart();
-    Cell* goal = maze.getGoal();
-    
-    if (!start || !goal) return result;
-    
-    std::priority_queue<Cell*, std::vector<Cell*>, DijkstraCompare> openSet;
-    std::vector<bool> closedSet(maze.getWidth() * maze.getHeight(), false);
-    
-    start->g_cost = 0.0;
-    openSet.push(start);
-    
-    // [FIX] If animating (stepCallback exists), increase timeout to 5 minutes (300000ms)
-    // Otherwise keep 2 seconds for terminal benchmarks.
-    long long timeout = stepCallback ? 300000 : 2000;
-    timer.start(timeout); 
-    
-    while (!openSet.empty() && !timer.isTimeout()) {
-        Cell* current = openSet.top();
-        openSet.pop();
-        
-        int currentIndex = current->y * maze.getWidth() + current->x;
-        if (closedSet[currentIndex]) continue;
-        
-        closedSet[currentIndex] = true;
-        result.visitedOrder.push_back(current);
-        
-        if (stepCallback) stepCallback(current, nullptr);
+namespace {
+    // 4-connected without animation every step costs 1, so Dijkstra's order is plain BFS
+    // order. Flood level by level with the bit-parallel BFS until the goal's level, then
+    // walk back down the distances from the goal.
+    AlgorithmResult solveUnitCost(Maze& maze, ResultDetail detail, SolveArena* shared) {
+        PROFILE_ZONE("search", "solve");
+        RobustTimer timer;
+        timer.start(2000);      // SearchStepper::drive's budget for unanimated solves
+        AlgorithmResult result;
+        SolveArena local(0);   // Only grows if no arena was passed in
+        SolveArena& arena = shared ? *shared : local;
+        size_t allocationsBefore = shared ? arena.heapAllocations() : 0;
+        arena.reset();
+        Cell* start = maze.getStart();
+        Cell* goal = maze.getGoal();
+        if (!start || !goal || !maze.isWalkable(start->x, start->y) || !maze.isWalkable(goal->x, goal->y)) {
+            result.failure = FailureReason::MissingEndpoints;
+            result.metrics.timeTakenMs = timer.stop();
+            return result;
+        }
+        if (!maze.connected(start->x, start->y, goal->x, goal->y)) {
+            result.failure = FailureReason::Unreachable;
+            result.metrics.timeTakenMs = timer.stop();
+            return result;
+        }
         
-        if (current == goal) {
-            result.success = true;
-            break;
+        // The visit order is only collected when someone will read it. Cell costs are
+        // never touched, so unlike the engine this needs no maze.reset().
+        const bool trace = detail == ResultDetail::Full;
+        std::pmr::vector<uint32_t> order(&arena);
+        DistanceField field = BitBFS::distances(maze, start->x, start->y, goal->x, goal->y,
+                                                trace ? &order : nullptr, &arena, &timer);
+        result.metrics.nodesExplored = field.reached;
+        if (trace) {
+            result.visitedOrder.reserve(order.size());
+            for (uint32_t i : order) result.visitedOrder.push_back(maze.cellAt(i));
         }
         
-        for (Cell* neighbor : maze.getNeighbors(current)) {
-            int neighborIndex = neighbor->y * maze.getWidth() + neighbor->x;
-            if (closedSet[neighborIndex]) continue;
-            
-            double new_g_cost = current->g_cost + 1.0;
-            
-            if (new_g_cost < neighbor->g_cost) {
-                neighbor->g_cost = new_g_cost;
-                neighbor->parent = current;
-                openSet.push(neighbor);
-
-                if (stepCallback) stepCallback(nullptr, neighbor);
+        if (field.at(goal->x, goal->y) != DistanceField::UNREACHED) {
+            PROFILE_ZONE("path", "reconstruct path");
+            // Downhill from the goal: the step into a cell at distance d is move d - 1
+            uint32_t length = field.at(goal->x, goal->y);
+            result.route = CompactPath(static_cast<uint32_t>(start->y * maze.getWidth() + start->x), maze.getWidth(),
+                                       MovementMode::FourWay);
+            result.route.resize(length);
+            int x = goal->x, y = goal->y;
+            for (uint32_t d = length; d > 0; --d) {
+                for (int i = 0; i < 4; ++i) {
+                    int dx = CompactPath::DX[i], dy = CompactPath::DY[i];
+                    if (maze.canStep(x, y, dx, dy) && field.at(x + dx, y + dy) == d - 1) {
+                        result.route.set(d - 1, -dx, -dy);
+                        x += dx;
+                        y += dy;
+                        break;
+                    }
+                }
+            }
+            result.success = true;
+            result.metrics.pathLength = result.route.size();
+            result.metrics.pathCost = result.route.cost();
+            if (trace) {
+                result.path = result.route.cells(maze);
+                result.route = CompactPath();
             }
+        } else {
+            // connected() said the goal is reachable, so the flood ran out of time
+            result.failure = timer.isTimeout() ? FailureReason::TimedOut : FailureReason::Exhausted;
         }
+        result.metrics.heapAllocations = arena.heapAllocations() - allocationsBefore;
+        result.metrics.bytesAllocated = arena.bytesInUse();
+        result.metrics.timeTakenMs = timer.stop();
+        return result;
     }
+}
+
+AlgorithmResult Dijkstra::solve(Maze& maze, std::function<void(Cell*, Cell*)> stepCallback, ResultDetail detail,
+                                SolveArena* arena){
+    // Only unit costs and nobody watching: the bit-parallel flood
+    if (maze.getMovementMode() == MovementMode::FourWay && !stepCallback) return solveUnitCost(maze, detail, arena);
     
-    result.metrics.timeTakenMs = timer.stop();
-    if (timer.isTimeout()) result.success = false;
-    
-    if (result.success) {
-        result.path = Utility::reconstructPath(maze.getGoal());
-        result.metrics.pathLength = result.path.size();
-    }
-    result.metrics.nodesExplored = result.visitedOrder.size();
-    return result;
+    // Pick heuristic and open list once; the inner loop has no runtime choices left
+    if (maze.getMovementMode() == MovementMode::FourWay) return Search::solve<FourWayEngine>(maze, stepCallback, detail, arena);
+    return Search::solve<EightWayEngine>(maze, stepCallback, detail, arena);
+}
+
+std::unique_ptr<SearchStepper> Dijkstra::makeStepper(Maze& maze, SolveArena* arena) {
+    if (maze.getMovementMode() == MovementMode::FourWay) return std::make_unique<FourWayEngine>(maze, arena);
+    return std::make_unique<EightWayEngine>(maze, arena);
 }
\ No newline at end of file
@@ -2,9 +2,22 @@
 #include "../core/Maze.h"
 #include "../core/AlgorithmResult.h"
 #include "../core/Types.h"
+#include "SearchEngine.h"
 #include <functional>
+#include <memory>
 
 class Dijkstra {
 public:
-    static AlgorithmResult solve(Maze& maze, std::function<void(Cell*, Cell*)> stepCallback = nullptr);
+    static AlgorithmResult solve(Maze& maze, std::function<void(Cell*, Cell*)> stepCallback = nullptr,
+                                 ResultDetail detail = ResultDetail::Full, SolveArena* arena = nullptr);
+
+    // The engines solve() runs by movement mode. Exception: 4-way with no step callback
+    // floods with BitBFS instead, which finds an equally short path but reports the cells
+    // it reached (in BFS order), so its node count can differ from the engine's.
+    typedef Search::Engine<Search::ZeroHeuristic, Search::BucketQueue> FourWayEngine;
+    typedef Search::Engine<Search::ZeroHeuristic, Search::BinaryHeap<Search::NoTieBreak>> EightWayEngine;
+
+    // Resumable Dijkstra: the engine solve() runs when given a step callback, a few
+    // expansions at a time
+    static std::unique_ptr<SearchStepper> makeStepper(Maze& maze, SolveArena* arena = nullptr);
 };
\ No newline at end of file
@@ -1,144 +1,437 @@
 #include "DoubleAStar.h"
 #include "../core/Utility.h"
-#include <queue>
+#include "../core/Profiler.h"
 #include <vector>
 #include <functional>
 #include <algorithm>
+#include <atomic>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <thread>
 
-struct DoubleAStarCompare {
-    bool operator()(Cell* a, Cell* b) const {
-        return a->f_cost() > b->f_cost();
-    }
-};
+AlgorithmResult DoubleAStar::solve(Maze& maze, std::function<void(Cell*, Cell*)> stepCallback, ResultDetail detail,
+                                   SolveArena* arena){
+    Stepper search(maze, arena);
+    search.setDetail(detail);
+    return SearchStepper::run(search, stepCallback);
+}
 
-AlgorithmResult DoubleAStar::solve(Maze& maze, std::function<void(Cell*, Cell*)> stepCallback){
-    AlgorithmResult result;
-    RobustTimer timer;
-    
+DoubleAStar::Stepper::Stepper(Maze& maze, SolveArena* arena)
+    : SearchStepper(arena), maze(maze), heuristic(maze), forward(scratch()), backward(scratch()) {
+    PROFILE_ZONE("search", "setup");
+    start = maze.getStart();
+    goal = maze.getGoal();
+    if (rejectEarly(maze, start, goal)) return;
     maze.reset();
-    Cell* start = maze.getStart();
-    Cell* goal = maze.getGoal();
     
-    if (!start || !goal) return result;
-    
-    std::priority_queue<Cell*, std::vector<Cell*>, DoubleAStarCompare> openForward;
-    std::priority_queue<Cell*, std::vector<Cell*>, DoubleAStarCompare> openBackward;
-    
-    std::vector<bool> closedForward(maze.getWidth() * maze.getHeight(), false);
-    std::vector<bool> closedBackward(maze.getWidth() * maze.getHeight(), false);
-    
-    std::vector<Cell*> cameFromForward(maze.getWidth() * maze.getHeight(), nullptr);
-    std::vector<Cell*> cameFromBackward(maze.getWidth() * maze.getHeight(), nullptr);
+    const size_t cellCount = maze.slotCount();
+    for (Direction* d : {&forward, &backward}) {
+        d->g.assign(cellCount, std::numeric_limits<double>::infinity());
+        d->parent.assign(cellCount, -1);
+        d->closed.assign(cellCount, false);
+    }
+    forward.target = goal;
+    backward.target = start;
     
-    start->g_cost = 0.0;
-    start->h_cost = Utility::manhattanDistance(start, goal);
-    openForward.push(start);
-    cameFromForward[start->y * maze.getWidth() + start->x] = start;
+    forward.g[index(start)] = 0.0;
+    forward.open.push({potential(start, forward), 0.0, start});
+    recordPush(forward.open.size());
+    backward.g[index(goal)] = 0.0;
+    backward.open.push({potential(goal, backward), 0.0, goal});
+    recordPush(backward.open.size());
+    res.metrics.heuristicEvaluations += 4;   // Two per potential
     
-    goal->g_cost = 0.0;
-    goal->h_cost = Utility::manhattanDistance(goal, start);
-    openBackward.push(goal);
-    cameFromBackward[goal->y * maze.getWidth() + goal->x] = goal;
+    if (start == goal) {
+        mu = 0.0;
+        meeting = static_cast<int>(index(start));
+    }
+}
+
+SearchStepper::Status DoubleAStar::Stepper::step(size_t n, std::vector<SearchEvent>* events) {
+    PROFILE_ZONE("search", "expand batch");
+    const double inf = std::numeric_limits<double>::infinity();
+    size_t expanded = 0;
+    while (state == Status::Running && expanded < n) {
+        pruneStale(forward);
+        pruneStale(backward);
+        
+        // One side ran dry without ever meeting the other. Checked first: with no meeting
+        // mu is infinite, and two empty sides would pass the stopping rule as inf >= inf.
+        if (meeting == -1 && (forward.open.empty() || backward.open.empty())) {
+            finish(Status::NoPath, {}, events);
+            break;
+        }
+        
+        // Stopping rule: any start-goal path not yet seen costs at least the sum of the
+        // two frontier keys, so once that reaches mu, mu is optimal
+        double minForward = forward.open.empty() ? inf : forward.open.top().f;
+        double minBackward = backward.open.empty() ? inf : backward.open.top().f;
+        if (meeting != -1 && minForward + minBackward >= mu) {
+            if (detail == ResultDetail::Compact) finish(Status::Found, joinRoute());
+            else finish(Status::Found, joinPaths(), events);
+            break;
+        }
+        
+        if (forward.open.size() <= backward.open.size()) expand(forward, backward, events);
+        else expand(backward, forward, events);
+        ++expanded;
+    }
+    return state;
+}
+
+double DoubleAStar::Stepper::potential(const Cell* c, const Direction& d) const {
+    double p = 0.5 * (heuristic(c, goal) - heuristic(c, start));
+    return &d == &forward ? p : -p;
+}
+
+void DoubleAStar::Stepper::pruneStale(Direction& d) {
+    while (!d.open.empty()) {
+        const Search::Entry& top = d.open.top();
+        size_t i = index(top.cell);
+        if (!d.closed[i] && top.g <= d.g[i]) return;
+        d.open.pop();
+        res.metrics.heapPops++;
+        res.metrics.stalePops++;
+    }
+}
+
+void DoubleAStar::Stepper::expand(Direction& d, Direction& other, std::vector<SearchEvent>* events) {
+    Cell* current = d.open.pop().cell;
+    res.metrics.heapPops++;
+    size_t ci = index(current);
+    d.closed[ci] = true;
+    recordExpansion(current);
+    emit(events, current, SearchTrace::Visit);
     
-    Cell* meetingPoint = nullptr;
+    // Settled from the other side too: gF + gB is already in mu and its onward
+    // neighbours were reached through it by the other search
+    if (other.closed[ci]) return;
     
-    // [FIX] Increase timeout for GUI
-    long long timeout = stepCallback ? 300000 : 2000;
-    timer.start(timeout); 
+    Search::GridNeighbors().forEach(maze, current, d.target, [&](Cell* next, double cost) {
+        size_t ni = index(next);
+        double g = d.g[ci] + cost;
+        if (d.closed[ni]) {
+            if (g < d.g[ni] - 1e-9) res.metrics.reopenings++;
+            return;
+        }
+        
+        if (g >= d.g[ni]) return;
+        d.g[ni] = g;
+        d.parent[ni] = static_cast<int>(ci);
+        
+        // Reached from both sides: a candidate start-goal path
+        if (g + other.g[ni] < mu) {
+            mu = g + other.g[ni];
+            meeting = static_cast<int>(ni);
+        }
+        
+        // g + h is a lower bound on any path through 'next'; at or above mu it can't help
+        res.metrics.heuristicEvaluations++;
+        if (g + heuristic(next, d.target) < mu) {
+            d.open.push({g + potential(next, d), g, next});
+            res.metrics.heuristicEvaluations += 2;
+            recordPush(d.open.size());
+            emit(events, next, SearchTrace::Frontier);
+        }
+    });
+}
+
+std::vector<Cell*> DoubleAStar::Stepper::joinPaths() const {
+    PROFILE_ZONE("path", "reconstruct path");
+    std::pmr::vector<Cell>& cells = maze.getCells();
+    std::vector<Cell*> path;
+    for (int i = meeting; i != -1; i = forward.parent[i]) path.push_back(&cells[i]);
+    std::reverse(path.begin(), path.end());
+    for (int i = backward.parent[meeting]; i != -1; i = backward.parent[i]) path.push_back(&cells[i]);
+    return path;
+}
+
+CompactPath DoubleAStar::Stepper::joinRoute() const {
+    PROFILE_ZONE("path", "reconstruct path");
+    // Moves meeting -> start along forward.parent fill the front half from its end,
+    // moves meeting -> goal along backward.parent the back half in order
+    size_t front = 0, back = 0;
+    int first = meeting;
+    for (; forward.parent[first] != -1; first = forward.parent[first]) front++;
+    for (int i = meeting; backward.parent[i] != -1; i = backward.parent[i]) back++;
     
-    while ((!openForward.empty() || !openBackward.empty()) && !timer.isTimeout()) {
-        if (!openForward.empty()) {
-            Cell* current = openForward.top();
-            openForward.pop();
-            
-            int idx = current->y * maze.getWidth() + current->x;
-            if (closedForward[idx]) continue;
-            
-            closedForward[idx] = true;
-            result.visitedOrder.push_back(current);
+    const std::pmr::vector<Cell>& cells = maze.getCells();
+    const Cell& origin = cells[first];
+    CompactPath route(static_cast<uint32_t>(origin.y * maze.getWidth() + origin.x), maze.getWidth(), maze.getMovementMode());
+    route.resize(front + back);
+    size_t k = front;
+    for (int i = meeting; forward.parent[i] != -1; i = forward.parent[i]) {
+        const Cell& p = cells[forward.parent[i]];
+        route.set(--k, cells[i].x - p.x, cells[i].y - p.y);
+    }
+    k = front;
+    for (int i = meeting; backward.parent[i] != -1; i = backward.parent[i]) {
+        const Cell& n = cells[backward.parent[i]];
+        route.set(k++, n.x - cells[i].x, n.y - cells[i].y);
+    }
+    return route;
+}
 
-            if (stepCallback) stepCallback(current, nullptr);
-            
-            if (closedBackward[idx]) {
-                meetingPoint = current;
-                result.success = true;
-                break;
+// ========== Two-thread search ==========
+
+namespace {
+    // One side of the parallel search. Only 'g' and 'minKey' are read by the other thread.
+    // Labels are sized once, before the threads start, so they come from the solve arena.
+    // The open list grows while both threads run and SolveArena is single-threaded, so it
+    // stays on the heap.
+    struct ParallelSide {
+        explicit ParallelSide(std::pmr::memory_resource* memory) : parent(memory), closed(memory) {}
+
+        std::atomic<double>* g = nullptr;               // Arena storage, never freed
+        std::pmr::vector<int> parent;
+        std::pmr::vector<bool> closed;
+        Search::BinaryHeap<Search::PreferHigherG> open;
+        std::vector<Cell*> visited;     // Only when tracing
+        size_t expanded = 0;
+        // Search counters, summed into the result's Metrics once both threads are done
+        size_t pushes = 0;
+        size_t pops = 0;
+        size_t stalePops = 0;
+        size_t peakOpen = 0;
+        size_t reopenings = 0;
+        size_t heuristicEvaluations = 0;
+        Cell* target = nullptr;
+        bool forward = true;
+        // Smallest key still open: everything keyed below it has been fully expanded
+        alignas(64) std::atomic<double> minKey{0.0};
+    };
+
+    class ParallelSearch {
+    public:
+        ParallelSearch(Maze& maze, bool trace, SolveArena& arena)
+            : maze(maze), heuristic(maze), start(maze.getStart()), goal(maze.getGoal()), trace(trace),
+              forward(&arena), backward(&arena) {
+            const size_t cellCount = maze.slotCount();
+            for (ParallelSide* s : {&forward, &backward}) {
+                void* labels = arena.allocate(cellCount * sizeof(std::atomic<double>), alignof(std::atomic<double>));
+                s->g = static_cast<std::atomic<double>*>(labels);
+                for (size_t i = 0; i < cellCount; ++i) new (&s->g[i]) std::atomic<double>(inf);
+                s->parent.assign(cellCount, -1);
+                s->closed.assign(cellCount, false);
             }
-            
-            for (Cell* neighbor : maze.getNeighbors(current)) {
-                int nidx = neighbor->y * maze.getWidth() + neighbor->x;
-                if (closedForward[nidx]) continue;
+            forward.target = goal;
+            backward.target = start;
+            backward.forward = false;
+            seed(forward, start);
+            seed(backward, goal);
+        }
+
+        // Runs both sides to completion; true unless a side timed out
+        bool run() {
+            std::thread worker([this] {
+                PROFILE_THREAD("bidirectional A* backward");
+                search(backward, forward);
+            });
+            search(forward, backward);
+            worker.join();
+            return !timedOut.load();
+        }
+
+        bool found() const { return meetForward != -1; }
+
+        std::vector<Cell*> path() const {
+            std::pmr::vector<Cell>& cells = maze.getCells();
+            std::vector<Cell*> result;
+            for (int i = meetForward; i != -1; i = forward.parent[i]) result.push_back(&cells[i]);
+            std::reverse(result.begin(), result.end());
+            for (int i = meetBackward; i != -1; i = backward.parent[i]) result.push_back(&cells[i]);
+            return result;
+        }
+
+        size_t expanded() const { return forward.expanded + backward.expanded; }
+
+        void addCounters(Metrics& m) const {
+            for (const ParallelSide* s : {&forward, &backward}) {
+                m.heapPushes += s->pushes;
+                m.heapPops += s->pops;
+                m.stalePops += s->stalePops;
+                m.peakOpenSize += s->peakOpen;     // Both sides' peaks: they are live together
+                m.reopenings += s->reopenings;
+                m.heuristicEvaluations += s->heuristicEvaluations;
+                // The arena holds the labels; the heap-side open list counts at its peak
+                m.bytesAllocated += s->peakOpen * sizeof(Search::Entry);
+            }
+        }
+
+        std::vector<Cell*> visitedOrder() const {
+            std::vector<Cell*> all(forward.visited);
+            all.insert(all.end(), backward.visited.begin(), backward.visited.end());
+            return all;
+        }
+
+    private:
+        static constexpr double inf = std::numeric_limits<double>::infinity();
+
+        Maze& maze;
+        Search::LandmarkHeuristic heuristic;
+        Cell* start;
+        Cell* goal;
+        bool trace;
+        ParallelSide forward;
+        ParallelSide backward;
+
+        std::atomic<double> mu{inf};
+        std::atomic<bool> stop{false};
+        std::atomic<bool> timedOut{false};
+        std::mutex meetLock;            // Keeps mu and its meeting edge consistent
+        int meetForward = -1;           // Best path: start .. meetForward -> meetBackward .. goal
+        int meetBackward = -1;
+
+        size_t index(const Cell* c) const { return maze.slotOf(c); }
+
+        double potential(const Cell* c, const ParallelSide& s) const {
+            double p = 0.5 * (heuristic(c, goal) - heuristic(c, start));
+            return s.forward ? p : -p;
+        }
+
+        void seed(ParallelSide& s, Cell* root) {
+            s.g[index(root)].store(0.0, std::memory_order_relaxed);
+            s.open.push({potential(root, s), 0.0, root});
+            s.minKey.store(potential(root, s), std::memory_order_relaxed);
+            s.pushes++;
+            s.peakOpen = 1;
+            s.heuristicEvaluations += 4;
+        }
+
+        void offerMeeting(int forwardCell, int backwardCell, double cost) {
+            std::lock_guard<std::mutex> lock(meetLock);
+            if (cost >= mu.load(std::memory_order_relaxed)) return;
+            meetForward = forwardCell;
+            meetBackward = backwardCell;
+            mu.store(cost, std::memory_order_release);
+        }
+
+        void search(ParallelSide& self, ParallelSide& other) {
+            PROFILE_ZONE("search", "search side");
+            TimeoutTimer timer(2000);
+            size_t expanded = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                while (!self.open.empty()) {
+                    const Search::Entry& top = self.open.top();
+                    size_t i = index(top.cell);
+                    if (!self.closed[i] && top.g <= self.g[i].load(std::memory_order_relaxed)) break;
+                    self.open.pop();
+                    self.pops++;
+                    self.stalePops++;
+                }
                 
-                double new_g_cost = current->g_cost + 1.0;
-                if (cameFromForward[nidx] == nullptr || new_g_cost < neighbor->g_cost) {
-                    neighbor->g_cost = new_g_cost;
-                    neighbor->h_cost = Utility::manhattanDistance(neighbor, goal);
-                    neighbor->parent = current;
-                    cameFromForward[nidx] = current;
-                    openForward.push(neighbor);
-                    if (stepCallback) stepCallback(nullptr, neighbor);
+                // Same rule as the single-threaded search, on the other side's published
+                // key. That key only grows, so a stale read just stops a little later.
+                double key = self.open.empty() ? inf : self.open.top().f;
+                self.minKey.store(key, std::memory_order_release);
+                if (key + other.minKey.load(std::memory_order_acquire) >= mu.load(std::memory_order_acquire)) break;
+                // Ran dry without meeting the other side: no path
+                if (self.open.empty()) break;
+                
+                if (++expanded % 256 == 0 && timer.isTimeout()) {
+                    timedOut.store(true);
+                    break;
                 }
+                expand(self, other);
             }
+            stop.store(true, std::memory_order_relaxed);
         }
-        
-        if (!openBackward.empty() && !result.success) {
-            Cell* current = openBackward.top();
-            openBackward.pop();
-            
-            int idx = current->y * maze.getWidth() + current->x;
-            if (closedBackward[idx]) continue;
-            
-            closedBackward[idx] = true;
-            result.visitedOrder.push_back(current);
 
-            if (stepCallback) stepCallback(current, nullptr);
+        void expand(ParallelSide& self, ParallelSide& other) {
+            Cell* current = self.open.pop().cell;
+            self.pops++;
+            size_t ci = index(current);
+            self.closed[ci] = true;
+            self.expanded++;
+            if (trace) self.visited.push_back(current);
             
-            if (closedForward[idx]) {
-                meetingPoint = current;
-                result.success = true;
-                break;
-            }
+            // Pairs with the other side's fence: of two adjacent cells settled from opposite
+            // ends, at least one side sees the other's final label when it scans the edge
+            std::atomic_thread_fence(std::memory_order_seq_cst);
             
-            for (Cell* neighbor : maze.getNeighbors(current)) {
-                int nidx = neighbor->y * maze.getWidth() + neighbor->x;
-                if (closedBackward[nidx]) continue;
+            double gc = self.g[ci].load(std::memory_order_relaxed);
+            Search::GridNeighbors().forEach(maze, current, self.target, [&](Cell* next, double cost) {
+                size_t ni = index(next);
+                double g = gc + cost;
                 
-                double new_g_cost = current->g_cost + 1.0;
-                if (cameFromBackward[nidx] == nullptr || new_g_cost < neighbor->g_cost) {
-                    neighbor->g_cost = new_g_cost;
-                    neighbor->h_cost = Utility::manhattanDistance(neighbor, start);
-                    neighbor->parent = current;
-                    cameFromBackward[nidx] = current;
-                    openBackward.push(neighbor);
-                    if (stepCallback) stepCallback(nullptr, neighbor);
+                double meet = g + other.g[ni].load(std::memory_order_relaxed);
+                if (meet < mu.load(std::memory_order_relaxed)) {
+                    if (self.forward) offerMeeting(static_cast<int>(ci), static_cast<int>(ni), meet);
+                    else offerMeeting(static_cast<int>(ni), static_cast<int>(ci), meet);
                 }
-            }
+                
+                if (self.closed[ni]) {
+                    if (g < self.g[ni].load(std::memory_order_relaxed) - 1e-9) self.reopenings++;
+                    return;
+                }
+                if (g >= self.g[ni].load(std::memory_order_relaxed)) return;
+                self.g[ni].store(g, std::memory_order_relaxed);
+                self.parent[ni] = static_cast<int>(ci);
+                self.heuristicEvaluations++;
+                if (g + heuristic(next, self.target) < mu.load(std::memory_order_relaxed)) {
+                    self.open.push({g + potential(next, self), g, next});
+                    self.heuristicEvaluations += 2;
+                    self.pushes++;
+                    self.peakOpen = std::max(self.peakOpen, self.open.size());
+                }
+            });
         }
+    };
+}
+
+AlgorithmResult DoubleAStar::solveParallel(Maze& maze, ResultDetail detail, SolveArena* shared) {
+    PROFILE_ZONE("search", "solve parallel");
+    RobustTimer timer;
+    timer.start();
+    AlgorithmResult result;
+    SolveArena local(0);   // Only grows if no arena was passed in
+    SolveArena& arena = shared ? *shared : local;
+    size_t allocationsBefore = shared ? arena.heapAllocations() : 0;
+    arena.reset();
+    Cell* start = maze.getStart();
+    Cell* goal = maze.getGoal();
+    if (!start || !goal || !maze.isWalkable(start->x, start->y) || !maze.isWalkable(goal->x, goal->y)) {
+        result.failure = FailureReason::MissingEndpoints;
+        result.metrics.timeTakenMs = timer.stop();
+        return result;
     }
+    if (!maze.connected(start->x, start->y, goal->x, goal->y)) {
+        result.failure = FailureReason::Unreachable;
+        result.metrics.timeTakenMs = timer.stop();
+        return result;
+    }
+    maze.reset();
     
-    result.metrics.timeTakenMs = timer.stop();
-    if (timer.isTimeout()) result.success = false;
-    
-    if (result.success && meetingPoint) {
-        std::vector<Cell*> path;
-        Cell* current = meetingPoint;
-        while (current != start) {
-            path.push_back(current);
-            current = cameFromForward[current->y * maze.getWidth() + current->x];
-        }
-        path.push_back(start);
-        std::reverse(path.begin(), path.end());
-        
-        current = cameFromBackward[meetingPoint->y * maze.getWidth() + meetingPoint->x];
-        while (current != goal) {
-            path.push_back(current);
-            current = cameFromBackward[current->y * maze.getWidth() + current->x];
+    const bool trace = detail == ResultDetail::Full;
+    if (start == goal) {
+        result.success = true;
+        result.path = {start};
+        result.metrics.nodesExplored = 1;
+        if (trace) result.visitedOrder = {start};
+    } else {
+        ParallelSearch search(maze, trace, arena);
+        bool completed = search.run();
+        result.metrics.nodesExplored = search.expanded();
+        search.addCounters(result.metrics);
+        if (trace) result.visitedOrder = search.visitedOrder();
+        if (completed && search.found()) {
+            result.success = true;
+            result.path = search.path();
+        } else {
+            result.failure = completed ? FailureReason::Exhausted : FailureReason::TimedOut;
         }
-        if (!path.empty() && path.back() != goal) path.push_back(goal);
-        
-        result.path = path;
+    }
+    result.metrics.heapAllocations = arena.heapAllocations() - allocationsBefore;
+    result.metrics.bytesAllocated += arena.bytesInUse();
+    result.metrics.timeTakenMs = timer.stop();
+    if (result.success) {
         result.metrics.pathLength = result.path.size();
+        result.metrics.pathCost = Utility::pathCost(result.path);
+        if (!trace) {
+            result.route = CompactPath::fromCells(result.path, maze);
+            result.path.clear();
+        }
     }
-    result.metrics.nodesExplored = result.visitedOrder.size();
     return result;
 }
\ No newline at end of file
@@ -2,12 +2,67 @@
 #include "../core/Maze.h"
 #include "../core/AlgorithmResult.h"
 #include "../core/Types.h"
+#include "../core/SearchStepper.h"
+#include "SearchEngine.h"
 #include <functional>
+#include <limits>
+#include <vector>
 
+// Bidirectional A*. Each direction keeps its own g/parent/closed arrays (the Cells'
+// cost fields are not touched) and the best meeting cost mu is tracked on every relaxation.
+// Both sides are keyed by the balanced potential p = (h(v, goal) - h(v, start)) / 2
+// (negated backwards), which makes them one consistent problem: the search may stop as
+// soon as the two frontier minima add up to mu. The side with the smaller open list
+// expands next.
 class DoubleAStar {
 public:
-    static AlgorithmResult solve(
-    Maze& maze,
-    std::function<void(Cell*, Cell*)> stepCallback = nullptr
-);
+    static AlgorithmResult solve(Maze& maze, std::function<void(Cell*, Cell*)> stepCallback = nullptr,
+                                 ResultDetail detail = ResultDetail::Full, SolveArena* arena = nullptr);
+
+    // Same search with the forward and backward sides on two threads. Each side publishes
+    // its g labels and smallest open key atomically; the first side to see the two keys
+    // reach mu stops both. Optimal like solve(), but no step callback (events would
+    // arrive from two threads at once). Per-cell labels come from 'arena'; the two open
+    // lists grow concurrently and stay on the heap.
+    static AlgorithmResult solveParallel(Maze& maze, ResultDetail detail = ResultDetail::Full,
+                                         SolveArena* arena = nullptr);
+
+    // Resumable form: one step() unit is one expansion on either side
+    class Stepper : public SearchStepper {
+    public:
+        explicit Stepper(Maze& maze, SolveArena* arena = nullptr);
+        Status step(size_t n, std::vector<SearchEvent>* events = nullptr) override;
+
+    private:
+        typedef Search::BinaryHeap<Search::PreferHigherG> OpenList;
+
+        struct Direction {
+            OpenList open;
+            std::pmr::vector<double> g;
+            std::pmr::vector<int> parent;   // Cell index, -1 = none
+            std::pmr::vector<bool> closed;
+            Cell* target = nullptr;         // Goal for the forward side, start for the backward one
+
+            explicit Direction(std::pmr::memory_resource* memory) : open(memory), g(memory), parent(memory), closed(memory) {}
+        };
+
+        Maze& maze;
+        Search::LandmarkHeuristic heuristic;   // Plain Manhattan/octile unless the maze has landmarks
+        Cell* start = nullptr;
+        Cell* goal = nullptr;
+        Direction forward;
+        Direction backward;
+        double mu = std::numeric_limits<double>::infinity();
+        int meeting = -1;
+
+        // Storage slot: the per-direction arrays follow the maze's cell layout
+        size_t index(const Cell* c) const { return maze.slotOf(c); }
+        // Key offset of 'c' for the side 'd'
+        double potential(const Cell* c, const Direction& d) const;
+        // Drops entries for cells closed or reached more cheaply since they were pushed
+        void pruneStale(Direction& d);
+        void expand(Direction& d, Direction& other, std::vector<SearchEvent>* events);
+        std::vector<Cell*> joinPaths() const;
+        CompactPath joinRoute() const;
+    };
 };
\ No newline at end of file
@@ -1,170 +1,226 @@
 #include "JumpPointSearch.h"
 #include "../core/Utility.h"
-#include <queue>
+#include "../core/Profiler.h"
+#include <algorithm>
 #include <vector>
 #include <functional>
 #include <cmath>
 
-// Helper to check if a node is walkable
-bool isWalkable(Maze& maze, int x, int y) {
-    if (x < 0 || x >= maze.getWidth() || y < 0 || y >= maze.getHeight()) return false;
-    Cell* c = maze.getCellPtr(x, y);
-    return c && !c->wall;
-}
+namespace {
+    // Helper to check if a node is walkable
+    bool isWalkable(Maze& maze, int x, int y) {
+        return maze.isWalkable(x, y);
+    }
 
-// The core JUMP function
-Cell* jump(Maze& maze, Cell* current, int dx, int dy, Cell* goal) {
-    int x = current->x;
-    int y = current->y;
-    
-    // 1. Step forward
-    x += dx;
-    y += dy;
-    
-    // 2. Check bounds/wall
-    if (!isWalkable(maze, x, y)) return nullptr;
-    
-    Cell* next = maze.getCellPtr(x, y);
-    
-    // 3. Goal found?
-    if (next == goal) return next;
-    
-    // 4. Junction/Forced Neighbor Check (Orthogonal only for this maze type)
-    // If moving Horizontally, check for open nodes above/below that imply a turn
-    if (dx != 0) {
-        if ((isWalkable(maze, x, y - 1) && !isWalkable(maze, x - dx, y - 1)) ||
-            (isWalkable(maze, x, y + 1) && !isWalkable(maze, x - dx, y + 1))) {
-            return next;
+    // The core JUMP function
+    Cell* jump(Maze& maze, Cell* current, int dx, int dy, Cell* goal) {
+        int x = current->x;
+        int y = current->y;
+
+        // 1. Step forward
+        x += dx;
+        y += dy;
+
+        // 2. Check bounds/wall
+        if (!isWalkable(maze, x, y)) return nullptr;
+
+        Cell* next = maze.getCellPtr(x, y);
+
+        // 3. Goal found?
+        if (next == goal) return next;
+
+        // 4. Junction/Forced Neighbor Check (Orthogonal only for this maze type)
+        // If moving Horizontally, check for open nodes above/below that imply a turn
+        if (dx != 0) {
+            if ((isWalkable(maze, x, y - 1) && !isWalkable(maze, x - dx, y - 1)) ||
+                (isWalkable(maze, x, y + 1) && !isWalkable(maze, x - dx, y + 1))) {
+                return next;
+            }
+            // Also simpler check: Is this a generic intersection? 
+            // (Up or Down is open)
+            if (isWalkable(maze, x, y - 1) || isWalkable(maze, x, y + 1)) return next;
         }
-        // Also simpler check: Is this a generic intersection? 
-        // (Up or Down is open)
-        if (isWalkable(maze, x, y - 1) || isWalkable(maze, x, y + 1)) return next;
+        // If moving Vertically
+        else if (dy != 0) {
+            if ((isWalkable(maze, x - 1, y) && !isWalkable(maze, x - 1, y - dy)) ||
+                (isWalkable(maze, x + 1, y) && !isWalkable(maze, x + 1, y - dy))) {
+                return next;
+            }
+            // Simpler check: Is this a generic intersection?
+            // (Left or Right is open)
+            if (isWalkable(maze, x - 1, y) || isWalkable(maze, x + 1, y)) return next;
+        }
+
+        // 5. Recursive Jump
+        return jump(maze, next, dx, dy, goal);
     }
-    // If moving Vertically
-    else if (dy != 0) {
-        if ((isWalkable(maze, x - 1, y) && !isWalkable(maze, x - 1, y - dy)) ||
-            (isWalkable(maze, x + 1, y) && !isWalkable(maze, x + 1, y - dy))) {
-            return next;
+
+    // 8-connected JUMP (no corner cutting). Walks from (x, y) in direction (dx, dy)
+    // and returns the first jump point, or nullptr if the ray dies in a wall.
+    Cell* jumpDiagonal(Maze& maze, int x, int y, int dx, int dy, Cell* goal) {
+        while (isWalkable(maze, x, y)) {
+            Cell* node = maze.getCellPtr(x, y);
+            if (node == goal) return node;
+
+            if (dx != 0 && dy != 0) {
+                // Diagonal: stop here if either straight component finds a jump point
+                if (jumpDiagonal(maze, x + dx, y, dx, 0, goal) ||
+                    jumpDiagonal(maze, x, y + dy, 0, dy, goal)) {
+                    return node;
+                }
+                // Can't squeeze past a wall corner
+                if (!isWalkable(maze, x + dx, y) || !isWalkable(maze, x, y + dy)) return nullptr;
+            }
+            else if (dx != 0) {
+                // Forced neighbor: a side opens up that was blocked one step back
+                if ((isWalkable(maze, x, y - 1) && !isWalkable(maze, x - dx, y - 1)) ||
+                    (isWalkable(maze, x, y + 1) && !isWalkable(maze, x - dx, y + 1))) {
+                    return node;
+                }
+            }
+            else {
+                if ((isWalkable(maze, x - 1, y) && !isWalkable(maze, x - 1, y - dy)) ||
+                    (isWalkable(maze, x + 1, y) && !isWalkable(maze, x + 1, y - dy))) {
+                    return node;
+                }
+            }
+
+            x += dx;
+            y += dy;
         }
-        // Simpler check: Is this a generic intersection?
-        // (Left or Right is open)
-        if (isWalkable(maze, x - 1, y) || isWalkable(maze, x + 1, y)) return next;
+        return nullptr;
+    }
+
+    // At most 8 directions: fixed storage, so expanding a node allocates nothing
+    struct Directions {
+        std::pair<int, int> items[8];
+        int count = 0;
+        void push_back(std::pair<int, int> d) { items[count++] = d; }
+        const std::pair<int, int>* begin() const { return items; }
+        const std::pair<int, int>* end() const { return items + count; }
+    };
+
+    // Directions worth jumping in from 'current', pruned by the direction we arrived from
+    Directions prunedDirections(Maze& maze, Cell* current) {
+        Directions dirs;
+        int x = current->x;
+        int y = current->y;
+
+        // Start node: everything is a candidate
+        if (!current->parent) {
+            for (int dy = -1; dy <= 1; ++dy)
+                for (int dx = -1; dx <= 1; ++dx)
+                    if (dx != 0 || dy != 0) dirs.push_back({dx, dy});
+            return dirs;
+        }
+
+        int dx = (x > current->parent->x) ? 1 : (x < current->parent->x) ? -1 : 0;
+        int dy = (y > current->parent->y) ? 1 : (y < current->parent->y) ? -1 : 0;
+
+        if (dx != 0 && dy != 0) {
+            dirs.push_back({dx, 0});
+            dirs.push_back({0, dy});
+            dirs.push_back({dx, dy});
+        }
+        else if (dx != 0) {
+            dirs.push_back({dx, 0});
+            // With no corner cutting, a side only matters once it is open
+            for (int side : {-1, 1}) {
+                if (isWalkable(maze, x, y + side)) {
+                    dirs.push_back({0, side});
+                    dirs.push_back({dx, side});
+                }
+            }
+        }
+        else {
+            dirs.push_back({0, dy});
+            for (int side : {-1, 1}) {
+                if (isWalkable(maze, x + side, y)) {
+                    dirs.push_back({side, 0});
+                    dirs.push_back({side, dy});
+                }
+            }
+        }
+        return dirs;
     }
-    
-    // 5. Recursive Jump
-    return jump(maze, next, dx, dy, goal);
 }
 
-struct JPSCompare {
-    bool operator()(Cell* a, Cell* b) const {
-        return a->f_cost() > b->f_cost();
+AlgorithmResult JumpPointSearch::solve(Maze& maze, std::function<void(Cell*, Cell*)> stepCallback, ResultDetail detail,
+                                       SolveArena* arena){
+    // Pick heuristic and open list once; the inner loop has no runtime choices left
+    if (maze.getMovementMode() == MovementMode::FourWay) {
+        return Search::solve<Search::Engine<Search::Manhattan, Search::BinaryHeap<Search::PreferHigherG>, JumpPoints>>(maze, stepCallback, detail, arena);
     }
-};
+    return Search::solve<Search::Engine<Search::Octile, Search::BinaryHeap<Search::PreferHigherG>, JumpPoints>>(maze, stepCallback, detail, arena);
+}
 
-AlgorithmResult JumpPointSearch::solve(Maze& maze, std::function<void(Cell*, Cell*)> stepCallback){
-    AlgorithmResult result;
-    RobustTimer timer;
-    
-    maze.reset();
-    Cell* start = maze.getStart();
-    Cell* goal = maze.getGoal();
-    
-    if (!start || !goal) return result;
-    
-    std::priority_queue<Cell*, std::vector<Cell*>, JPSCompare> openSet;
-    std::vector<bool> closedSet(maze.getWidth() * maze.getHeight(), false);
-    
-    start->g_cost = 0.0;
-    start->h_cost = Utility::manhattanDistance(start, goal);
-    openSet.push(start);
-    
-    // Timer setup (GUI vs Terminal)
-    long long timeout = stepCallback ? 300000 : 2000;
-    timer.start(timeout); 
-    
-    while (!openSet.empty() && !timer.isTimeout()) {
-        Cell* current = openSet.top();
-        openSet.pop();
-        
-        // Mark visited
-        int currentIndex = current->y * maze.getWidth() + current->x;
-        if (closedSet[currentIndex]) continue;
-        closedSet[currentIndex] = true;
-        result.visitedOrder.push_back(current);
-        
-        // Visualize "Jumping from here"
-        if (stepCallback) stepCallback(current, nullptr);
-        
-        if (current == goal) {
-            result.success = true;
-            break;
+void JumpPointSearch::JumpPoints::collect(Maze& maze, Cell* current, Cell* goal, std::pmr::vector<Cell*>& jumpNodes) {
+    // All 4 cardinal directions on 4-connected grids,
+    // pruned straight + diagonal directions on 8-connected grids
+    if (maze.getMovementMode() == MovementMode::EightWay) {
+        for (auto [dx, dy] : prunedDirections(maze, current)) {
+            if (!maze.canStep(current->x, current->y, dx, dy)) continue;
+            if (Cell* node = jumpDiagonal(maze, current->x + dx, current->y + dy, dx, dy, goal)) {
+                jumpNodes.push_back(node);
+            }
         }
-        
-        // Try jumping in all 4 cardinal directions
+    } else {
         const int dx[] = {1, -1, 0, 0};
         const int dy[] = {0, 0, 1, -1};
-        
         for (int i = 0; i < 4; ++i) {
-            // Attempt to jump
-            Cell* jumpNode = jump(maze, current, dx[i], dy[i], goal);
-            
-            if (jumpNode) {
-                // We found a jump point!
-                int jumpIndex = jumpNode->y * maze.getWidth() + jumpNode->x;
-                
-                if (!closedSet[jumpIndex]) {
-                    // Calculate cost (distance from parent + distance to jump)
-                    double dist = std::abs(jumpNode->x - current->x) + std::abs(jumpNode->y - current->y);
-                    double new_g = current->g_cost + dist;
-                    
-                    if (new_g < jumpNode->g_cost || jumpNode->g_cost == 0) { // 0 check for fresh nodes
-                        jumpNode->g_cost = new_g;
-                        jumpNode->h_cost = Utility::manhattanDistance(jumpNode, goal);
-                        jumpNode->parent = current;
-                        
-                        openSet.push(jumpNode);
-                        
-                        // Visualize "Found a Jump Point"
-                        if (stepCallback) stepCallback(nullptr, jumpNode);
-                    }
-                }
-            }
+            if (Cell* node = jump(maze, current, dx[i], dy[i], goal)) jumpNodes.push_back(node);
         }
     }
-    
-    result.metrics.timeTakenMs = timer.stop();
-    if (timer.isTimeout()) result.success = false;
-    
-    if (result.success) {
-        // [IMPORTANT] Path reconstruction for JPS requires filling gaps
-        // Since parents are far away, we need to interpolate for the visual path
-        std::vector<Cell*> rawPath;
-        Cell* curr = goal;
-        while (curr != nullptr) {
-            rawPath.push_back(curr);
+}
+
+std::vector<Cell*> JumpPointSearch::JumpPoints::path(Maze& maze, Cell* goal) const {
+    PROFILE_ZONE("path", "reconstruct path");
+    // [IMPORTANT] Path reconstruction for JPS requires filling gaps
+    // Since parents are far away, we need to interpolate for the visual path
+    std::vector<Cell*> rawPath;
+    Cell* curr = goal;
+    while (curr != nullptr) {
+        rawPath.push_back(curr);
+        
+        Cell* par = curr->parent;
+        if (par) {
+            // Interpolate between current and parent
+            int dX = (par->x > curr->x) ? 1 : (par->x < curr->x) ? -1 : 0;
+            int dY = (par->y > curr->y) ? 1 : (par->y < curr->y) ? -1 : 0;
             
-            Cell* par = curr->parent;
-            if (par) {
-                // Interpolate between current and parent
-                int dX = (par->x > curr->x) ? 1 : (par->x < curr->x) ? -1 : 0;
-                int dY = (par->y > curr->y) ? 1 : (par->y < curr->y) ? -1 : 0;
-                
-                int tempX = curr->x + dX;
-                int tempY = curr->y + dY;
-                
-                while (tempX != par->x || tempY != par->y) {
-                    rawPath.push_back(maze.getCellPtr(tempX, tempY));
-                    tempX += dX;
-                    tempY += dY;
-                }
+            int tempX = curr->x + dX;
+            int tempY = curr->y + dY;
+            
+            while (tempX != par->x || tempY != par->y) {
+                rawPath.push_back(maze.getCellPtr(tempX, tempY));
+                tempX += dX;
+                tempY += dY;
             }
-            curr = par;
         }
-        std::reverse(rawPath.begin(), rawPath.end());
-        result.path = rawPath;
-        result.metrics.pathLength = result.path.size();
+        curr = par;
+    }
+    std::reverse(rawPath.begin(), rawPath.end());
+    return rawPath;
+}
+
+CompactPath JumpPointSearch::JumpPoints::compactPath(Maze& maze, Cell* goal) const {
+    PROFILE_ZONE("path", "reconstruct path");
+    // Same interpolation as path(), written straight into move codes from the back
+    size_t moves = 0;
+    Cell* root = goal;
+    for (; root->parent; root = root->parent) {
+        moves += std::max(std::abs(root->x - root->parent->x), std::abs(root->y - root->parent->y));
     }
     
-    result.metrics.nodesExplored = result.visitedOrder.size();
-    return result;
+    const int width = maze.getWidth();
+    CompactPath route(static_cast<uint32_t>(root->y * width + root->x), width, maze.getMovementMode());
+    route.resize(moves);
+    for (Cell* c = goal; c->parent; c = c->parent) {
+        int dX = (c->x > c->parent->x) ? 1 : (c->x < c->parent->x) ? -1 : 0;
+        int dY = (c->y > c->parent->y) ? 1 : (c->y < c->parent->y) ? -1 : 0;
+        for (int n = std::max(std::abs(c->x - c->parent->x), std::abs(c->y - c->parent->y)); n > 0; --n) {
+            route.set(--moves, dX, dY);
+        }
+    }
+    return route;
 }
\ No newline at end of file
@@ -2,12 +2,36 @@
 #include "../core/Maze.h"
 #include "../core/AlgorithmResult.h"
 #include "../core/Types.h"
+#include "SearchEngine.h"
 #include <functional>
+#include <vector>
 
 class JumpPointSearch {
 public:
-    static AlgorithmResult solve(
-    Maze& maze,
-    std::function<void(Cell*, Cell*)> stepCallback = nullptr
-);
+    static AlgorithmResult solve(Maze& maze, std::function<void(Cell*, Cell*)> stepCallback = nullptr,
+                                 ResultDetail detail = ResultDetail::Full, SolveArena* arena = nullptr);
+
+    // Successor policy for Search::Engine: jump points instead of direct neighbours
+    struct JumpPoints {
+        explicit JumpPoints(std::pmr::memory_resource* memory = std::pmr::get_default_resource()) : scratch(memory) {}
+
+        template <class Visit>
+        void forEach(Maze& maze, Cell* c, Cell* goal, Visit&& visit) const {
+            scratch.clear();
+            collect(maze, c, goal, scratch);
+            // Jumps are straight or pure diagonal, so the heuristic distance is exact
+            for (Cell* jumpNode : scratch) visit(jumpNode, Utility::heuristic(maze, c, jumpNode));
+        }
+        // Parents are jump points; fill in the cells between them
+        std::vector<Cell*> path(Maze& maze, Cell* goal) const;
+        CompactPath compactPath(Maze& maze, Cell* goal) const;
+
+        static void collect(Maze& maze, Cell* current, Cell* goal, std::pmr::vector<Cell*>& jumpNodes);
+
+    private:
+        mutable std::pmr::vector<Cell*> scratch;
+    };
+
+    // Resumable JPS: one step() unit is one jump point expanded
+    typedef Search::Engine<Search::MovementHeuristic, Search::BinaryHeap<Search::PreferHigherG>, JumpPoints> Stepper;
 };
\ No newline at end of file
@@ -0,0 +1,382 @@
+#include "OutOfCoreSearch.h"
+#include "../core/Utility.h"
+#include "../core/Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <limits>
+#include <list>
+#include <queue>
+#include <unordered_map>
+
+namespace {
+    const double UNREACHED = std::numeric_limits<double>::infinity();
+
+#ifdef _WIN32
+    int seekTo(std::FILE* f, uint64_t offset) { return _fseeki64(f, static_cast<__int64>(offset), SEEK_SET); }
+#else
+    int seekTo(std::FILE* f, uint64_t offset) { return fseeko(f, static_cast<off_t>(offset), SEEK_SET); }
+#endif
+
+    // Per-cell search state, tiled like the maze: a g value and a link byte (the move
+    // that reached the cell, plus a closed flag) in one dense block per tile. At most
+    // 'capacity' blocks are resident; the least recently used one is written to an
+    // anonymous scratch file when another is needed and read back on its next touch.
+    // Memory is capacity * blockBytes() however much of the maze a search explores.
+    class LabelStore {
+    public:
+        static constexpr uint8_t NO_MOVE = 0x0F;   // Start, or not reached
+        static constexpr uint8_t CLOSED = 0x80;
+
+        struct Label {
+            double g;
+            uint8_t link;
+            int move() const { return link & 0x0F; }
+            bool closed() const { return (link & CLOSED) != 0; }
+        };
+
+        LabelStore(const TiledMaze& maze, size_t capacity)
+            : tileSize(maze.getTileSize()), tilesX((maze.getWidth() + tileSize - 1) / tileSize),
+              cells(static_cast<size_t>(tileSize) * tileSize), capacity(std::max<size_t>(capacity, 1)) {}
+
+        ~LabelStore() {
+            if (spill) std::fclose(spill);
+        }
+
+        LabelStore(const LabelStore&) = delete;
+        LabelStore& operator=(const LabelStore&) = delete;
+
+        // Cells in blocks never written read as unreached without being allocated
+        Label get(int x, int y) {
+            Block* block = find(x, y, false);
+            if (!block) return {UNREACHED, NO_MOVE};
+            size_t i = local(x, y);
+            return {block->g[i], block->link[i]};
+        }
+
+        void set(int x, int y, double g, int move) {
+            Block* block = find(x, y, true);
+            if (!block) return;
+            size_t i = local(x, y);
+            block->g[i] = g;
+            block->link[i] = static_cast<uint8_t>(move);
+            block->dirty = true;
+        }
+
+        void close(int x, int y) {
+            Block* block = find(x, y, true);
+            if (!block) return;
+            block->link[local(x, y)] |= CLOSED;
+            block->dirty = true;
+        }
+
+        size_t blockBytes() const { return cells * (sizeof(double) + sizeof(uint8_t)); }
+        size_t peakBytes() const { return peakResident * blockBytes() + spilled.size() * 2 * sizeof(uint64_t); }
+        size_t spills() const { return spillCount; }
+        // The scratch file could not be created, written or read; the search must stop
+        const std::string& error() const { return failure; }
+
+    private:
+        struct Block {
+            std::vector<double> g;
+            std::vector<uint8_t> link;
+            std::list<uint64_t>::iterator position;
+            bool dirty;
+        };
+
+        const int tileSize;
+        const uint64_t tilesX;
+        const size_t cells;
+        const size_t capacity;
+        std::unordered_map<uint64_t, Block> resident;
+        std::list<uint64_t> recency;                  // Front = most recently used
+        std::unordered_map<uint64_t, uint64_t> spilled;   // Block id -> scratch file offset
+        std::FILE* spill = nullptr;
+        uint64_t spillEnd = 0;
+        size_t spillCount = 0;
+        size_t peakResident = 0;
+        std::string failure;
+        uint64_t lastId = UINT64_MAX;
+        Block* last = nullptr;
+
+        uint64_t blockId(int x, int y) const {
+            return static_cast<uint64_t>(y / tileSize) * tilesX + static_cast<uint64_t>(x / tileSize);
+        }
+        size_t local(int x, int y) const {
+            return static_cast<size_t>(y % tileSize) * tileSize + static_cast<size_t>(x % tileSize);
+        }
+
+        // The block holding (x, y), paging it in if it was spilled. With 'create' an
+        // untouched block is made; without, it is left alone and nullptr returned.
+        Block* find(int x, int y, bool create) {
+            uint64_t id = blockId(x, y);
+            if (id == lastId) return last;
+            auto it = resident.find(id);
+            if (it != resident.end()) {
+                recency.splice(recency.begin(), recency, it->second.position);
+            } else {
+                auto onDisk = spilled.find(id);
+                if (onDisk == spilled.end() && !create) return nullptr;
+                if (!failure.empty()) return nullptr;
+                it = load(id, onDisk == spilled.end() ? nullptr : &onDisk->second);
+                if (it == resident.end()) return nullptr;
+            }
+            lastId = id;
+            last = &it->second;
+            return last;
+        }
+
+        std::unordered_map<uint64_t, Block>::iterator load(uint64_t id, const uint64_t* offset) {
+            Block block;
+            if (resident.size() >= capacity) {
+                // Reuse the evicted block's storage for the incoming one
+                uint64_t victim = recency.back();
+                auto out = resident.find(victim);
+                if (out->second.dirty && !write(victim, out->second)) return resident.end();
+                block.g = std::move(out->second.g);
+                block.link = std::move(out->second.link);
+                recency.pop_back();
+                resident.erase(out);
+                if (victim == lastId) lastId = UINT64_MAX;
+            } else {
+                block.g.resize(cells);
+                block.link.resize(cells);
+            }
+            if (offset) {
+                if (!read(*offset, block)) return resident.end();
+            } else {
+                std::fill(block.g.begin(), block.g.end(), UNREACHED);
+                std::fill(block.link.begin(), block.link.end(), NO_MOVE);
+            }
+            block.dirty = !offset;
+            recency.push_front(id);
+            block.position = recency.begin();
+            peakResident = std::max(peakResident, resident.size() + 1);
+            return resident.emplace(id, std::move(block)).first;
+        }
+
+        bool write(uint64_t id, const Block& block) {
+            PROFILE_ZONE("io", "spill labels");
+            if (!spill && !(spill = std::tmpfile())) {
+                failure = "Cannot create a scratch file for search labels";
+                return false;
+            }
+            auto [slot, fresh] = spilled.try_emplace(id, spillEnd);
+            if (fresh) spillEnd += blockBytes();
+            if (seekTo(spill, slot->second) != 0 ||
+                std::fwrite(block.g.data(), sizeof(double), cells, spill) != cells ||
+                std::fwrite(block.link.data(), sizeof(uint8_t), cells, spill) != cells) {
+                failure = "Writing search labels to the scratch file failed";
+                return false;
+            }
+            spillCount++;
+            return true;
+        }
+
+        bool read(uint64_t offset, Block& block) {
+            PROFILE_ZONE("io", "reload labels");
+            if (seekTo(spill, offset) != 0 ||
+                std::fread(block.g.data(), sizeof(double), cells, spill) != cells ||
+                std::fread(block.link.data(), sizeof(uint8_t), cells, spill) != cells) {
+                failure = "Reading search labels back from the scratch file failed";
+                return false;
+            }
+            return true;
+        }
+    };
+
+    int directionCount(MovementMode mode) { return mode == MovementMode::EightWay ? 8 : 4; }
+
+    // Shared start/end of both searches: endpoint checks going in, path and I/O coming out
+    class Query {
+    public:
+        Query(TiledMaze& maze, int sx, int sy, int gx, int gy, long long timeoutMs)
+            : maze(maze), width(maze.getWidth()), sx(sx), sy(sy), gx(gx), gy(gy) {
+            maze.resetStats();
+            timer.start(timeoutMs);
+        }
+
+        uint64_t id(int x, int y) const { return static_cast<uint64_t>(y) * width + x; }
+        int xOf(uint64_t i) const { return static_cast<int>(i % width); }
+        int yOf(uint64_t i) const { return static_cast<int>(i / width); }
+
+        bool endpointsOpen() { return maze.isWalkable(sx, sy) && maze.isWalkable(gx, gy); }
+        bool timedOut(size_t expanded) const { return (expanded & 1023) == 0 && timer.isTimeout(); }
+
+        void pushed(size_t openSize) {
+            counters.heapPushes++;
+            counters.peakOpenSize = std::max(counters.peakOpenSize, openSize);
+        }
+
+        OutOfCoreResult finish(LabelStore& labels, bool found, bool timedOut, size_t expanded) {
+            OutOfCoreResult result;
+            result.metrics = counters;
+            result.metrics.nodesExplored = expanded;
+            result.metrics.bytesAllocated = labels.peakBytes();
+            result.labelSpills = labels.spills();
+            result.error = labels.error();
+            if (found) {
+                // Each cell's link is the move that reached it: walk them back from the goal
+                int x = gx, y = gy;
+                for (int move = labels.get(x, y).move(); move != LabelStore::NO_MOVE; move = labels.get(x, y).move()) {
+                    result.moves.push_back(static_cast<uint8_t>(move));
+                    x -= CompactPath::DX[move];
+                    y -= CompactPath::DY[move];
+                }
+                std::reverse(result.moves.begin(), result.moves.end());
+                found = result.error.empty();
+            }
+            if (found) {
+                result.success = true;
+                result.metrics.pathLength = result.moves.size() + 1;
+                for (uint8_t c : result.moves) result.metrics.pathCost += (c < 4) ? 1.0 : Utility::SQRT2;
+            } else {
+                result.moves.clear();
+                result.failure = timedOut ? FailureReason::TimedOut : FailureReason::Exhausted;
+            }
+            result.metrics.timeTakenMs = timer.stop();
+            result.io = maze.stats();
+            return result;
+        }
+
+        OutOfCoreResult missingEndpoints() {
+            OutOfCoreResult result;
+            result.failure = FailureReason::MissingEndpoints;
+            result.metrics.timeTakenMs = timer.stop();
+            result.io = maze.stats();
+            return result;
+        }
+
+        TiledMaze& maze;
+        const int width;
+        const int sx, sy, gx, gy;
+        RobustTimer timer;
+        Metrics counters;           // Open-list counters; the BFS frontier counts as its open list
+    };
+}
+
+OutOfCoreResult OutOfCoreSearch::bfs(TiledMaze& maze, int sx, int sy, int gx, int gy, MovementMode mode,
+                                     bool prefetch, long long timeoutMs, size_t labelTiles) {
+    PROFILE_ZONE("search", "out-of-core bfs");
+    Query query(maze, sx, sy, gx, gy, timeoutMs);
+    if (!query.endpointsOpen()) return query.missingEndpoints();
+    
+    LabelStore labels(maze, labelTiles ? labelTiles : maze.cacheCapacity());
+    std::deque<uint64_t> frontier;
+    const uint64_t goal = query.id(gx, gy);
+    labels.set(sx, sy, 0.0, LabelStore::NO_MOVE);
+    frontier.push_back(query.id(sx, sy));
+    query.pushed(frontier.size());
+    
+    const int directions = directionCount(mode);
+    size_t expanded = 0;
+    bool found = false, timedOut = false;
+    while (!frontier.empty() && labels.error().empty()) {
+        uint64_t current = frontier.front();
+        frontier.pop_front();
+        query.counters.heapPops++;
+        if (query.timedOut(++expanded)) {
+            timedOut = true;
+            break;
+        }
+        if (current == goal) {
+            found = true;
+            break;
+        }
+        
+        int x = query.xOf(current), y = query.yOf(current);
+        double g = labels.get(x, y).g;
+        for (int d = 0; d < directions; ++d) {
+            int dx = CompactPath::DX[d], dy = CompactPath::DY[d];
+            if (!maze.canStep(x, y, dx, dy)) continue;
+            // Labelled on discovery: BFS never finds a shorter way in later
+            if (labels.get(x + dx, y + dy).g != UNREACHED) continue;
+            labels.set(x + dx, y + dy, g + 1, d);
+            if (prefetch) maze.prefetchAhead(x + dx, y + dy, dx, dy);
+            frontier.push_back(query.id(x + dx, y + dy));
+            query.pushed(frontier.size());
+        }
+    }
+    return query.finish(labels, found, timedOut, expanded);
+}
+
+OutOfCoreResult OutOfCoreSearch::astar(TiledMaze& maze, int sx, int sy, int gx, int gy, MovementMode mode,
+                                       bool prefetch, long long timeoutMs, size_t labelTiles) {
+    PROFILE_ZONE("search", "out-of-core A*");
+    Query query(maze, sx, sy, gx, gy, timeoutMs);
+    if (!query.endpointsOpen()) return query.missingEndpoints();
+    
+    auto heuristic = [&](int x, int y) {
+        int dx = std::abs(x - gx), dy = std::abs(y - gy);
+        if (mode == MovementMode::EightWay) return std::max(dx, dy) + (Utility::SQRT2 - 1.0) * std::min(dx, dy);
+        return double(dx + dy);
+    };
+    struct Entry {
+        double f, g;
+        uint64_t cell;
+        // Min-heap on f, deeper nodes first on ties
+        bool operator<(const Entry& o) const { return f != o.f ? f > o.f : g < o.g; }
+    };
+    
+    LabelStore labels(maze, labelTiles ? labelTiles : maze.cacheCapacity());
+    std::priority_queue<Entry> open;
+    const uint64_t goal = query.id(gx, gy);
+    labels.set(sx, sy, 0.0, LabelStore::NO_MOVE);
+    open.push({heuristic(sx, sy), 0.0, query.id(sx, sy)});
+    query.pushed(open.size());
+    query.counters.heuristicEvaluations++;
+    
+    const int directions = directionCount(mode);
+    size_t expanded = 0;
+    bool found = false, timedOut = false;
+    while (!open.empty() && labels.error().empty()) {
+        Entry top = open.top();
+        open.pop();
+        query.counters.heapPops++;
+        int x = query.xOf(top.cell), y = query.yOf(top.cell);
+        LabelStore::Label label = labels.get(x, y);
+        if (label.closed() || top.g > label.g) {            // Stale entry
+            query.counters.stalePops++;
+            continue;
+        }
+        labels.close(x, y);
+        if (query.timedOut(++expanded)) {
+            timedOut = true;
+            break;
+        }
+        if (top.cell == goal) {
+            found = true;
+            break;
+        }
+        
+        for (int d = 0; d < directions; ++d) {
+            int dx = CompactPath::DX[d], dy = CompactPath::DY[d];
+            if (!maze.canStep(x, y, dx, dy)) continue;
+            double g = top.g + ((dx != 0 && dy != 0) ? Utility::SQRT2 : 1.0);
+            LabelStore::Label next = labels.get(x + dx, y + dy);
+            if (next.closed()) {
+                if (g < next.g - 1e-9) query.counters.reopenings++;
+                continue;
+            }
+            if (g >= next.g) continue;
+            labels.set(x + dx, y + dy, g, d);
+            if (prefetch) maze.prefetchAhead(x + dx, y + dy, dx, dy);
+            open.push({g + heuristic(x + dx, y + dy), g, query.id(x + dx, y + dy)});
+            query.pushed(open.size());
+            query.counters.heuristicEvaluations++;
+        }
+    }
+    return query.finish(labels, found, timedOut, expanded);
+}
+
+bool OutOfCoreSearch::validate(TiledMaze& maze, int sx, int sy, int gx, int gy, MovementMode mode,
+                               const std::vector<uint8_t>& moves) {
+    int x = sx, y = sy;
+    for (uint8_t c : moves) {
+        if (c >= directionCount(mode) || !maze.canStep(x, y, CompactPath::DX[c], CompactPath::DY[c])) return false;
+        x += CompactPath::DX[c];
+        y += CompactPath::DY[c];
+    }
+    return x == gx && y == gy;
+}
\ No newline at end of file
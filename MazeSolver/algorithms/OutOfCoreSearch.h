@@ -0,0 +1,36 @@
+#pragma once
+#include "../core/TiledMaze.h"
+#include "../core/Types.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct OutOfCoreResult {
+    std::vector<uint8_t> moves;     // One CompactPath::DX/DY code per step, start to goal
+    Metrics metrics;
+    TiledMaze::CacheStats io;       // Tile traffic of this query alone
+    size_t labelSpills = 0;         // Label blocks written out to the scratch file
+    bool success = false;
+    FailureReason failure = FailureReason::None;
+    std::string error;              // Set when the label scratch file failed (failure is Exhausted)
+};
+
+// Searches over a TiledMaze. Walls come through the tile cache. Search state (g, the move
+// that reached each cell, closed) is kept tile by tile, 9 bytes per cell of a touched
+// tile, with at most 'labelTiles' tiles resident (0 = the maze's cache capacity); the
+// rest is spilled to an anonymous scratch file. So neither the walls nor the labels need
+// to fit in memory, only the open list / BFS frontier does. With 'prefetch' on, every
+// push reads ahead the tile the step is heading into.
+class OutOfCoreSearch {
+public:
+    // Fewest steps (4-connected: shortest path)
+    static OutOfCoreResult bfs(TiledMaze& maze, int sx, int sy, int gx, int gy, MovementMode mode,
+                               bool prefetch = true, long long timeoutMs = 30000, size_t labelTiles = 0);
+    // Shortest path; Manhattan or octile heuristic by movement mode
+    static OutOfCoreResult astar(TiledMaze& maze, int sx, int sy, int gx, int gy, MovementMode mode,
+                                 bool prefetch = true, long long timeoutMs = 30000, size_t labelTiles = 0);
+
+    // Replays the moves through the cache; true when they are legal and end at the goal
+    static bool validate(TiledMaze& maze, int sx, int sy, int gx, int gy, MovementMode mode,
+                         const std::vector<uint8_t>& moves);
+};
\ No newline at end of file
@@ -0,0 +1,320 @@
+#include "ParallelBFS.h"
+#include "../core/WallGrid.h"
+#include "../core/Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace {
+    // Generation barrier that spins briefly, then parks on a condition variable. Parallel
+    // levels come back to back, so the spin catches them; during a run of narrow levels
+    // on the calling thread the workers sleep instead of holding cores.
+    class LevelBarrier {
+    public:
+        explicit LevelBarrier(unsigned count) : count(count), remaining(count) {}
+
+        void wait() {
+            unsigned gen = generation.load(std::memory_order_acquire);
+            if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                remaining.store(count, std::memory_order_relaxed);
+                {
+                    // Under the lock, so a thread between its check and its sleep can't miss it
+                    std::lock_guard<std::mutex> lock(mutex);
+                    generation.store(gen + 1, std::memory_order_release);
+                }
+                wake.notify_all();
+                return;
+            }
+            for (int spins = 0; spins < SPIN_LIMIT; ++spins) {
+                if (generation.load(std::memory_order_acquire) != gen) return;
+                if (spins > 64) std::this_thread::yield();
+            }
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return generation.load(std::memory_order_acquire) != gen; });
+        }
+
+    private:
+        static constexpr int SPIN_LIMIT = 1024;
+        const unsigned count;
+        std::atomic<unsigned> remaining;
+        std::atomic<unsigned> generation{0};
+        std::mutex mutex;
+        std::condition_variable wake;
+    };
+
+    // Levels narrower than this stay on the calling thread
+    const size_t PARALLEL_FRONTIER = 4096;
+    // Beamer's switch points: bottom-up once the frontier exceeds unvisited / ALPHA,
+    // back to top-down once it drops below all / BETA
+    const size_t ALPHA = 14;
+    const size_t BETA = 24;
+
+    class Traversal {
+    public:
+        Traversal(const Maze& maze, unsigned threads)
+            : width(maze.getWidth()), height(maze.getHeight()),
+              wordsPerRow(WallGrid::wordsForWidth(maze.getWidth())),
+              eightWay(maze.getMovementMode() == MovementMode::EightWay),
+              threads(threads), walls(maze.packWalls()), barrier(threads) {
+            // Padding bits past the last column count as wall
+            if (width % 64 != 0) {
+                uint64_t padding = ~((uint64_t(1) << (width % 64)) - 1);
+                for (int y = 0; y < height; ++y) walls[y * wordsPerRow + wordsPerRow - 1] |= padding;
+            }
+            // Walls start out "visited", so an unvisited bit is always an open cell
+            visited.reset(new std::atomic<uint64_t>[walls.size()]);
+            for (size_t w = 0; w < walls.size(); ++w) {
+                visited[w].store(walls[w], std::memory_order_relaxed);
+                openCells += 64 - __builtin_popcountll(walls[w]);
+            }
+            localNext.resize(threads);
+            localCount.assign(threads, 0);
+
+            field.width = width;
+            field.height = height;
+            field.threads = threads;
+            field.distance.assign(static_cast<size_t>(width) * height, DistanceField::UNREACHED);
+        }
+
+        // 'began' is when setup started, so the time covers packing the walls too
+        DistanceField run(int sx, int sy, std::chrono::high_resolution_clock::time_point began) {
+            if (open(sx, sy)) {
+                claim(sx, sy);
+                field.distance[static_cast<size_t>(sy) * width + sx] = 0;
+                frontier.push_back(static_cast<uint32_t>(sy * width + sx));
+                field.reached = 1;
+                search();
+            }
+            auto micro = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::high_resolution_clock::now() - began).count();
+            field.timeTakenUs = micro > 0 ? micro : 1;
+            countEdges();
+            return std::move(field);
+        }
+
+    private:
+        enum class Mode { TopDown, BottomUp, Stop };
+
+        const int width, height;
+        const size_t wordsPerRow;
+        const bool eightWay;
+        const unsigned threads;
+        std::vector<uint64_t> walls;
+        size_t openCells = 0;
+
+        std::unique_ptr<std::atomic<uint64_t>[]> visited;
+        std::vector<uint32_t> frontier;                 // Top-down: row-major cell indices
+        std::vector<uint64_t> frontierBits, nextBits;   // Bottom-up: bitmaps in wall layout
+        std::vector<std::vector<uint32_t>> localNext;   // Per thread, top-down
+        std::vector<size_t> localCount;                 // Per thread, bottom-up
+
+        LevelBarrier barrier;
+        Mode mode = Mode::TopDown;
+        unsigned parts = 1;                             // Threads sharing the current level
+        uint32_t level = 0;
+        DistanceField field;
+
+        size_t word(int x, int y) const { return static_cast<size_t>(y) * wordsPerRow + (x >> 6); }
+        static uint64_t bit(int x) { return uint64_t(1) << (x & 63); }
+
+        bool open(int x, int y) const {
+            if (x < 0 || x >= width || y < 0 || y >= height) return false;
+            return !(walls[word(x, y)] & bit(x));
+        }
+
+        void claim(int x, int y) { visited[word(x, y)].fetch_or(bit(x), std::memory_order_relaxed); }
+
+        // Same moves as Maze::canStep; stops early when 'visit' returns true
+        template <class Visit>
+        void forEachNeighbour(int x, int y, Visit&& visit) const {
+            static const int dx[] = {0, 0, 1, -1, 1, 1, -1, -1};
+            static const int dy[] = {1, -1, 0, 0, 1, -1, 1, -1};
+            const int count = eightWay ? 8 : 4;
+            for (int i = 0; i < count; ++i) {
+                int nx = x + dx[i], ny = y + dy[i];
+                if (!open(nx, ny)) continue;
+                if (i >= 4 && (!open(nx, y) || !open(x, ny))) continue;
+                if (visit(nx, ny)) return;
+            }
+        }
+
+        // ---- Per-thread level work ----
+
+        void topDown(unsigned t) {
+            std::vector<uint32_t>& next = localNext[t];
+            size_t begin = frontier.size() * t / parts;
+            size_t end = frontier.size() * (t + 1) / parts;
+            for (size_t i = begin; i < end; ++i) {
+                int x = static_cast<int>(frontier[i] % width);
+                int y = static_cast<int>(frontier[i] / width);
+                forEachNeighbour(x, y, [&](int nx, int ny) {
+                    std::atomic<uint64_t>& w = visited[word(nx, ny)];
+                    // Cheap read first; only race for cells that still look unvisited
+                    if (w.load(std::memory_order_relaxed) & bit(nx)) return false;
+                    if (w.fetch_or(bit(nx), std::memory_order_relaxed) & bit(nx)) return false;
+                    size_t index = static_cast<size_t>(ny) * width + nx;
+                    field.distance[index] = level + 1;
+                    next.push_back(static_cast<uint32_t>(index));
+                    return false;
+                });
+            }
+        }
+
+        // Rows are word-aligned, so each thread owns every visited/next word it writes
+        void bottomUp(unsigned t) {
+            size_t count = 0;
+            int rowBegin = static_cast<int>(static_cast<long long>(height) * t / parts);
+            int rowEnd = static_cast<int>(static_cast<long long>(height) * (t + 1) / parts);
+            for (int y = rowBegin; y < rowEnd; ++y) {
+                for (size_t wi = 0; wi < wordsPerRow; ++wi) {
+                    size_t w = y * wordsPerRow + wi;
+                    uint64_t seen = visited[w].load(std::memory_order_relaxed);
+                    uint64_t candidates = ~seen;
+                    uint64_t found = 0;
+                    while (candidates) {
+                        int b = __builtin_ctzll(candidates);
+                        candidates &= candidates - 1;
+                        int x = static_cast<int>(wi * 64) + b;
+                        forEachNeighbour(x, y, [&](int nx, int ny) {
+                            if (!(frontierBits[word(nx, ny)] & bit(nx))) return false;
+                            found |= uint64_t(1) << b;
+                            return true;
+                        });
+                    }
+                    nextBits[w] = found;
+                    if (!found) continue;
+                    visited[w].store(seen | found, std::memory_order_relaxed);
+                    count += __builtin_popcountll(found);
+                    for (uint64_t f = found; f; f &= f - 1) {
+                        int x = static_cast<int>(wi * 64) + __builtin_ctzll(f);
+                        field.distance[static_cast<size_t>(y) * width + x] = level + 1;
+                    }
+                }
+            }
+            localCount[t] = count;
+        }
+
+        void work(unsigned t) {
+            if (mode == Mode::TopDown) topDown(t);
+            else bottomUp(t);
+        }
+
+        void worker(unsigned t) {
+            PROFILE_THREAD("bfs worker");
+            while (true) {
+                barrier.wait();                 // Level published
+                if (mode == Mode::Stop) return;
+                if (t < parts) {
+                    PROFILE_ZONE("bfs", mode == Mode::TopDown ? "top-down level" : "bottom-up level");
+                    work(t);
+                }
+                barrier.wait();                 // Level done
+            }
+        }
+
+        // ---- Driver (calling thread) ----
+
+        void toBits() {
+            frontierBits.assign(walls.size(), 0);
+            nextBits.assign(walls.size(), 0);
+            for (uint32_t c : frontier) {
+                int x = static_cast<int>(c % width);
+                frontierBits[word(x, static_cast<int>(c / width))] |= bit(x);
+            }
+            frontier.clear();
+        }
+
+        void toList() {
+            frontier.clear();
+            for (int y = 0; y < height; ++y) {
+                for (size_t wi = 0; wi < wordsPerRow; ++wi) {
+                    for (uint64_t f = frontierBits[y * wordsPerRow + wi]; f; f &= f - 1) {
+                        int x = static_cast<int>(wi * 64) + __builtin_ctzll(f);
+                        frontier.push_back(static_cast<uint32_t>(y * width + x));
+                    }
+                }
+            }
+        }
+
+        void search() {
+            std::vector<std::thread> pool;
+            for (unsigned t = 1; t < threads; ++t) pool.emplace_back([this, t] { worker(t); });
+
+            size_t frontierSize = 1, previousSize = 0;
+            while (frontierSize > 0) {
+                size_t unvisited = openCells - field.reached;
+                bool growing = frontierSize > previousSize;
+                if (mode == Mode::TopDown && growing && frontierSize >= PARALLEL_FRONTIER &&
+                    frontierSize > unvisited / ALPHA) {
+                    toBits();
+                    mode = Mode::BottomUp;
+                } else if (mode == Mode::BottomUp && !growing && frontierSize < openCells / BETA) {
+                    toList();
+                    mode = Mode::TopDown;
+                }
+
+                bool parallel = threads > 1 && (mode == Mode::BottomUp || frontierSize >= PARALLEL_FRONTIER);
+                parts = parallel ? threads : 1;
+                if (parallel) {
+                    // Only parallel levels get zones: corridor mazes run millions of narrow ones
+                    PROFILE_ZONE("bfs", mode == Mode::TopDown ? "top-down level" : "bottom-up level");
+                    barrier.wait();
+                    work(0);
+                    barrier.wait();
+                } else {
+                    work(0);
+                }
+
+                previousSize = frontierSize;
+                if (mode == Mode::TopDown) {
+                    field.topDownLevels++;
+                    frontier.clear();
+                    for (unsigned t = 0; t < parts; ++t) {
+                        frontier.insert(frontier.end(), localNext[t].begin(), localNext[t].end());
+                        localNext[t].clear();
+                    }
+                    frontierSize = frontier.size();
+                } else {
+                    field.bottomUpLevels++;
+                    frontierBits.swap(nextBits);
+                    frontierSize = 0;
+                    for (unsigned t = 0; t < parts; ++t) frontierSize += localCount[t];
+                }
+                field.reached += frontierSize;
+                level++;
+                if (frontierSize > 0) field.eccentricity = level;
+            }
+
+            mode = Mode::Stop;
+            if (!pool.empty()) barrier.wait();
+            for (std::thread& t : pool) t.join();
+        }
+
+        // Each undirected edge counted once: only towards the larger cell index
+        void countEdges() {
+            uint64_t edges = 0;
+            for (int y = 0; y < height; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    if (field.distance[static_cast<size_t>(y) * width + x] == DistanceField::UNREACHED) continue;
+                    forEachNeighbour(x, y, [&](int nx, int ny) {
+                        if (ny > y || (ny == y && nx > x)) edges++;
+                        return false;
+                    });
+                }
+            }
+            field.edges = edges;
+        }
+    };
+}
+
+DistanceField ParallelBFS::distances(const Maze& maze, int sourceX, int sourceY, unsigned threads) {
+    PROFILE_ZONE("bfs", "parallel bfs");
+    auto began = std::chrono::high_resolution_clock::now();
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    Traversal traversal(maze, threads);
+    return traversal.run(sourceX, sourceY, began);
+}
\ No newline at end of file
@@ -0,0 +1,17 @@
+#pragma once
+#include "../core/Maze.h"
+#include "../core/DistanceField.h"
+
+// Level-synchronous, direction-optimizing BFS over a small thread pool.
+// Top-down levels split the frontier list between threads, which claim neighbours through
+// an atomic visited bitmap. Once the frontier is large next to what is still unvisited,
+// levels go bottom-up instead: each thread scans its own band of rows for unvisited cells
+// with a neighbour in the frontier bitmap, and needs no atomics at all.
+// Narrow top-down levels run on the calling thread alone - in corridor mazes most levels
+// are a handful of cells, and a barrier per level would cost more than the work. The
+// pool parks on a condition variable meanwhile and is woken for the next wide level.
+class ParallelBFS {
+public:
+    // threads = 0: one per hardware thread
+    static DistanceField distances(const Maze& maze, int sourceX, int sourceY, unsigned threads = 0);
+};
\ No newline at end of file
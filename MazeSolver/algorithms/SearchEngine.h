@@ -0,0 +1,323 @@
+#pragma once
+#include "../core/Maze.h"
+#include "../core/Profiler.h"
+#include "../core/Landmarks.h"
+#include "../core/SearchStepper.h"
+#include "../core/Types.h"
+#include "../core/Utility.h"
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <memory_resource>
+#include <vector>
+
+// One best-first search, specialised at compile time.
+//
+//   Engine<Heuristic, OpenList, Successors>
+//
+// Heuristic   h(cell, goal). Built from the Maze so it can read the movement mode
+//             or precomputed tables.
+// OpenList    push/pop/empty over Entry {f, g, cell}. BinaryHeap<TieBreak> or BucketQueue.
+//             Built on the stepper's scratch memory resource, like every per-search array.
+//             size() feeds the peak-open-size counter.
+// Successors  forEach(maze, cell, goal, visit(next, cost)) plus path(maze, goal)
+//             and compactPath(maze, goal).
+//             GridNeighbors or the JPS jump points.
+// Observer    per call to run(): NullObserver, EventObserver or CallbackObserver.
+//             With NullObserver every hook is an empty inline call, so benchmark
+//             builds pay nothing for visualisation.
+//
+// Dijkstra, AStar and JumpPointSearch are just choices of these policies.
+namespace Search {
+
+    // ========== Heuristics ==========
+
+    struct ZeroHeuristic {
+        explicit ZeroHeuristic(const Maze&) {}
+        double operator()(const Cell*, const Cell*) const { return 0.0; }
+    };
+
+    struct Manhattan {
+        explicit Manhattan(const Maze&) {}
+        static double distance(const Cell* a, const Cell* b) {
+            return std::abs(a->x - b->x) + std::abs(a->y - b->y);
+        }
+        double operator()(const Cell* a, const Cell* b) const { return distance(a, b); }
+    };
+
+    struct Octile {
+        explicit Octile(const Maze&) {}
+        static double distance(const Cell* a, const Cell* b) {
+            int dx = std::abs(a->x - b->x);
+            int dy = std::abs(a->y - b->y);
+            return std::max(dx, dy) + (Utility::SQRT2 - 1.0) * std::min(dx, dy);
+        }
+        double operator()(const Cell* a, const Cell* b) const { return distance(a, b); }
+    };
+
+    // Manhattan or octile, decided per call. For steppers whose type can't depend on the mode.
+    struct MovementHeuristic {
+        MovementMode mode;
+        explicit MovementHeuristic(const Maze& maze) : mode(maze.getMovementMode()) {}
+        double operator()(const Cell* a, const Cell* b) const {
+            return mode == MovementMode::EightWay ? Octile::distance(a, b) : Manhattan::distance(a, b);
+        }
+    };
+
+    // ALT: the landmark lower bound when the maze carries a LandmarkTable, never below
+    // the geometric bound. Symmetric, so it serves both directions of a bidirectional search.
+    struct LandmarkHeuristic {
+        const LandmarkTable* table;
+        MovementHeuristic base;
+        int width;
+        explicit LandmarkHeuristic(const Maze& maze)
+            : table(maze.getLandmarks()), base(maze), width(maze.getWidth()) {}
+        double operator()(const Cell* a, const Cell* b) const {
+            double h = base(a, b);
+            if (!table) return h;
+            size_t ia = static_cast<size_t>(a->y) * width + a->x;
+            size_t ib = static_cast<size_t>(b->y) * width + b->x;
+            return std::max(h, table->lowerBound(ia, ib));
+        }
+    };
+
+    // ========== Open lists ==========
+
+    struct Entry {
+        double f;
+        double g;
+        Cell* cell;
+    };
+
+    // Equal f: no preference (whatever the heap does)
+    struct NoTieBreak {
+        static bool before(const Entry&, const Entry&) { return false; }
+    };
+
+    // Equal f: expand the deeper node first, which heads straight for the goal
+    // instead of fanning out across a plateau of equal f values
+    struct PreferHigherG {
+        static bool before(const Entry& a, const Entry& b) { return a.g > b.g; }
+    };
+
+    template <class TieBreak>
+    class BinaryHeap {
+    private:
+        struct Worse {
+            bool operator()(const Entry& a, const Entry& b) const {
+                if (a.f != b.f) return a.f > b.f;
+                return TieBreak::before(b, a);
+            }
+        };
+        std::pmr::vector<Entry> heap;
+
+    public:
+        explicit BinaryHeap(std::pmr::memory_resource* memory = std::pmr::get_default_resource()) : heap(memory) {}
+        bool empty() const { return heap.empty(); }
+        size_t size() const { return heap.size(); }
+        const Entry& top() const { return heap.front(); }
+        void push(const Entry& e) {
+            heap.push_back(e);
+            std::push_heap(heap.begin(), heap.end(), Worse());
+        }
+        Entry pop() {
+            std::pop_heap(heap.begin(), heap.end(), Worse());
+            Entry e = heap.back();
+            heap.pop_back();
+            return e;
+        }
+    };
+
+    // O(1) queue for integer f values (4-connected: unit steps, Manhattan/zero heuristic).
+    // LIFO inside a bucket, which already prefers the most recent (deepest) nodes.
+    class BucketQueue {
+    private:
+        std::pmr::vector<std::pmr::vector<Entry>> buckets;   // Inner vectors share the resource
+        size_t current = 0;
+        size_t count = 0;
+
+    public:
+        explicit BucketQueue(std::pmr::memory_resource* memory = std::pmr::get_default_resource()) : buckets(memory) {}
+        bool empty() const { return count == 0; }
+        size_t size() const { return count; }
+        void push(const Entry& e) {
+            size_t key = static_cast<size_t>(e.f + 0.5);
+            if (key >= buckets.size()) buckets.resize(key + 1);
+            buckets[key].push_back(e);
+            if (key < current) current = key;
+            ++count;
+        }
+        Entry pop() {
+            while (buckets[current].empty()) ++current;
+            Entry e = buckets[current].back();
+            buckets[current].pop_back();
+            --count;
+            return e;
+        }
+    };
+
+    // ========== Successors ==========
+
+    // Plain grid moves: 4 orthogonal, plus 4 diagonals without corner cutting when 8-connected.
+    // Same order as Maze::getNeighbors, without building a vector per expansion.
+    struct GridNeighbors {
+        explicit GridNeighbors(std::pmr::memory_resource* = nullptr) {}
+
+        template <class Visit>
+        void forEach(Maze& maze, Cell* c, Cell* goal, Visit&& visit) const {
+            (void)goal;
+            static const int dx[] = {0, 0, 1, -1, 1, 1, -1, -1};
+            static const int dy[] = {1, -1, 0, 0, 1, -1, 1, -1};
+            int count = (maze.getMovementMode() == MovementMode::EightWay) ? 8 : 4;
+            for (int i = 0; i < count; ++i) {
+                if (maze.canStep(c->x, c->y, dx[i], dy[i])) {
+                    visit(maze.getCellPtr(c->x + dx[i], c->y + dy[i]), i < 4 ? 1.0 : Utility::SQRT2);
+                }
+            }
+        }
+        std::vector<Cell*> path(Maze&, Cell* goal) const { return Utility::reconstructPath(goal); }
+        CompactPath compactPath(Maze& maze, Cell* goal) const { return Utility::reconstructCompactPath(maze, goal); }
+    };
+
+    // ========== Observers ==========
+
+    struct NullObserver {
+        void visit(Cell*) {}
+        void frontier(Cell*) {}
+        std::vector<SearchEvent>* sink() const { return nullptr; }
+    };
+
+    struct EventObserver {
+        std::vector<SearchEvent>* events;
+        void visit(Cell* c) { events->push_back({c, SearchTrace::Visit}); }
+        void frontier(Cell* c) { events->push_back({c, SearchTrace::Frontier}); }
+        std::vector<SearchEvent>* sink() const { return events; }
+    };
+
+    // Adapter for the solvers' classic stepCallback(visited, frontier)
+    struct CallbackObserver {
+        const std::function<void(Cell*, Cell*)>& callback;
+        void visit(Cell* c) { callback(c, nullptr); }
+        void frontier(Cell* c) { callback(nullptr, c); }
+        std::vector<SearchEvent>* sink() const { return nullptr; }
+    };
+
+    // ========== Engine ==========
+
+    // Where run() spends its time, when built with MAZE_PROFILING
+    inline constexpr const char* ENGINE_PHASES[] = {"open list pop", "close + visit callback", "neighbors", "push + frontier callback"};
+
+    template <class Heuristic, class OpenList, class Successors = GridNeighbors>
+    class Engine : public SearchStepper {
+    public:
+        explicit Engine(Maze& maze, SolveArena* arena = nullptr)
+            : SearchStepper(arena), maze(maze), heuristic(maze), successors(scratch()),
+              openSet(scratch()), closedSet(scratch()) {
+            PROFILE_ZONE("search", "setup");
+            start = maze.getStart();
+            goal = maze.getGoal();
+            // Before any per-cell setup, so a rejected query costs O(1)
+            if (rejectEarly(maze, start, goal)) return;
+            maze.reset();
+            // Indexed by storage slot, so it follows the maze's cell layout
+            closedSet.assign(maze.slotCount(), false);
+
+            start->g_cost = 0.0;
+            start->h_cost = heuristic(start, goal);
+            res.metrics.heuristicEvaluations++;
+            openSet.push({start->f_cost(), 0.0, start});
+            recordPush(openSet.size());
+        }
+
+        Status step(size_t n, std::vector<SearchEvent>* events = nullptr) override {
+            if (events) {
+                EventObserver observer{events};
+                return run(n, observer);
+            }
+            NullObserver observer;
+            return run(n, observer);
+        }
+
+        // Expands up to n nodes, reporting to 'observer'
+        template <class Observer>
+        Status run(size_t n, Observer& observer) {
+            Profiler::PhaseClock<4> phases("search", "expand batch", ENGINE_PHASES);
+            size_t expanded = 0;
+            while (state == Status::Running && expanded < n) {
+                if (openSet.empty()) {
+                    finish(Status::NoPath, {}, observer.sink());
+                    break;
+                }
+
+                phases.mark(0);
+                Cell* current = openSet.pop().cell;
+                res.metrics.heapPops++;
+                phases.mark(1);
+                size_t currentSlot = maze.slotOf(current);
+                if (closedSet[currentSlot]) {
+                    res.metrics.stalePops++;
+                    continue;
+                }
+
+                closedSet[currentSlot] = true;
+                recordExpansion(current);
+                observer.visit(current);
+                ++expanded;
+
+                if (current == goal) {
+                    if (detail == ResultDetail::Compact) finish(Status::Found, successors.compactPath(maze, goal));
+                    else finish(Status::Found, successors.path(maze, goal), observer.sink());
+                    break;
+                }
+
+                phases.mark(2);
+                successors.forEach(maze, current, goal, [&](Cell* next, double cost) {
+                    double g = current->g_cost + cost;
+                    if (closedSet[maze.slotOf(next)]) {
+                        // Closed cells stay closed; an inconsistent heuristic only shows up here
+                        if (g < next->g_cost - 1e-9) res.metrics.reopenings++;
+                        return;
+                    }
+
+                    if (g < next->g_cost) {
+                        next->g_cost = g;
+                        next->h_cost = heuristic(next, goal);
+                        res.metrics.heuristicEvaluations++;
+                        next->parent = current;
+                        phases.mark(3);
+                        openSet.push({next->f_cost(), g, next});
+                        recordPush(openSet.size());
+                        observer.frontier(next);
+                        phases.mark(2);
+                    }
+                });
+            }
+            return state;
+        }
+
+    private:
+        Maze& maze;
+        Heuristic heuristic;
+        Successors successors;
+        OpenList openSet;
+        std::pmr::vector<bool> closedSet;
+        Cell* start = nullptr;
+        Cell* goal = nullptr;
+    };
+
+    // Timed run to completion through SearchStepper::drive. The observer is picked here,
+    // once: without a callback the engine is instantiated with NullObserver.
+    template <class EngineType>
+    AlgorithmResult solve(Maze& maze, const std::function<void(Cell*, Cell*)>& stepCallback,
+                          ResultDetail detail = ResultDetail::Full, SolveArena* arena = nullptr) {
+        PROFILE_ZONE("search", "solve");
+        EngineType engine(maze, arena);
+        engine.setDetail(detail);
+        if (stepCallback) {
+            CallbackObserver observer{stepCallback};
+            return SearchStepper::drive(engine, true, [&](size_t n) { engine.run(n, observer); });
+        }
+        NullObserver observer;
+        return SearchStepper::drive(engine, false, [&](size_t n) { engine.run(n, observer); });
+    }
+}
\ No newline at end of file
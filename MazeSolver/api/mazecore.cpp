@@ -0,0 +1,213 @@
+#include "mazecore.h"
+#include "../core/Landmarks.h"
+#include "../core/Maze.h"
+#include "../core/MazeFile.h"
+#include "../core/MovingAI.h"
+#include "../core/SolveArena.h"
+#include "../core/Utility.h"
+#include "../algorithms/Dijkstra.h"
+#include "../algorithms/AStar.h"
+#include "../algorithms/DoubleAStar.h"
+#include "../algorithms/JumpPointSearch.h"
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+// The handle: one maze plus the scratch memory its queries reuse
+struct mazecore_maze {
+    Maze maze;
+    SolveArena arena;
+
+    explicit mazecore_maze(Maze&& source) : maze(std::move(source)) {}
+};
+
+namespace {
+    thread_local std::string lastError;
+
+    mazecore_status fail(mazecore_status status, std::string detail) {
+        lastError = std::move(detail);
+        return status;
+    }
+
+    // Cell indices are 32-bit (CompactPath, paths handed back), so the area must fit
+    bool validSize(int32_t width, int32_t height, int32_t minimum) {
+        return width >= minimum && height >= minimum &&
+               static_cast<int64_t>(width) * height < static_cast<int64_t>(UINT32_MAX);
+    }
+
+    // Every entry point funnels through here: no exception may cross into C
+    template <class Body>
+    mazecore_status guarded(Body&& body) {
+        try {
+            lastError.clear();
+            return body();
+        } catch (const std::bad_alloc&) {
+            return fail(MAZECORE_OUT_OF_MEMORY, "out of memory");
+        } catch (const std::exception& e) {
+            return fail(MAZECORE_INTERNAL_ERROR, e.what());
+        } catch (...) {
+            return fail(MAZECORE_INTERNAL_ERROR, "unknown exception");
+        }
+    }
+
+    mazecore_status install(Maze&& maze, mazecore_maze** out) {
+        *out = new mazecore_maze(std::move(maze));
+        return MAZECORE_OK;
+    }
+}
+
+uint32_t mazecore_api_version(void) {
+    return MAZECORE_API_VERSION;
+}
+
+const char* mazecore_status_string(mazecore_status status) {
+    switch (status) {
+        case MAZECORE_OK: return "ok";
+        case MAZECORE_NO_PATH: return "no path";
+        case MAZECORE_BUFFER_TOO_SMALL: return "path buffer too small";
+        case MAZECORE_INVALID_ARGUMENT: return "invalid argument";
+        case MAZECORE_IO_ERROR: return "i/o error";
+        case MAZECORE_TIMED_OUT: return "timed out";
+        case MAZECORE_OUT_OF_MEMORY: return "out of memory";
+        case MAZECORE_INTERNAL_ERROR: return "internal error";
+    }
+    return "unknown status";
+}
+
+const char* mazecore_last_error(void) {
+    return lastError.c_str();
+}
+
+mazecore_status mazecore_create(int32_t width, int32_t height, const mazecore_generator_options* options,
+                                mazecore_maze** out) {
+    return guarded([&] {
+        if (!out) return fail(MAZECORE_INVALID_ARGUMENT, "out is null");
+        *out = nullptr;
+        if (!validSize(width, height, 5)) return fail(MAZECORE_INVALID_ARGUMENT, "width and height must be at least 5");
+        GeneratorOptions opts;
+        if (options) {
+            opts.braidFraction = std::min<uint32_t>(options->braid_percent, 100) / 100.0;
+            opts.roomCount = static_cast<int>(std::min<uint32_t>(options->room_count, 100000));
+            if (options->max_room_size > 0) opts.maxRoomSize = static_cast<int>(std::min<uint32_t>(options->max_room_size, 1000));
+            opts.obstacleDensity = std::min<uint32_t>(options->obstacle_percent, 100) / 100.0;
+            opts.seed = options->seed;
+        }
+        return install(Maze(width, height, opts), out);
+    });
+}
+
+mazecore_status mazecore_create_from_walls(int32_t width, int32_t height, const uint8_t* walls, mazecore_maze** out) {
+    return guarded([&] {
+        if (!out) return fail(MAZECORE_INVALID_ARGUMENT, "out is null");
+        *out = nullptr;
+        if (!walls) return fail(MAZECORE_INVALID_ARGUMENT, "walls is null");
+        if (!validSize(width, height, 1)) return fail(MAZECORE_INVALID_ARGUMENT, "width and height must be positive");
+        const size_t count = static_cast<size_t>(width) * height;
+        std::vector<bool> grid(count);
+        for (size_t i = 0; i < count; ++i) grid[i] = walls[i] != 0;
+        return install(Maze(width, height, grid), out);
+    });
+}
+
+mazecore_status mazecore_load(const char* path, mazecore_maze** out) {
+    return guarded([&] {
+        if (!out) return fail(MAZECORE_INVALID_ARGUMENT, "out is null");
+        *out = nullptr;
+        if (!path) return fail(MAZECORE_INVALID_ARGUMENT, "path is null");
+        std::string file(path);
+        std::string error;
+        if (file.size() >= 4 && file.compare(file.size() - 4, 4, ".map") == 0) {
+            Maze maze(5, 5);
+            if (!MovingAI::loadMap(file, maze, error)) return fail(MAZECORE_IO_ERROR, error);
+            return install(std::move(maze), out);
+        }
+        std::shared_ptr<MappedMaze> mapped = MappedMaze::open(file, error);
+        if (!mapped) return fail(MAZECORE_IO_ERROR, error);
+        return install(Maze(mapped), out);
+    });
+}
+
+void mazecore_free(mazecore_maze* maze) {
+    delete maze;
+}
+
+int32_t mazecore_width(const mazecore_maze* maze) {
+    return maze ? maze->maze.getWidth() : 0;
+}
+
+int32_t mazecore_height(const mazecore_maze* maze) {
+    return maze ? maze->maze.getHeight() : 0;
+}
+
+int mazecore_is_wall(const mazecore_maze* maze, int32_t x, int32_t y) {
+    return maze && maze->maze.isWalkable(x, y) ? 0 : 1;
+}
+
+mazecore_status mazecore_set_movement(mazecore_maze* maze, mazecore_movement movement) {
+    return guarded([&] {
+        if (!maze) return fail(MAZECORE_INVALID_ARGUMENT, "maze is null");
+        if (movement != MAZECORE_FOUR_WAY && movement != MAZECORE_EIGHT_WAY) {
+            return fail(MAZECORE_INVALID_ARGUMENT, "movement must be MAZECORE_FOUR_WAY or MAZECORE_EIGHT_WAY");
+        }
+        maze->maze.setMovementMode(movement == MAZECORE_EIGHT_WAY ? MovementMode::EightWay : MovementMode::FourWay);
+        return MAZECORE_OK;
+    });
+}
+
+mazecore_status mazecore_build_landmarks(mazecore_maze* maze, int32_t count) {
+    return guarded([&] {
+        if (!maze) return fail(MAZECORE_INVALID_ARGUMENT, "maze is null");
+        if (count < 1 || count > 16) return fail(MAZECORE_INVALID_ARGUMENT, "landmark count must be 1-16");
+        maze->maze.setLandmarks(LandmarkTable::build(maze->maze, count));
+        return MAZECORE_OK;
+    });
+}
+
+mazecore_status mazecore_query(mazecore_maze* maze, mazecore_algorithm algorithm, int32_t sx, int32_t sy,
+                               int32_t gx, int32_t gy, uint32_t* path, size_t capacity, mazecore_result* result) {
+    return guarded([&] {
+        if (result) std::memset(result, 0, sizeof(*result));
+        if (!maze) return fail(MAZECORE_INVALID_ARGUMENT, "maze is null");
+        if (!path && capacity > 0) return fail(MAZECORE_INVALID_ARGUMENT, "path is null but capacity is not 0");
+        Maze& m = maze->maze;
+        if (!m.isWalkable(sx, sy) || !m.isWalkable(gx, gy)) {
+            return fail(MAZECORE_INVALID_ARGUMENT, "start or goal is outside the maze or a wall");
+        }
+        m.setEndpoints(sx, sy, gx, gy);
+
+        // Compact detail: the path stays packed until it is copied out below
+        AlgorithmResult found;
+        switch (algorithm) {
+            case MAZECORE_DIJKSTRA: found = Dijkstra::solve(m, nullptr, ResultDetail::Compact, &maze->arena); break;
+            case MAZECORE_ASTAR: found = AStar::solve(m, nullptr, ResultDetail::Compact, &maze->arena); break;
+            case MAZECORE_BIDIRECTIONAL_ASTAR: found = DoubleAStar::solve(m, nullptr, ResultDetail::Compact, &maze->arena); break;
+            case MAZECORE_JUMP_POINT_SEARCH: found = JumpPointSearch::solve(m, nullptr, ResultDetail::Compact, &maze->arena); break;
+            default: return fail(MAZECORE_INVALID_ARGUMENT, "unknown algorithm");
+        }
+
+        if (result) {
+            result->nodes_explored = found.metrics.nodesExplored;
+            result->heap_pushes = found.metrics.heapPushes;
+            result->peak_open_size = found.metrics.peakOpenSize;
+            result->time_us = found.metrics.timeTakenMs;
+        }
+        if (!found.success) {
+            if (found.failure == FailureReason::TimedOut) return fail(MAZECORE_TIMED_OUT, "search timed out");
+            return fail(MAZECORE_NO_PATH, Utility::failureName(found.failure));
+        }
+        if (result) {
+            result->cost = found.metrics.pathCost;
+            result->path_length = found.route.size();
+        }
+        if (found.route.size() > capacity) {
+            if (!path) return MAZECORE_OK;     // Only the result was asked for
+            return fail(MAZECORE_BUFFER_TOO_SMALL, "path needs " + std::to_string(found.route.size()) + " cells");
+        }
+        size_t i = 0;
+        found.route.forEachIndex([&](uint32_t index) { path[i++] = index; });
+        return MAZECORE_OK;
+    });
+}
\ No newline at end of file
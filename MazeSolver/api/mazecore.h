@@ -0,0 +1,126 @@
+#pragma once
+
+/*
+ * mazecore: the maze generator and solvers behind a small C API, for embedding in
+ * other processes (link the mazecore library; no Qt, no iostreams on the query path).
+ *
+ *   mazecore_maze* maze;
+ *   if (mazecore_create(1001, 1001, NULL, &maze) != MAZECORE_OK) ...
+ *   uint32_t cells[4096];
+ *   mazecore_result result;
+ *   mazecore_status s = mazecore_query(maze, MAZECORE_ASTAR, 1, 1, 999, 999, cells, 4096, &result);
+ *   ...
+ *   mazecore_free(maze);
+ *
+ * Paths are written as row-major cell indices (y * width + x), start and goal included.
+ * A handle keeps its own solver scratch memory, so repeat queries on it stop allocating
+ * once it has grown to fit. Handles are independent, but one handle serves one query at
+ * a time. Functions never throw; failures come back as a status, with a description
+ * from mazecore_last_error() on the calling thread.
+ *
+ * Compatibility: functions and enum values are only ever added. Structs keep their
+ * layout; their reserved fields must be zero and may gain meaning in later versions.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32) && defined(MAZECORE_SHARED)
+#  ifdef MAZECORE_BUILD
+#    define MAZECORE_API __declspec(dllexport)
+#  else
+#    define MAZECORE_API __declspec(dllimport)
+#  endif
+#elif defined(__GNUC__)
+#  define MAZECORE_API __attribute__((visibility("default")))
+#else
+#  define MAZECORE_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MAZECORE_API_VERSION 1
+
+typedef struct mazecore_maze mazecore_maze;
+
+typedef enum mazecore_status {
+    MAZECORE_OK = 0,
+    MAZECORE_NO_PATH = 1,             /* Searched; start and goal are not connected */
+    MAZECORE_BUFFER_TOO_SMALL = 2,    /* Path found; result->path_length is the capacity needed */
+    MAZECORE_INVALID_ARGUMENT = 3,    /* Null handle, endpoint outside the maze or on a wall, ... */
+    MAZECORE_IO_ERROR = 4,
+    MAZECORE_TIMED_OUT = 5,
+    MAZECORE_OUT_OF_MEMORY = 6,
+    MAZECORE_INTERNAL_ERROR = 7
+} mazecore_status;
+
+typedef enum mazecore_algorithm {
+    MAZECORE_DIJKSTRA = 0,
+    MAZECORE_ASTAR = 1,
+    MAZECORE_BIDIRECTIONAL_ASTAR = 2,
+    MAZECORE_JUMP_POINT_SEARCH = 3
+} mazecore_algorithm;
+
+typedef enum mazecore_movement {
+    MAZECORE_FOUR_WAY = 4,
+    MAZECORE_EIGHT_WAY = 8            /* Diagonals cost sqrt(2), no corner cutting */
+} mazecore_movement;
+
+/* Post-processing on top of the recursive backtracker; all zero is a perfect maze */
+typedef struct mazecore_generator_options {
+    uint32_t braid_percent;           /* Dead ends knocked through into loops, 0-100 */
+    uint32_t room_count;
+    uint32_t max_room_size;           /* 0 = default (9) */
+    uint32_t obstacle_percent;        /* 0-100 */
+    uint32_t seed;                    /* 0 = seed from the clock */
+    uint32_t reserved[3];
+} mazecore_generator_options;
+
+typedef struct mazecore_result {
+    double cost;                      /* Sum of step costs */
+    uint64_t path_length;             /* Cells on the path; 0 without one */
+    uint64_t nodes_explored;
+    uint64_t heap_pushes;
+    uint64_t peak_open_size;
+    int64_t time_us;                  /* Search time, without the copy into the caller's buffer */
+    uint64_t reserved[4];
+} mazecore_result;
+
+MAZECORE_API uint32_t mazecore_api_version(void);
+MAZECORE_API const char* mazecore_status_string(mazecore_status status);
+/* Why the last mazecore_status call on this thread failed; "" after a success */
+MAZECORE_API const char* mazecore_last_error(void);
+
+/* Generates a width x height maze (even sizes are rounded up to odd). 'options' may be NULL. */
+MAZECORE_API mazecore_status mazecore_create(int32_t width, int32_t height,
+                                             const mazecore_generator_options* options, mazecore_maze** out);
+/* Takes the walls as given: width * height bytes, row-major, nonzero = wall */
+MAZECORE_API mazecore_status mazecore_create_from_walls(int32_t width, int32_t height, const uint8_t* walls,
+                                                        mazecore_maze** out);
+/* A maze file written by the MazeSolver tools (memory-mapped) or a MovingAI .map
+   (8-connected unless changed with mazecore_set_movement) */
+MAZECORE_API mazecore_status mazecore_load(const char* path, mazecore_maze** out);
+/* NULL is ignored */
+MAZECORE_API void mazecore_free(mazecore_maze* maze);
+
+MAZECORE_API int32_t mazecore_width(const mazecore_maze* maze);
+MAZECORE_API int32_t mazecore_height(const mazecore_maze* maze);
+/* 1 for a wall or a cell outside the maze */
+MAZECORE_API int mazecore_is_wall(const mazecore_maze* maze, int32_t x, int32_t y);
+
+MAZECORE_API mazecore_status mazecore_set_movement(mazecore_maze* maze, mazecore_movement movement);
+/* ALT landmarks (1-16) for A* and bidirectional A*: a tighter heuristic for repeated
+   queries, at 4 bytes per cell per landmark. Rebuild after changing the movement mode. */
+MAZECORE_API mazecore_status mazecore_build_landmarks(mazecore_maze* maze, int32_t count);
+
+/* Shortest path from (sx, sy) to (gx, gy). 'path' may be NULL (capacity 0) when only the
+   result is wanted. 'result' may be NULL. */
+MAZECORE_API mazecore_status mazecore_query(mazecore_maze* maze, mazecore_algorithm algorithm,
+                                            int32_t sx, int32_t sy, int32_t gx, int32_t gy,
+                                            uint32_t* path, size_t capacity, mazecore_result* result);
+
+#ifdef __cplusplus
+}
+#endif
\ No newline at end of file
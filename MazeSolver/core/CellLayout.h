@@ -0,0 +1,103 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Storage order of a Maze's cells.
+//   RowMajor  y * width + x. A vertical step jumps a whole row ahead in memory.
+//   Tiled     8x8 tiles laid out row by row, row-major inside a tile: the 8 neighbours
+//             of most cells share its tile (64 cells, a few cache lines).
+//   Morton    Z-order curve inside square power-of-two blocks, blocks laid out row by
+//             row: nearby cells are nearby in memory at every scale up to the block.
+//             The block is the largest that pads the grid by at most 1/8 (at least
+//             8x8), so a 1025x1025 grid doesn't become 2048x2048.
+enum class CellOrder { RowMajor, Tiled, Morton };
+
+// Maps (x, y) to a storage slot. Tiled and Morton pad the grid to whole tiles or blocks;
+// padding slots hold walls nobody reads.
+class CellLayout {
+public:
+    CellLayout() = default;
+    CellLayout(CellOrder order, int width, int height) : kind(order), width(width) {
+        switch (order) {
+            case CellOrder::RowMajor:
+                slots = static_cast<size_t>(width) * height;
+                break;
+            case CellOrder::Tiled:
+                tilesPerRow = (width + TILE - 1) / TILE;
+                slots = static_cast<size_t>(tilesPerRow) * ((height + TILE - 1) / TILE) * TILE * TILE;
+                break;
+            case CellOrder::Morton: {
+                const size_t cells = static_cast<size_t>(width) * height;
+                int largest = bitsFor(width < height ? width : height);
+                blockBits = TILE_BITS;
+                for (int bits = largest; bits > TILE_BITS; --bits) {
+                    if (paddedSize(width, height, bits) <= cells + cells / 8) {
+                        blockBits = bits;
+                        break;
+                    }
+                }
+                tilesPerRow = (width + (1 << blockBits) - 1) >> blockBits;
+                slots = paddedSize(width, height, blockBits);
+                break;
+            }
+        }
+    }
+
+    CellOrder order() const { return kind; }
+    size_t size() const { return slots; }
+
+    size_t slot(int x, int y) const {
+        switch (kind) {
+            case CellOrder::Tiled:
+                return ((static_cast<size_t>(y >> TILE_BITS) * tilesPerRow + (x >> TILE_BITS)) << (2 * TILE_BITS)) |
+                       ((y & (TILE - 1)) << TILE_BITS) | (x & (TILE - 1));
+            case CellOrder::Morton: {
+                uint32_t mask = (uint32_t(1) << blockBits) - 1;
+                size_t block = static_cast<size_t>(y >> blockBits) * tilesPerRow + (x >> blockBits);
+                return (block << (2 * blockBits)) | spread(x & mask) | (spread(y & mask) << 1);
+            }
+            default:
+                return static_cast<size_t>(y) * width + x;
+        }
+    }
+
+    static const char* name(CellOrder order) {
+        switch (order) {
+            case CellOrder::Tiled: return "Tiled 8x8";
+            case CellOrder::Morton: return "Morton";
+            default: return "Row-major";
+        }
+    }
+
+private:
+    static constexpr int TILE_BITS = 3;
+    static constexpr int TILE = 1 << TILE_BITS;
+
+    CellOrder kind = CellOrder::RowMajor;
+    int width = 0;
+    size_t slots = 0;
+    int tilesPerRow = 0;    // Tiled tiles, or Morton blocks
+    int blockBits = 0;      // Morton: log2 of the block side
+
+    static int bitsFor(int n) {
+        int bits = 0;
+        while ((1 << bits) < n) ++bits;
+        return bits;
+    }
+
+    // Slots for whole 2^bits x 2^bits blocks covering the grid
+    static size_t paddedSize(int width, int height, int bits) {
+        size_t side = size_t(1) << bits;
+        return ((width + side - 1) >> bits) * ((height + side - 1) >> bits) * side * side;
+    }
+
+    // Spreads the low 32 bits of v to the even bit positions
+    static uint64_t spread(uint64_t v) {
+        v = (v | (v << 16)) & 0x0000FFFF0000FFFFull;
+        v = (v | (v << 8)) & 0x00FF00FF00FF00FFull;
+        v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0Full;
+        v = (v | (v << 2)) & 0x3333333333333333ull;
+        v = (v | (v << 1)) & 0x5555555555555555ull;
+        return v;
+    }
+};
\ No newline at end of file
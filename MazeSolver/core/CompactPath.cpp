@@ -0,0 +1,77 @@
+#include "CompactPath.h"
+#include "Maze.h"
+#include "Utility.h"
+
+const int CompactPath::DX[8] = {0, 0, 1, -1, 1, 1, -1, -1};
+const int CompactPath::DY[8] = {1, -1, 0, 0, 1, -1, 1, -1};
+
+CompactPath::CompactPath(uint32_t start, int width, MovementMode mode)
+    : start(start), width(width), bits(mode == MovementMode::EightWay ? 4 : 2) {}
+
+int CompactPath::code(int dx, int dy) {
+    int c = 0;
+    while (c < 8 && (DX[c] != dx || DY[c] != dy)) ++c;
+    return c;
+}
+
+void CompactPath::push(int dx, int dy) {
+    if (moves * bits % 8 == 0) codes.push_back(0);
+    moves++;
+    set(moves - 1, dx, dy);
+}
+
+void CompactPath::resize(size_t count) {
+    moves = count;
+    codes.assign((count * bits + 7) / 8, 0);
+}
+
+void CompactPath::set(size_t i, int dx, int dy) {
+    size_t bit = i * bits;
+    uint8_t mask = static_cast<uint8_t>(((1 << bits) - 1) << (bit % 8));
+    codes[bit / 8] = static_cast<uint8_t>((codes[bit / 8] & ~mask) | (code(dx, dy) << (bit % 8)));
+}
+
+CompactPath CompactPath::reversed() const {
+    if (empty()) return *this;
+    CompactPath back(endIndex(), width, bits == 4 ? MovementMode::EightWay : MovementMode::FourWay);
+    back.resize(moves);
+    for (size_t i = 0; i < moves; ++i) back.set(moves - 1 - i, -DX[move(i)], -DY[move(i)]);
+    return back;
+}
+
+uint32_t CompactPath::endIndex() const {
+    uint32_t last = start;
+    forEachIndex([&](uint32_t i) { last = i; });
+    return last;
+}
+
+double CompactPath::cost() const {
+    size_t diagonals = 0;
+    for (size_t i = 0; i < moves; ++i) diagonals += move(i) >= 4;
+    return (moves - diagonals) + diagonals * Utility::SQRT2;
+}
+
+std::vector<uint32_t> CompactPath::indices() const {
+    std::vector<uint32_t> out;
+    out.reserve(size());
+    forEachIndex([&](uint32_t i) { out.push_back(i); });
+    return out;
+}
+
+std::vector<Cell*> CompactPath::cells(Maze& maze) const {
+    std::vector<Cell*> out;
+    out.reserve(size());
+    forEachIndex([&](uint32_t i) { out.push_back(maze.cellAt(i)); });
+    return out;
+}
+
+CompactPath CompactPath::fromCells(const std::vector<Cell*>& path, const Maze& maze) {
+    if (path.empty()) return CompactPath();
+    const int width = maze.getWidth();
+    CompactPath compact(static_cast<uint32_t>(path[0]->y * width + path[0]->x), width, maze.getMovementMode());
+    compact.resize(path.size() - 1);
+    for (size_t i = 1; i < path.size(); ++i) {
+        compact.set(i - 1, path[i]->x - path[i-1]->x, path[i]->y - path[i-1]->y);
+    }
+    return compact;
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+struct Cell;
+class Maze;
+enum class MovementMode;
+
+// A path as its start cell index plus one move code per step, packed into bytes.
+// 4-connected paths use 2 bits per move; 8-connected ones need 8 codes and use a nibble.
+// Codes follow the neighbour order of the solvers: down, up, right, left, then the diagonals.
+// Cells are only materialised on demand (cells(), indices(), forEachIndex()).
+class CompactPath {
+public:
+    static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+    CompactPath() = default;
+    CompactPath(uint32_t start, int width, MovementMode mode);
+
+    // Appends one step; (dx, dy) must be a unit move the movement mode allows
+    void push(int dx, int dy);
+    // For filling in a known number of moves out of order: resize once, then set each
+    void resize(size_t count);
+    void set(size_t i, int dx, int dy);
+    // Same path walked the other way
+    CompactPath reversed() const;
+
+    bool empty() const { return start == NONE; }
+    // Cells on the path, start and end included
+    size_t size() const { return empty() ? 0 : moves + 1; }
+    uint32_t startIndex() const { return start; }
+    uint32_t endIndex() const;
+    int getWidth() const { return width; }
+    int move(size_t i) const { return (codes[i * bits / 8] >> (i * bits % 8)) & ((1 << bits) - 1); }
+    double cost() const;
+    size_t memoryBytes() const { return codes.capacity() + sizeof(*this); }
+
+    // visit(index) for every cell from start to end
+    template <class Visit>
+    void forEachIndex(Visit&& visit) const {
+        if (empty()) return;
+        int64_t index = start;
+        visit(static_cast<uint32_t>(index));
+        for (size_t i = 0; i < moves; ++i) {
+            int code = move(i);
+            index += static_cast<int64_t>(DY[code]) * width + DX[code];
+            visit(static_cast<uint32_t>(index));
+        }
+    }
+    std::vector<uint32_t> indices() const;
+    std::vector<Cell*> cells(Maze& maze) const;
+
+    static CompactPath fromCells(const std::vector<Cell*>& path, const Maze& maze);
+
+    static const int DX[8];
+    static const int DY[8];
+
+private:
+    static int code(int dx, int dy);
+
+    uint32_t start = NONE;
+    int width = 0;
+    int bits = 2;
+    size_t moves = 0;
+    std::vector<uint8_t> codes;
+};
\ No newline at end of file
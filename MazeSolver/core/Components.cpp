@@ -0,0 +1,133 @@
+#include "Components.h"
+#include "Maze.h"
+#include "Profiler.h"
+#include <deque>
+#include <unordered_set>
+#include <utility>
+
+void ComponentIndex::build(const Maze& maze) {
+    PROFILE_ZONE("maze", "index components");
+    width = maze.getWidth();
+    height = maze.getHeight();
+    parent.assign(static_cast<size_t>(width) * height, NONE);
+    count = 0;
+    
+    // Raster pass: each open cell joins its left and upper neighbours
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            if (!maze.isWalkable(x, y)) continue;
+            uint32_t i = static_cast<uint32_t>(index(x, y));
+            parent[i] = i;
+            count++;
+            if (x > 0 && parent[i - 1] != NONE && unite(i, i - 1)) count--;
+            if (y > 0 && parent[i - width] != NONE && unite(i, i - width)) count--;
+        }
+    }
+    
+    // Parents always precede their children, so one forward pass flattens every tree
+    for (size_t i = 0; i < parent.size(); ++i) {
+        if (parent[i] != NONE) parent[i] = parent[parent[i]];
+    }
+    stale = false;
+}
+
+uint32_t ComponentIndex::find(uint32_t i) {
+    // Path halving
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+bool ComponentIndex::unite(uint32_t a, uint32_t b) {
+    a = find(a);
+    b = find(b);
+    if (a == b) return false;
+    if (a < b) std::swap(a, b);
+    parent[a] = b;
+    return true;
+}
+
+bool ComponentIndex::connected(const Maze& maze, size_t a, size_t b) {
+    refresh(maze);
+    // A closed-over wall keeps its place in the forest, so walls are asked of the maze
+    if (!maze.isWalkable(static_cast<int>(a % width), static_cast<int>(a / width)) ||
+        !maze.isWalkable(static_cast<int>(b % width), static_cast<int>(b / width))) return false;
+    return find(static_cast<uint32_t>(a)) == find(static_cast<uint32_t>(b));
+}
+
+void ComponentIndex::cellOpened(const Maze& maze, int x, int y) {
+    if (stale) return;
+    uint32_t i = static_cast<uint32_t>(index(x, y));
+    if (parent[i] != NONE) {
+        // Closed over earlier: its set may be one nothing open belongs to any more
+        stale = true;
+        return;
+    }
+    parent[i] = i;
+    count++;
+    
+    static const int dx[] = {0, 0, 1, -1};
+    static const int dy[] = {1, -1, 0, 0};
+    for (int d = 0; d < 4; ++d) {
+        if (!maze.isWalkable(x + dx[d], y + dy[d])) continue;
+        if (unite(i, static_cast<uint32_t>(index(x + dx[d], y + dy[d])))) count--;
+    }
+}
+
+void ComponentIndex::cellClosed(const Maze& maze, int x, int y) {
+    if (stale) return;
+    uint32_t i = static_cast<uint32_t>(index(x, y));
+    if (parent[i] == NONE) return;
+    
+    bool isolated = true;
+    static const int dx[] = {0, 0, 1, -1};
+    static const int dy[] = {1, -1, 0, 0};
+    for (int d = 0; d < 4 && isolated; ++d) {
+        if (maze.isWalkable(x + dx[d], y + dy[d])) isolated = false;
+    }
+    if (isolated) {
+        // A component of its own disappears. Drop a root in place; anything still
+        // pointing at it is a closed-over wall, which is never looked up again.
+        if (parent[i] == i) parent[i] = NONE;
+        count--;
+        return;
+    }
+    if (!stillConnected(maze, x, y)) stale = true;
+}
+
+bool ComponentIndex::stillConnected(const Maze& maze, int x, int y) const {
+    static const int dx[] = {0, 0, 1, -1};
+    static const int dy[] = {1, -1, 0, 0};
+    std::vector<size_t> targets;
+    for (int d = 0; d < 4; ++d) {
+        if (maze.isWalkable(x + dx[d], y + dy[d])) targets.push_back(index(x + dx[d], y + dy[d]));
+    }
+    if (targets.size() < 2) return true;
+    
+    // BFS from the first neighbour until it has seen the rest or spent its budget
+    std::unordered_set<size_t> seen{targets[0]};
+    std::deque<size_t> queue{targets[0]};
+    size_t missing = targets.size() - 1;
+    while (!queue.empty() && seen.size() < SPLIT_CHECK_CELLS) {
+        size_t c = queue.front();
+        queue.pop_front();
+        int cx = static_cast<int>(c % width), cy = static_cast<int>(c / width);
+        for (int d = 0; d < 4; ++d) {
+            if (!maze.isWalkable(cx + dx[d], cy + dy[d])) continue;
+            size_t n = index(cx + dx[d], cy + dy[d]);
+            if (!seen.insert(n).second) continue;
+            for (size_t t = 1; t < targets.size(); ++t) {
+                if (targets[t] == n && --missing == 0) return true;
+            }
+            queue.push_back(n);
+        }
+    }
+    return false;
+}
+
+size_t ComponentIndex::componentCount(const Maze& maze) {
+    refresh(maze);
+    return count;
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+class Maze;
+
+// Connected components of the open cells, as a union-find forest over cell indices.
+// Diagonal steps may never cut corners, so every diagonal move has an orthogonal detour:
+// 4- and 8-connected movement always give the same components.
+//
+// Opening a cell merges it into its neighbours' components in near-constant time.
+// Closing one can split a component, which union-find cannot undo. A bounded BFS from one
+// open neighbour (at most SPLIT_CHECK_CELLS cells) first looks for the others: if it
+// finds them the component held together, and the closed cell stays in the forest as a
+// wall that other cells may still point through. Otherwise - a real split, or too far
+// round to tell, as in any corridor of a perfect maze - the index is marked stale and
+// the next query relabels the whole grid. Reopening such a closed-over cell does too.
+class ComponentIndex {
+public:
+    static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();   // Wall cell
+    static constexpr size_t SPLIT_CHECK_CELLS = 1024;
+
+    // Two-pass raster labelling; afterwards every cell points straight at its root
+    void build(const Maze& maze);
+
+    // Same component (walls are in none). Rebuilds first if a wall was added since.
+    bool connected(const Maze& maze, size_t a, size_t b);
+
+    // Keeps the index in step with Maze::setWall
+    void cellOpened(const Maze& maze, int x, int y);
+    void cellClosed(const Maze& maze, int x, int y);
+
+    size_t componentCount(const Maze& maze);
+    size_t memoryBytes() const { return parent.size() * sizeof(uint32_t); }
+
+private:
+    int width = 0, height = 0;
+    std::vector<uint32_t> parent;   // Roots are the smallest index of their component; NONE or a closed-over wall for walls
+    size_t count = 0;
+    bool stale = true;
+
+    uint32_t find(uint32_t i);
+    // Links the larger root under the smaller, so parent[i] <= i always holds
+    bool unite(uint32_t a, uint32_t b);
+    void refresh(const Maze& maze) { if (stale) build(maze); }
+    // Whether the open cells around (x, y), now a wall, still reach each other
+    bool stillConnected(const Maze& maze, int x, int y) const;
+    size_t index(int x, int y) const { return static_cast<size_t>(y) * width + x; }
+};
\ No newline at end of file
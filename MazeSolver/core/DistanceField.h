@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <vector>
+
+// Unweighted single-source distances to every cell: steps in the maze's movement mode,
+// which on 4-connected grids are exactly Dijkstra's path costs
+struct DistanceField {
+    static constexpr uint32_t UNREACHED = std::numeric_limits<uint32_t>::max();
+
+    int width = 0, height = 0;
+    std::pmr::vector<uint32_t> distance;    // Row-major
+    size_t reached = 0;
+    uint32_t eccentricity = 0;          // Largest finite distance
+    uint64_t edges = 0;                 // Edges inside the reached component
+    int topDownLevels = 0;              // ParallelBFS level mix
+    int bottomUpLevels = 0;
+    unsigned threads = 1;
+    long long timeTakenUs = 0;
+
+    DistanceField() = default;
+    // 'distance' lives in 'memory' (pmr containers keep their resource on move, not on assignment)
+    explicit DistanceField(std::pmr::memory_resource* memory) : distance(memory) {}
+
+    uint32_t at(int x, int y) const { return distance[static_cast<size_t>(y) * width + x]; }
+    // Traversed edges per second
+    double edgesPerSecond() const { return timeTakenUs > 0 ? edges * 1e6 / timeTakenUs : 0.0; }
+};
\ No newline at end of file
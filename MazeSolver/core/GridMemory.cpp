@@ -0,0 +1,138 @@
+#include "GridMemory.h"
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <tuple>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    // From <linux/mempolicy.h>; spelled out so libnuma headers aren't needed
+    constexpr int MPOL_BIND_MODE = 2;
+    constexpr int MPOL_INTERLEAVE_MODE = 3;
+    
+    size_t roundUp(size_t n, size_t to) { return (n + to - 1) / to * to; }
+}
+
+std::pmr::memory_resource* GridMemory::get(const MemoryOptions& options) {
+    if (options.pages == PageMode::Default) return std::pmr::new_delete_resource();
+    
+    static std::mutex lock;
+    static std::map<std::tuple<int, int, int>, std::unique_ptr<GridMemory>> resources;
+    std::lock_guard<std::mutex> guard(lock);
+    int node = options.numa == NumaPolicy::Bind ? options.node : 0;
+    auto& slot = resources[{static_cast<int>(options.pages), static_cast<int>(options.numa), node}];
+    if (!slot) slot.reset(new GridMemory(options));
+    return slot.get();
+}
+
+MemoryOptions GridMemory::optionsOf(const std::pmr::memory_resource* resource) {
+    auto* grid = dynamic_cast<const GridMemory*>(resource);
+    return grid ? grid->opts : MemoryOptions();
+}
+
+std::string GridMemory::describe(const MemoryOptions& options) {
+    std::string text = options.pages == PageMode::Default ? "heap"
+                     : options.pages == PageMode::Transparent ? "THP" : "hugetlb";
+    if (options.pages == PageMode::Default) return text;
+    if (options.numa == NumaPolicy::Interleave) text += "+interleave";
+    if (options.numa == NumaPolicy::Bind) text += "+node" + std::to_string(options.node);
+    return text;
+}
+
+int GridMemory::numaNodes() {
+    // "0", "0-1", "0-3,8-11": the highest listed node + 1
+    std::ifstream in("/sys/devices/system/node/online");
+    std::string list;
+    if (!(in >> list)) return 1;
+    size_t cut = list.find_last_of("-,");
+    try {
+        return std::stoi(cut == std::string::npos ? list : list.substr(cut + 1)) + 1;
+    } catch (...) {
+        return 1;
+    }
+}
+
+GridMemory::Stats GridMemory::stats() const {
+    Stats s;
+    s.mappings = mappings.load();
+    s.bytesMapped = bytesMapped.load();
+    s.hugeFallbacks = hugeFallbacks.load();
+    s.policyFailures = policyFailures.load();
+    return s;
+}
+
+size_t GridMemory::mappedLength(size_t bytes) const {
+    // Whole huge pages either way, so deallocate needn't know which path was taken
+    return roundUp(bytes, HUGE_PAGE);
+}
+
+void GridMemory::applyPolicy(void* p, size_t length) {
+#ifdef __linux__
+    if (opts.numa == NumaPolicy::Local) return;
+    int nodes = numaNodes();
+    if (nodes > 64 || (opts.numa == NumaPolicy::Bind && (opts.node < 0 || opts.node >= nodes))) {
+        policyFailures++;
+        return;
+    }
+    unsigned long mask = opts.numa == NumaPolicy::Bind ? 1UL << opts.node
+                       : nodes == 64 ? ~0UL : (1UL << nodes) - 1;
+    int mode = opts.numa == NumaPolicy::Bind ? MPOL_BIND_MODE : MPOL_INTERLEAVE_MODE;
+    // Before the first touch, so every page is placed by the policy. maxnode counts one
+    // past the last bit, the kernel's off-by-one.
+    if (syscall(SYS_mbind, p, length, mode, &mask, sizeof(mask) * 8 + 1, 0) != 0) policyFailures++;
+#else
+    (void)p;
+    (void)length;
+#endif
+}
+
+void* GridMemory::do_allocate(size_t bytes, size_t alignment) {
+#ifdef __linux__
+    if (bytes >= MIN_MAPPING && alignment <= HUGE_PAGE) {
+        size_t length = mappedLength(bytes);
+        void* p = MAP_FAILED;
+        if (opts.pages == PageMode::Explicit) {
+            p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (p == MAP_FAILED) hugeFallbacks++;
+        }
+        if (p == MAP_FAILED) {
+            // Over-map by one huge page and trim, so the kernel can back it with whole huge pages
+            size_t span = length + HUGE_PAGE;
+            void* raw = mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (raw == MAP_FAILED) throw std::bad_alloc();
+            uintptr_t base = reinterpret_cast<uintptr_t>(raw);
+            uintptr_t aligned = roundUp(base, HUGE_PAGE);
+            if (aligned > base) munmap(raw, aligned - base);
+            if (aligned + length < base + span) munmap(reinterpret_cast<void*>(aligned + length), base + span - aligned - length);
+            p = reinterpret_cast<void*>(aligned);
+            madvise(p, length, MADV_HUGEPAGE);
+        }
+        applyPolicy(p, length);
+        mappings++;
+        bytesMapped += length;
+        return p;
+    }
+#endif
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void GridMemory::do_deallocate(void* p, size_t bytes, size_t alignment) {
+#ifdef __linux__
+    if (bytes >= MIN_MAPPING && alignment <= HUGE_PAGE) {
+        size_t length = mappedLength(bytes);
+        munmap(p, length);
+        mappings--;
+        bytesMapped -= length;
+        return;
+    }
+#endif
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+}
\ No newline at end of file
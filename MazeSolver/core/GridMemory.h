@@ -0,0 +1,65 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+
+// Page backing for the big per-cell arrays: maze cells and solver arena blocks.
+enum class PageMode {
+    Default,        // operator new; whatever malloc and the kernel decide
+    Transparent,    // mmap, 2 MB aligned, madvise(MADV_HUGEPAGE)
+    Explicit        // mmap(MAP_HUGETLB) from the reserved pool, Transparent when it is empty
+};
+
+// Node placement for mapped memory (Linux mbind). Ignored with PageMode::Default.
+enum class NumaPolicy {
+    Local,          // First touch: pages land on the node of the thread that writes them
+    Interleave,     // Round-robin over all online nodes
+    Bind            // Everything on 'node'
+};
+
+struct MemoryOptions {
+    PageMode pages = PageMode::Default;
+    NumaPolicy numa = NumaPolicy::Local;
+    int node = 0;
+};
+
+// mmap-backed memory resource. Requests under MIN_MAPPING go to the heap, since a
+// mapping per small vector costs more than the TLB misses it saves. Outside Linux every
+// request goes to the heap and the options only change what stats() reports.
+class GridMemory : public std::pmr::memory_resource {
+public:
+    static constexpr size_t MIN_MAPPING = 256 * 1024;
+    static constexpr size_t HUGE_PAGE = 2 * 1024 * 1024;
+
+    struct Stats {
+        size_t mappings = 0;        // Live mappings
+        size_t bytesMapped = 0;     // Their total length
+        size_t hugeFallbacks = 0;   // Explicit requests served by Transparent instead
+        size_t policyFailures = 0;  // mbind calls the kernel refused
+    };
+
+    // One resource per option set, alive for the whole process, so a container never
+    // outlives its memory. Default options give std::pmr::new_delete_resource().
+    static std::pmr::memory_resource* get(const MemoryOptions& options);
+    // Options behind a resource; defaults for anything that is not a GridMemory
+    static MemoryOptions optionsOf(const std::pmr::memory_resource* resource);
+    static std::string describe(const MemoryOptions& options);
+    // Online NUMA nodes, 1 when the system doesn't say
+    static int numaNodes();
+
+    const MemoryOptions& options() const { return opts; }
+    Stats stats() const;
+
+private:
+    MemoryOptions opts;
+    std::atomic<size_t> mappings{0}, bytesMapped{0}, hugeFallbacks{0}, policyFailures{0};
+
+    explicit GridMemory(const MemoryOptions& options) : opts(options) {}
+    size_t mappedLength(size_t bytes) const;
+    void applyPolicy(void* p, size_t length);
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
\ No newline at end of file
@@ -0,0 +1,24 @@
+#pragma once
+
+// CPU event counter for the calling thread (Linux perf_event_open, user mode only).
+// available() is false where the kernel, a container or a VM without a PMU refuses it;
+// stop() then returns -1 so callers can print "n/a" instead of a bogus zero.
+class HardwareCounter {
+public:
+    enum class Event {
+        DtlbLoadMisses      // Data TLB misses on loads
+    };
+
+    explicit HardwareCounter(Event event);
+    ~HardwareCounter();
+    HardwareCounter(const HardwareCounter&) = delete;
+    HardwareCounter& operator=(const HardwareCounter&) = delete;
+
+    bool available() const { return fd >= 0; }
+    void start();
+    // Events since start()
+    long long stop();
+
+private:
+    int fd = -1;
+};
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include "Landmarks.h"
+#include "Maze.h"
+#include "Utility.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+void LandmarkTable::distancesFrom(const Maze& maze, size_t source, std::vector<float>& out) {
+    const int w = maze.getWidth();
+    out.assign(static_cast<size_t>(w) * maze.getHeight(), UNREACHABLE);
+    out[source] = 0.0f;
+
+    const int dx[] = {0, 0, 1, -1, 1, 1, -1, -1};
+    const int dy[] = {1, -1, 0, 0, 1, -1, 1, -1};
+
+    if (maze.getMovementMode() == MovementMode::FourWay) {
+        std::queue<size_t> frontier;
+        frontier.push(source);
+        while (!frontier.empty()) {
+            size_t v = frontier.front();
+            frontier.pop();
+            int x = static_cast<int>(v % w), y = static_cast<int>(v / w);
+            for (int i = 0; i < 4; ++i) {
+                if (!maze.canStep(x, y, dx[i], dy[i])) continue;
+                size_t n = v + dy[i] * w + dx[i];
+                if (out[n] != UNREACHABLE) continue;
+                out[n] = out[v] + 1.0f;
+                frontier.push(n);
+            }
+        }
+        return;
+    }
+
+    // Accumulate in double and round once, so stored distances are as exact as a float allows
+    typedef std::pair<double, size_t> QueueEntry;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> open;
+    std::vector<double> dist(out.size(), std::numeric_limits<double>::infinity());
+    dist[source] = 0.0;
+    open.push({0.0, source});
+    while (!open.empty()) {
+        auto [d, v] = open.top();
+        open.pop();
+        if (d > dist[v]) continue;
+        out[v] = static_cast<float>(d);
+        int x = static_cast<int>(v % w), y = static_cast<int>(v / w);
+        for (int i = 0; i < 8; ++i) {
+            if (!maze.canStep(x, y, dx[i], dy[i])) continue;
+            size_t n = v + dy[i] * w + dx[i];
+            double nd = d + (i < 4 ? 1.0 : Utility::SQRT2);
+            if (nd < dist[n]) {
+                dist[n] = nd;
+                open.push({nd, n});
+            }
+        }
+    }
+}
+
+std::shared_ptr<LandmarkTable> LandmarkTable::build(const Maze& maze, int k) {
+    PROFILE_ZONE("landmarks", "build");
+    auto table = std::make_shared<LandmarkTable>();
+    table->width = maze.getWidth();
+    table->height = maze.getHeight();
+    table->movement = maze.getMovementMode();
+    table->cellCount = static_cast<size_t>(table->width) * table->height;
+
+    // Seed the farthest-point walk from the first open cell
+    size_t seedCell = table->cellCount;
+    for (size_t v = 0; v < table->cellCount && seedCell == table->cellCount; ++v) {
+        if (maze.isWalkable(static_cast<int>(v % table->width), static_cast<int>(v / table->width))) seedCell = v;
+    }
+    if (k <= 0 || seedCell == table->cellCount) return table;
+
+    std::vector<float> pass;
+    distancesFrom(maze, seedCell, pass);
+    // Distance from each cell to its nearest chosen landmark (the seed stands in for none)
+    std::vector<float> nearest = pass;
+
+    // Written with stride k as we go; compacted below if fewer landmarks were found
+    table->distances.assign(table->cellCount * k, UNREACHABLE);
+    int found = 0;
+    for (int i = 0; i < k; ++i) {
+        size_t best = table->cellCount;
+        float bestDist = -1.0f;
+        for (size_t v = 0; v < table->cellCount; ++v) {
+            if (nearest[v] != UNREACHABLE && nearest[v] > bestDist) {
+                bestDist = nearest[v];
+                best = v;
+            }
+        }
+        // Every reachable cell already is a landmark
+        if (best == table->cellCount || bestDist <= 0.0f) break;
+
+        distancesFrom(maze, best, pass);
+        for (size_t v = 0; v < table->cellCount; ++v) nearest[v] = std::min(nearest[v], pass[v]);
+        for (size_t v = 0; v < table->cellCount; ++v) table->distances[v * k + i] = pass[v];
+        table->landmarks.push_back(best);
+        ++found;
+    }
+
+    if (found < k) {
+        for (size_t v = 0; v < table->cellCount; ++v) {
+            for (int l = 0; l < found; ++l) table->distances[v * found + l] = table->distances[v * k + l];
+        }
+        table->distances.resize(table->cellCount * found);
+        table->distances.shrink_to_fit();
+    }
+    table->k = found;
+    return table;
+}
+
+double LandmarkTable::lowerBound(size_t a, size_t b) const {
+    const float* da = distances.data() + a * k;
+    const float* db = distances.data() + b * k;
+    float best = 0.0f;
+    for (int l = 0; l < k; ++l) {
+        // A landmark in another component says nothing useful
+        if (da[l] == UNREACHABLE || db[l] == UNREACHABLE) continue;
+        best = std::max(best, std::fabs(da[l] - db[l]));
+    }
+    // Shave a hair off so float rounding of octile distances can never overestimate
+    return best * (1.0 - 1e-6);
+}
+
+bool LandmarkTable::matches(const Maze& maze) const {
+    return width == maze.getWidth() && height == maze.getHeight() && movement == maze.getMovementMode();
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "Types.h"
+
+class Maze;
+
+// ALT preprocessing (A*, Landmarks, Triangle inequality).
+// For k landmarks L, stores the exact shortest-path distance d(L, v) to every cell v.
+// On an undirected grid, |d(L, t) - d(L, v)| <= d(v, t) for any L, so the max over the
+// landmarks is an admissible, consistent heuristic - and in mazes, where the true path
+// winds far from the straight line, it is much tighter than Manhattan/octile.
+class LandmarkTable {
+public:
+    static constexpr float UNREACHABLE = std::numeric_limits<float>::infinity();
+
+    // Picks k landmarks by farthest-point selection (each new landmark is the cell
+    // farthest from all chosen so far) and runs one shortest-path pass per landmark
+    static std::shared_ptr<LandmarkTable> build(const Maze& maze, int k);
+
+    // Admissible lower bound on the distance between cells a and b (row-major indices)
+    double lowerBound(size_t a, size_t b) const;
+
+    // Built for this maze's size and movement mode (walls are the caller's business)
+    bool matches(const Maze& maze) const;
+
+    int count() const { return k; }
+    const std::vector<size_t>& getLandmarks() const { return landmarks; }
+    size_t bytesPerLandmark() const { return cellCount * sizeof(float); }
+    size_t memoryBytes() const { return distances.size() * sizeof(float); }
+
+private:
+    int width = 0, height = 0;
+    MovementMode movement = MovementMode::FourWay;
+    size_t cellCount = 0;
+    int k = 0;
+    std::vector<size_t> landmarks;
+    // Cell-major: the k distances of one cell sit together, one cache line for k <= 16
+    std::vector<float> distances;
+
+    // BFS on 4-connected grids, Dijkstra with octile step costs on 8-connected ones
+    static void distancesFrom(const Maze& maze, size_t source, std::vector<float>& out);
+};
\ No newline at end of file
@@ -1,44 +1,133 @@
 #include "Maze.h"
+#include "MazeFile.h"
+#include "Landmarks.h"
+#include "Profiler.h"
 #include <iostream>
 #include <stack>
 #include <random>
 #include <algorithm>
 #include <chrono> 
 #include <limits>
+#include <new>
 
-Maze::Maze(int width, int height) : width(width), height(height) {
+Maze::Maze(int width, int height, const GeneratorOptions& options)
+    : width(width), height(height), options(options) {
     if (width % 2 == 0) this->width++;
     if (height % 2 == 0) this->height++;
     
-    cells.resize(this->width * this->height);
-    initializeMaze();
+    layout = CellLayout(CellOrder::RowMajor, this->width, this->height);
     generate();
 }
 
+Maze::Maze(int width, int height, const std::vector<bool>& walls)
+    : width(width), height(height), layout(CellOrder::RowMajor, width, height), imported(true) {
+    const size_t count = static_cast<size_t>(width) * height;
+    cells.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        cells[i] = Cell(static_cast<int>(i % width), static_cast<int>(i / width), walls[i]);
+    }
+    reset();
+    components.build(*this);
+}
+
+Maze::Maze(std::shared_ptr<const MappedMaze> file)
+    : width(file->header().width), height(file->header().height),
+      layout(CellOrder::RowMajor, file->header().width, file->header().height), seed(file->header().seed),
+      imported(file->header().generator == MazeFile::GENERATOR_IMPORTED),
+      mapped(file), mappedWalls(file->walls()) {
+    const MazeFileHeader& h = file->header();
+    options.braidFraction = h.braidPermille / 1000.0;
+    options.roomCount = h.roomCount;
+    options.maxRoomSize = h.maxRoomSize;
+    options.obstacleDensity = h.obstaclePermille / 1000.0;
+    options.seed = h.seed;
+    
+    // Nothing proportional to the area happens here: the search cells are allocated by
+    // the first getCellPtr()/getCells() and the component index by the first query
+    setEndpoints(h.startX, h.startY, h.goalX, h.goalY);
+}
+
+void Maze::materializeCells() {
+    PROFILE_ZONE("maze", "allocate search cells");
+    // Cells only carry search state here; their wall flag is never consulted
+    cells.assign(layout.size(), Cell(-1, -1, true));
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) cells[layout.slot(x, y)] = Cell(x, y, false);
+    }
+    reset();
+}
+
 void Maze::initializeMaze() {
-    for (int i = 0; i < width * height; ++i) {
-        // x and y can be calculated from index
-        int y = i / width;
-        int x = i % width;
-        cells[i] = Cell(x, y, true); // Set as WALL (true)
+    // Padding slots of a tiled/Morton layout stay walls outside the grid
+    cells.assign(layout.size(), Cell(-1, -1, true));
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) cells[layout.slot(x, y)] = Cell(x, y, true); // Set as WALL (true)
+    }
+}
+
+void Maze::setCellOrder(CellOrder order) {
+    PROFILE_ZONE("maze", "relayout cells");
+    if (order == layout.order()) return;
+    CellLayout next(order, width, height);
+    if (cells.empty()) {
+        // Mapped and not searched yet: the cells will be laid out this way when allocated
+        layout = next;
+        return;
+    }
+    std::pmr::vector<Cell> moved(next.size(), Cell(-1, -1, true), cells.get_allocator());
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) moved[next.slot(x, y)] = cells[layout.slot(x, y)];
     }
+    // Parent pointers would still aim at the old storage
+    cells.swap(moved);
+    layout = next;
+    reset();
+}
+
+void Maze::setMemory(const MemoryOptions& memory) {
+    PROFILE_ZONE("maze", "move cells");
+    std::pmr::memory_resource* resource = GridMemory::get(memory);
+    if (resource == cells.get_allocator().resource()) return;
+    std::pmr::vector<Cell> moved(cells.begin(), cells.end(), resource);
+    // pmr containers never adopt another allocator on assignment, so rebuild in place
+    cells.~vector();
+    new (&cells) std::pmr::vector<Cell>(std::move(moved));
+    reset();
 }
 
 void Maze::generate() {
-    generateRecursiveBacktracking();
+    PROFILE_ZONE("maze", "generate");
+    // Generating replaces any mapped walls with our own
+    mapped.reset();
+    mappedWalls = WallGrid();
+    landmarks.reset();
+    
+    // Start from solid rock so regenerating never inherits old passages
+    initializeMaze();
+    
+    // Crash-proof seed
+    seed = options.seed ? options.seed
+                        : static_cast<unsigned>(std::chrono::system_clock::now().time_since_epoch().count());
+    std::mt19937 gen(seed);
+    
+    obstacleDensity = 0.0;
+    generateRecursiveBacktracking(gen);
+    if (options.braidFraction > 0.0) braid(gen);
+    if (options.roomCount > 0) carveRooms(gen);
+    if (options.obstacleDensity > 0.0) scatterObstacles(gen);
+    
     // Force Start/End open
     if (getStart()) { getStart()->wall = false; getStart()->visited = false; }
     if (getGoal()) { getGoal()->wall = false; getGoal()->visited = false; }
+    
+    components.build(*this);
 }
 
-void Maze::generateRecursiveBacktracking() {
+void Maze::generateRecursiveBacktracking(std::mt19937& gen) {
+    PROFILE_ZONE("maze", "recursive backtracker");
     reset();
     std::stack<Cell*> stack;
     
-    // Crash-proof seed
-    unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-    std::mt19937 gen(seed);
-    
     Cell* start = getCellPtr(1, 1);
     if (!start) return;
     
@@ -77,7 +166,99 @@ void Maze::generateRecursiveBacktracking() {
     reset();
 }
 
+void Maze::braid(std::mt19937& gen) {
+    PROFILE_ZONE("maze", "braid");
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+    const int dx[] = {2, 0, -2, 0};
+    const int dy[] = {0, 2, 0, -2};
+    
+    // Rooms sit on odd coordinates; a dead end is a room with a single open side
+    for (int y = 1; y < height - 1; y += 2) {
+        for (int x = 1; x < width - 1; x += 2) {
+            int openSides = 0;
+            for (int dir = 0; dir < 4; ++dir) {
+                if (isWalkable(x + dx[dir] / 2, y + dy[dir] / 2)) openSides++;
+            }
+            if (openSides != 1 || chance(gen) >= options.braidFraction) continue;
+            
+            // Knock through one of the closed sides into a neighbouring room
+            std::vector<int> dirs;
+            for (int dir = 0; dir < 4; ++dir) {
+                int nx = x + dx[dir];
+                int ny = y + dy[dir];
+                if (nx > 0 && nx < width - 1 && ny > 0 && ny < height - 1 &&
+                    !isWalkable(x + dx[dir] / 2, y + dy[dir] / 2)) {
+                    dirs.push_back(dir);
+                }
+            }
+            if (dirs.empty()) continue;
+            int dir = dirs[std::uniform_int_distribution<size_t>(0, dirs.size() - 1)(gen)];
+            getCellPtr(x + dx[dir] / 2, y + dy[dir] / 2)->wall = false;
+        }
+    }
+}
+
+void Maze::carveRooms(std::mt19937& gen) {
+    PROFILE_ZONE("maze", "carve rooms");
+    int maxSide = std::max(3, std::min(options.maxRoomSize, std::min(width, height) - 2));
+    std::uniform_int_distribution<int> side(3, maxSide);
+    
+    for (int r = 0; r < options.roomCount; ++r) {
+        int w = side(gen);
+        int h = side(gen);
+        // Keep the outer border intact
+        int x0 = std::uniform_int_distribution<int>(1, std::max(1, width - 1 - w))(gen);
+        int y0 = std::uniform_int_distribution<int>(1, std::max(1, height - 1 - h))(gen);
+        for (int y = y0; y < std::min(y0 + h, height - 1); ++y) {
+            for (int x = x0; x < std::min(x0 + w, width - 1); ++x) {
+                getCellPtr(x, y)->wall = false;
+            }
+        }
+    }
+}
+
+void Maze::scatterObstacles(std::mt19937& gen) {
+    PROFILE_ZONE("maze", "scatter obstacles");
+    Cell* start = getStart();
+    Cell* goal = getGoal();
+    // Obstacles only go where all 8 surrounding cells are open, so they never
+    // touch each other or a wall and can't seal off a corridor
+    auto clear = [this](int x, int y) {
+        for (int dy = -1; dy <= 1; ++dy)
+            for (int dx = -1; dx <= 1; ++dx)
+                if (!isWalkable(x + dx, y + dy)) return false;
+        return true;
+    };
+
+    // The open area: every cell that could take an obstacle before any is placed
+    std::vector<uint32_t> candidates;
+    for (int y = 1; y < height - 1; ++y) {
+        for (int x = 1; x < width - 1; ++x) {
+            Cell* c = getCellPtr(x, y);
+            if (c == start || c == goal || !clear(x, y)) continue;
+            candidates.push_back(static_cast<uint32_t>(y) * width + x);
+        }
+    }
+    if (candidates.empty()) return;
+
+    // Each obstacle rules out its neighbours, so draw candidates in random order,
+    // skipping ruled-out ones, until the target is met or none are left
+    const size_t target = static_cast<size_t>(options.obstacleDensity * candidates.size() + 0.5);
+    size_t placed = 0;
+    for (size_t i = 0; i < candidates.size() && placed < target; ++i) {
+        std::uniform_int_distribution<size_t> pick(i, candidates.size() - 1);
+        std::swap(candidates[i], candidates[pick(gen)]);
+        int x = static_cast<int>(candidates[i] % width);
+        int y = static_cast<int>(candidates[i] / width);
+        if (!clear(x, y)) continue;
+        getCellPtr(x, y)->wall = true;
+        ++placed;
+    }
+    obstacleDensity = static_cast<double>(placed) / candidates.size();
+}
+
 void Maze::reset() {
+    PROFILE_ZONE("maze", "reset");
     for (auto& c : cells) {
         c.visited = false;
         c.g_cost = std::numeric_limits<double>::max();
@@ -88,23 +269,119 @@ void Maze::reset() {
 
 Cell* Maze::getCellPtr(int x, int y) {
     if (x < 0 || x >= width || y < 0 || y >= height) return nullptr;
-    return &cells[y * width + x];
+    if (cells.empty()) materializeCells();
+    return &cells[layout.slot(x, y)];
+}
+
+Cell* Maze::getStart() { return getCellPtr(startX, startY); }
+Cell* Maze::getGoal() {
+    if (goalX < 0) return getCellPtr(width - 2, height - 2);
+    return getCellPtr(goalX, goalY);
+}
+
+void Maze::setEndpoints(int sx, int sy, int gx, int gy) {
+    startX = sx; startY = sy;
+    goalX = gx; goalY = gy;
+}
+
+bool Maze::isWalkable(int x, int y) const {
+    if (x < 0 || x >= width || y < 0 || y >= height) return false;
+    if (mappedWalls.words) return !mappedWalls.isWall(x, y);
+    return !cells[layout.slot(x, y)].wall;
+}
+
+std::vector<uint64_t> Maze::packWalls() const {
+    std::vector<uint64_t> words(WallGrid::wordsForWidth(width) * height);
+    packWalls(words.data());
+    return words;
+}
+
+void Maze::packWalls(uint64_t* words) const {
+    size_t wordsPerRow = WallGrid::wordsForWidth(width);
+    // Mapped files already store this exact layout
+    if (mappedWalls.words) {
+        std::copy(mappedWalls.words, mappedWalls.words + mappedWalls.wordCount(), words);
+        return;
+    }
+    
+    for (int y = 0; y < height; ++y) {
+        for (int x0 = 0; x0 < width; x0 += 64) {
+            int count = std::min(64, width - x0);
+            uint64_t word = 0;
+            if (layout.order() == CellOrder::RowMajor) {
+                const Cell* row = &cells[static_cast<size_t>(y) * width + x0];
+                for (int i = 0; i < count; ++i) word |= uint64_t(row[i].wall) << i;
+            } else {
+                for (int i = 0; i < count; ++i) word |= uint64_t(cells[layout.slot(x0 + i, y)].wall) << i;
+            }
+            words[y * wordsPerRow + (x0 >> 6)] = word;
+        }
+    }
+}
+
+bool Maze::setWall(int x, int y, bool wall) {
+    if (x < 0 || x >= width || y < 0 || y >= height || mapped) return false;
+    Cell& c = cells[layout.slot(x, y)];
+    if (c.wall == wall) return true;
+    c.wall = wall;
+    landmarks.reset();
+    if (wall) components.cellClosed(*this, x, y);
+    else components.cellOpened(*this, x, y);
+    return true;
 }
 
-Cell* Maze::getStart() { return getCellPtr(1, 1); }
-Cell* Maze::getGoal() { return getCellPtr(width - 2, height - 2); }
+bool Maze::connected(int ax, int ay, int bx, int by) {
+    if (!isWalkable(ax, ay) || !isWalkable(bx, by)) return false;
+    return components.connected(*this, static_cast<size_t>(ay) * width + ax, static_cast<size_t>(by) * width + bx);
+}
+
+bool Maze::canStep(int x, int y, int dx, int dy) const {
+    if (!isWalkable(x + dx, y + dy)) return false;
+    if (dx != 0 && dy != 0) {
+        if (movement != MovementMode::EightWay) return false;
+        return isWalkable(x + dx, y) && isWalkable(x, y + dy);
+    }
+    return true;
+}
 
 std::vector<Cell*> Maze::getNeighbors(Cell* c) {
     std::vector<Cell*> n;
     if (!c) return n;
-    const int dx[] = {0, 0, 1, -1};
-    const int dy[] = {1, -1, 0, 0};
-    for (int i=0; i<4; ++i) {
-        Cell* adj = getCellPtr(c->x + dx[i], c->y + dy[i]);
-        if (adj && !adj->wall) n.push_back(adj);
+    // Orthogonal moves first, then diagonals (8-connected only)
+    const int dx[] = {0, 0, 1, -1, 1, 1, -1, -1};
+    const int dy[] = {1, -1, 0, 0, 1, -1, 1, -1};
+    int count = (movement == MovementMode::EightWay) ? 8 : 4;
+    for (int i=0; i<count; ++i) {
+        if (canStep(c->x, c->y, dx[i], dy[i])) n.push_back(getCellPtr(c->x + dx[i], c->y + dy[i]));
     }
     return n;
 }
 
-std::string Maze::toAscii() const { return ""; }
-void Maze::markPath(const std::vector<Cell*>&) {}
\ No newline at end of file
+const LandmarkTable* Maze::getLandmarks() const {
+    return (landmarks && landmarks->matches(*this)) ? landmarks.get() : nullptr;
+}
+
+// '#' wall, 'S'/'G' endpoints, '*' cells flagged by markPath, ' ' open
+std::string Maze::toAscii() const {
+    const int gx = goalX < 0 ? width - 2 : goalX;
+    const int gy = goalX < 0 ? height - 2 : goalY;
+    std::string out;
+    out.reserve(static_cast<size_t>(width + 1) * height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            if (x == startX && y == startY) out += 'S';
+            else if (x == gx && y == gy) out += 'G';
+            else if (!isWalkable(x, y)) out += '#';
+            else if (!cells.empty() && cells[layout.slot(x, y)].visited) out += '*';
+            else out += ' ';
+        }
+        out += '\n';
+    }
+    return out;
+}
+
+// Flags the path in Cell::visited, which no solver uses; reset() clears it again
+void Maze::markPath(const std::vector<Cell*>& path) {
+    for (auto& c : getCells()) c.visited = false;
+    for (Cell* c : path) c->visited = true;
+}
\ No newline at end of file
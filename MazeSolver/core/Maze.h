@@ -1,21 +1,81 @@
 #pragma once
 #include <vector>
+#include <memory_resource>
 #include "Cell.h"
+#include "Types.h"
 #include <string>
+#include <random>
+#include <memory>
+#include <cstdint>
+#include "WallGrid.h"
+#include "Components.h"
+#include "CellLayout.h"
+#include "GridMemory.h"
+
+class MappedMaze;
+class LandmarkTable;
+
+// Post-processing applied on top of the recursive backtracker.
+// All zero = a perfect maze (exactly one path between any two cells).
+struct GeneratorOptions {
+    double braidFraction = 0.0;    // Fraction of dead ends knocked through to create loops (0-1)
+    int roomCount = 0;             // Open rectangular rooms to carve
+    int maxRoomSize = 9;           // Largest room side, in cells
+    double obstacleDensity = 0.0;  // Fraction of open-area cells turned into single-cell obstacles (0-1);
+                                   // obstacles can't touch, so dense targets may not be met
+    unsigned seed = 0;             // 0 = seed from the clock
+};
 
 class Maze {
 private:
     int width, height;
-    std::vector<Cell> cells;
+    std::pmr::vector<Cell> cells;  // In 'layout' order, from the GridMemory backend (heap by default)
+    CellLayout layout;
+    MovementMode movement = MovementMode::FourWay;
+    GeneratorOptions options;
+    unsigned seed = 0;
+    double obstacleDensity = 0.0;  // What scatterObstacles achieved
+    int startX = 1, startY = 1;
+    int goalX = -1, goalY = -1;    // -1 = bottom-right corner
+    bool imported = false;
+    
+    // When loaded from a maze file, walls are read straight from the mapping
+    std::shared_ptr<const MappedMaze> mapped;
+    WallGrid mappedWalls;
+    
+    // Optional ALT preprocessing; dropped whenever the walls are regenerated
+    std::shared_ptr<const LandmarkTable> landmarks;
+    
+    // Open-cell components, rebuilt with the walls and patched by setWall
+    ComponentIndex components;
     
     void initializeMaze();
-    void generateRecursiveBacktracking();
+    // Mapped mazes allocate their cells on first use (cells stays empty until then)
+    void materializeCells();
+    void generateRecursiveBacktracking(std::mt19937& gen);
+    void braid(std::mt19937& gen);
+    void carveRooms(std::mt19937& gen);
+    void scatterObstacles(std::mt19937& gen);
     
     public:
-    Maze(int width = 51, int height = 51);
+    Maze(int width = 51, int height = 51, const GeneratorOptions& options = GeneratorOptions());
+    // Imported layout (e.g. a MovingAI .map): walls as given, no generation, no odd-size rounding
+    Maze(int width, int height, const std::vector<bool>& walls);
+    // Wraps a mapped maze file; the wall bitmap is used in place. Opening touches no
+    // per-cell memory: the search cells (about 40 bytes each) are allocated by the first
+    // solve or cell access, and the component index is built by the first query.
+    explicit Maze(std::shared_ptr<const MappedMaze> file);
     Cell* getCellPtr(int x, int y);
+    // By row-major index y * width + x (the cell ids used by paths, traces and tables)
+    Cell* cellAt(size_t index) { return getCellPtr(static_cast<int>(index % width), static_cast<int>(index / width)); }
     
     void generate();
+    void setGeneratorOptions(const GeneratorOptions& opts) { options = opts; }
+    const GeneratorOptions& getGeneratorOptions() const { return options; }
+    unsigned getSeed() const { return seed; }
+    // Fraction of open-area cells the last generate() turned into obstacles. Equals
+    // options.obstacleDensity unless too few cells stayed clear of other obstacles.
+    double getObstacleDensity() const { return obstacleDensity; }
     void reset();
     std::string toAscii() const;
     void markPath(const std::vector<Cell*>& path);
@@ -25,7 +85,47 @@ private:
     int getHeight() const { return height; }
     Cell* getStart();
     Cell* getGoal();
-    std::vector<Cell>& getCells() { return cells; }
+    void setEndpoints(int sx, int sy, int gx, int gy);
+    // Storage in layout order, padding slots included. Per-cell search arrays can be
+    // indexed by slotOf() to share the layout's locality.
+    std::pmr::vector<Cell>& getCells() {
+        if (cells.empty()) materializeCells();
+        return cells;
+    }
+    size_t slotCount() const { return layout.size(); }
+    size_t slotOf(const Cell* c) const { return static_cast<size_t>(c - cells.data()); }
+    CellOrder getCellOrder() const { return layout.order(); }
+    // Re-lays the cells out in place; walls and search state move with them
+    void setCellOrder(CellOrder order);
+    // Moves the cells to another page backend (huge pages, NUMA placement). Copies of
+    // the maze go back to the heap.
+    MemoryOptions getMemory() const { return GridMemory::optionsOf(cells.get_allocator().resource()); }
+    void setMemory(const MemoryOptions& memory);
+    bool isMapped() const { return mapped != nullptr; }
+    bool isImported() const { return imported; }
+    // Bit-packed copy of the walls in WallGrid layout
+    std::vector<uint64_t> packWalls() const;
+    // Same, into caller storage of WallGrid::wordsForWidth(width) * height words
+    void packWalls(uint64_t* words) const;
+    
+    // Movement rules
+    MovementMode getMovementMode() const { return movement; }
+    void setMovementMode(MovementMode mode) { movement = mode; }
+    bool isWalkable(int x, int y) const;
+    // Diagonal steps are only allowed when both orthogonal cells are open (no corner cutting)
+    bool canStep(int x, int y, int dx, int dy) const;
+    
+    // Edits one cell after generation. Keeps the component index current and drops
+    // landmarks (their distances no longer hold). False when out of range or mapped (read-only).
+    bool setWall(int x, int y, bool wall);
+    // Whether a path can exist between two cells: O(1) after build, false if either is a wall
+    bool connected(int ax, int ay, int bx, int by);
+    size_t componentCount() { return components.componentCount(*this); }
+    
+    // ALT landmarks. getLandmarks() returns nullptr unless the table fits the current
+    // size and movement mode, so a stale table can never produce a bad heuristic.
+    void setLandmarks(std::shared_ptr<const LandmarkTable> table) { landmarks = std::move(table); }
+    const LandmarkTable* getLandmarks() const;
     
     // For algorithms
     std::vector<Cell*> getNeighbors(Cell* cell);
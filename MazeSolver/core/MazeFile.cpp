@@ -0,0 +1,181 @@
+#include "MazeFile.h"
+#include "Maze.h"
+#include <climits>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char MAZE_MAGIC[8] = {'M', 'A', 'Z', 'E', 'B', 'I', 'N', '\0'};
+
+// The bitmap is mapped and used in place, so there is no chance to byte-swap it:
+// big-endian hosts can neither write nor read the little-endian format
+static bool littleEndianHost() {
+    const uint16_t probe = 1;
+    unsigned char first;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+static const char* const BIG_ENDIAN_ERROR = "Maze files are little-endian and this host is big-endian";
+
+uint64_t MazeFile::checksum(const uint64_t* words, size_t count) {
+    // FNV-1a, byte at a time
+    uint64_t hash = 1469598103934665603ULL;
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(words);
+    for (size_t i = 0; i < count * sizeof(uint64_t); ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool MazeFile::save(Maze& maze, const std::string& path, std::string& error) {
+    if (!littleEndianHost()) {
+        error = BIG_ENDIAN_ERROR;
+        return false;
+    }
+    if (!maze.getStart() || !maze.getGoal()) {
+        error = "Maze has no start or goal";
+        return false;
+    }
+    std::vector<uint64_t> words = maze.packWalls();
+    const GeneratorOptions& opts = maze.getGeneratorOptions();
+
+    MazeFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAZE_MAGIC, sizeof(MAZE_MAGIC));
+    header.version = VERSION;
+    header.headerSize = sizeof(MazeFileHeader);
+    header.width = maze.getWidth();
+    header.height = maze.getHeight();
+    header.startX = maze.getStart()->x;
+    header.startY = maze.getStart()->y;
+    header.goalX = maze.getGoal()->x;
+    header.goalY = maze.getGoal()->y;
+    header.seed = maze.getSeed();
+    header.generator = maze.isImported() ? GENERATOR_IMPORTED : GENERATOR_BACKTRACKER;
+    header.braidPermille = static_cast<uint32_t>(opts.braidFraction * 1000 + 0.5);
+    header.roomCount = opts.roomCount;
+    header.maxRoomSize = opts.maxRoomSize;
+    header.obstaclePermille = static_cast<uint32_t>(opts.obstacleDensity * 1000 + 0.5);
+    header.wordsPerRow = WallGrid::wordsForWidth(maze.getWidth());
+    header.checksum = checksum(words.data(), words.size());
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        error = "Cannot open '" + path + "' for writing";
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(words.data()), words.size() * sizeof(uint64_t));
+    if (!out) {
+        error = "Write to '" + path + "' failed";
+        return false;
+    }
+    return true;
+}
+
+std::shared_ptr<MappedMaze> MappedMaze::open(const std::string& path, std::string& error) {
+    if (!littleEndianHost()) {
+        error = BIG_ENDIAN_ERROR;
+        return nullptr;
+    }
+    std::shared_ptr<MappedMaze> file(new MappedMaze());
+
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        error = "Cannot open '" + path + "'";
+        return nullptr;
+    }
+    file->fileHandle = handle;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(handle, &fileSize)) {
+        error = "Cannot stat '" + path + "'";
+        return nullptr;
+    }
+    file->size = static_cast<size_t>(fileSize.QuadPart);
+    if (file->size >= sizeof(MazeFileHeader)) {
+        file->mappingHandle = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (file->mappingHandle) file->data = MapViewOfFile(file->mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    }
+#else
+    file->fd = ::open(path.c_str(), O_RDONLY);
+    if (file->fd < 0) {
+        error = "Cannot open '" + path + "'";
+        return nullptr;
+    }
+    struct stat st;
+    if (fstat(file->fd, &st) != 0) {
+        error = "Cannot stat '" + path + "'";
+        return nullptr;
+    }
+    file->size = static_cast<size_t>(st.st_size);
+    if (file->size >= sizeof(MazeFileHeader)) {
+        // Shared read-only mapping: every process opening the file uses the same page cache
+        void* p = mmap(nullptr, file->size, PROT_READ, MAP_SHARED, file->fd, 0);
+        if (p != MAP_FAILED) file->data = p;
+    }
+#endif
+
+    if (file->size < sizeof(MazeFileHeader)) {
+        error = "'" + path + "' is too small to be a maze file";
+        return nullptr;
+    }
+    if (!file->data) {
+        error = "Cannot map '" + path + "'";
+        return nullptr;
+    }
+
+    const MazeFileHeader& h = file->header();
+    if (std::memcmp(h.magic, MAZE_MAGIC, sizeof(MAZE_MAGIC)) != 0) {
+        error = "'" + path + "' is not a maze file";
+        return nullptr;
+    }
+    if (h.version != MazeFile::VERSION) {
+        error = "Unsupported maze file version " + std::to_string(h.version);
+        return nullptr;
+    }
+    // Dimensions become ints below
+    if (h.width == 0 || h.height == 0 || h.width > INT_MAX || h.height > INT_MAX || h.wordsPerRow != WallGrid::wordsForWidth(h.width) ||
+        h.startX >= h.width || h.startY >= h.height || h.goalX >= h.width || h.goalY >= h.height) {
+        error = "Corrupt maze header in '" + path + "'";
+        return nullptr;
+    }
+    uint64_t bitmapBytes = h.wordsPerRow * h.height * sizeof(uint64_t);
+    if (h.headerSize < sizeof(MazeFileHeader) || h.headerSize % sizeof(uint64_t) != 0 ||
+        file->size < h.headerSize + bitmapBytes) {
+        error = "Truncated maze file '" + path + "'";
+        return nullptr;
+    }
+
+    file->grid.width = static_cast<int>(h.width);
+    file->grid.height = static_cast<int>(h.height);
+    file->grid.wordsPerRow = static_cast<size_t>(h.wordsPerRow);
+    file->grid.words = reinterpret_cast<const uint64_t*>(static_cast<const char*>(file->data) + h.headerSize);
+    return file;
+}
+
+MappedMaze::~MappedMaze() {
+#ifdef _WIN32
+    if (data) UnmapViewOfFile(data);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+#else
+    if (data) munmap(data, size);
+    if (fd >= 0) close(fd);
+#endif
+}
+
+bool MappedMaze::verifyChecksum() const {
+    return MazeFile::checksum(grid.words, grid.wordCount()) == header().checksum;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "WallGrid.h"
+
+class Maze;
+
+// On-disk layout (version 1, little-endian; save and open refuse big-endian hosts):
+//   [MazeFileHeader, 96 bytes][wall bitmap, height * wordsPerRow uint64 words]
+// The bitmap is exactly the WallGrid layout, so a mapped file is usable in place.
+struct MazeFileHeader {
+    char magic[8];              // "MAZEBIN\0"
+    uint32_t version;
+    uint32_t headerSize;        // Offset of the bitmap from the start of the file
+    uint32_t width;
+    uint32_t height;
+    uint32_t startX, startY;
+    uint32_t goalX, goalY;
+    uint32_t seed;
+    uint32_t generator;         // 0 = recursive backtracker, 1 = imported map
+    uint32_t braidPermille;     // GeneratorOptions, scaled to integers
+    uint32_t roomCount;
+    uint32_t maxRoomSize;
+    uint32_t obstaclePermille;
+    uint64_t wordsPerRow;
+    uint64_t checksum;          // FNV-1a over the bitmap bytes
+    uint8_t reserved[16];
+};
+static_assert(sizeof(MazeFileHeader) == 96, "MazeFileHeader must stay 96 bytes");
+
+namespace MazeFile {
+    constexpr uint32_t VERSION = 1;
+    constexpr uint32_t GENERATOR_BACKTRACKER = 0;
+    constexpr uint32_t GENERATOR_IMPORTED = 1;
+
+    uint64_t checksum(const uint64_t* words, size_t count);
+    // Writes header + bitmap. Returns false and fills 'error' on failure.
+    bool save(Maze& maze, const std::string& path, std::string& error);
+}
+
+// Read-only memory mapping of a maze file. Opening only validates the header;
+// the bitmap is paged in lazily by the OS and shared between processes that
+// map the same file. Call verifyChecksum() when you want the full integrity check.
+class MappedMaze {
+private:
+    void* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#else
+    int fd = -1;
+#endif
+    WallGrid grid;
+
+    MappedMaze() = default;
+
+public:
+    MappedMaze(const MappedMaze&) = delete;
+    MappedMaze& operator=(const MappedMaze&) = delete;
+    ~MappedMaze();
+
+    static std::shared_ptr<MappedMaze> open(const std::string& path, std::string& error);
+
+    const MazeFileHeader& header() const { return *static_cast<const MazeFileHeader*>(data); }
+    const WallGrid& walls() const { return grid; }
+    size_t fileSize() const { return size; }
+    bool verifyChecksum() const;
+};
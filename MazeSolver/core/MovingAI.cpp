@@ -0,0 +1,140 @@
+#include "MovingAI.h"
+#include "Utility.h"
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+bool MovingAI::loadMap(const std::string& path, Maze& maze, std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "Cannot open map '" + path + "'";
+        return false;
+    }
+
+    int width = 0, height = 0;
+    std::string key;
+    while (in >> key && key != "map") {
+        if (key == "height") in >> height;
+        else if (key == "width") in >> width;
+        else if (key == "type") in >> key;  // Always "octile" in practice
+        else {
+            error = "Unexpected '" + key + "' in map header of '" + path + "'";
+            return false;
+        }
+    }
+    if (key != "map" || width <= 0 || height <= 0) {
+        error = "Missing map header in '" + path + "'";
+        return false;
+    }
+
+    std::vector<bool> walls(static_cast<size_t>(width) * height, true);
+    std::string row;
+    for (int y = 0; y < height; ++y) {
+        if (!(in >> row) || static_cast<int>(row.size()) < width) {
+            error = "Map '" + path + "' is shorter than its header says";
+            return false;
+        }
+        for (int x = 0; x < width; ++x) {
+            char c = row[x];
+            walls[static_cast<size_t>(y) * width + x] = !(c == '.' || c == 'G' || c == 'S');
+        }
+    }
+
+    maze = Maze(width, height, walls);
+    maze.setMovementMode(MovementMode::EightWay);
+    return true;
+}
+
+bool MovingAI::loadScenario(const std::string& path, std::vector<Query>& queries, std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "Cannot open scenario '" + path + "'";
+        return false;
+    }
+
+    std::string line;
+    std::getline(in, line);
+    if (line.compare(0, 7, "version") != 0) {
+        error = "'" + path + "' is missing the 'version' line";
+        return false;
+    }
+
+    queries.clear();
+    int lineNo = 1;
+    while (std::getline(in, line)) {
+        ++lineNo;
+        if (line.empty() || line == "\r") continue;
+        // Map names never contain whitespace, so plain stream extraction is enough
+        std::istringstream fields(line);
+        Query q;
+        if (!(fields >> q.bucket >> q.map >> q.mapWidth >> q.mapHeight
+                     >> q.startX >> q.startY >> q.goalX >> q.goalY >> q.optimalLength)) {
+            error = "Malformed query on line " + std::to_string(lineNo) + " of '" + path + "'";
+            return false;
+        }
+        queries.push_back(q);
+    }
+    return true;
+}
+
+std::string MovingAI::resolveMapPath(const std::string& scenPath, const std::string& mapName) {
+    size_t slash = scenPath.find_last_of("/\\");
+    std::string dir = (slash == std::string::npos) ? "" : scenPath.substr(0, slash + 1);
+    size_t nameSlash = mapName.find_last_of("/\\");
+    std::string base = (nameSlash == std::string::npos) ? mapName : mapName.substr(nameSlash + 1);
+
+    if (std::ifstream(dir + base)) return dir + base;
+    if (std::ifstream(dir + mapName)) return dir + mapName;
+    return mapName;
+}
+
+std::string MovingAI::checkQuery(const Maze& maze, const Query& query) {
+    if (query.mapWidth != maze.getWidth() || query.mapHeight != maze.getHeight()) {
+        return "written for a " + std::to_string(query.mapWidth) + "x" + std::to_string(query.mapHeight) +
+               " map, not " + std::to_string(maze.getWidth()) + "x" + std::to_string(maze.getHeight());
+    }
+    if (!maze.isWalkable(query.startX, query.startY)) return "start is outside the map or blocked";
+    if (!maze.isWalkable(query.goalX, query.goalY)) return "goal is outside the map or blocked";
+    return "";
+}
+
+std::vector<MovingAI::BucketStats> MovingAI::runQueries(Maze& maze, const std::vector<Query>& queries,
+                                                       std::function<AlgorithmResult(Maze&)> algorithm) {
+    std::map<int, BucketStats> buckets;
+    std::map<int, std::vector<long long>> times;
+
+    for (const Query& q : queries) {
+        BucketStats& stats = buckets[q.bucket];
+        stats.bucket = q.bucket;
+        stats.queries++;
+        if (!checkQuery(maze, q).empty()) {
+            stats.skipped++;
+            continue;
+        }
+
+        maze.setEndpoints(q.startX, q.startY, q.goalX, q.goalY);
+        AlgorithmResult result = Utility::runAlgorithmSafely(maze, algorithm);
+        if (!result.success) continue;
+
+        stats.solved++;
+        // Published lengths are printed with 8 decimals
+        if (std::abs(result.metrics.pathCost - q.optimalLength) < 1e-4 * std::max(1.0, q.optimalLength)) {
+            stats.optimal++;
+        }
+        stats.total.pathLength += result.metrics.pathLength;
+        stats.total.nodesExplored += result.metrics.nodesExplored;
+        stats.total.timeTakenMs += result.metrics.timeTakenMs;
+        stats.total.pathCost += result.metrics.pathCost;
+        stats.total.heapAllocations += result.metrics.heapAllocations;
+        times[q.bucket].push_back(result.metrics.timeTakenMs);
+    }
+
+    std::vector<BucketStats> out;
+    for (auto& [bucket, stats] : buckets) {
+        stats.timing = Utility::summarizeTimes(times[bucket]);
+        stats.timing.totalRuns = stats.queries;
+        out.push_back(stats);
+    }
+    return out;
+}
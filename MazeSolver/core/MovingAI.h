@@ -0,0 +1,48 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <vector>
+#include "Maze.h"
+#include "Types.h"
+
+// Loader and runner for the MovingAI grid benchmarks (https://movingai.com/benchmarks/grids.html).
+// .map: "type octile / height H / width W / map" followed by H rows of terrain.
+// .scen: "version 1" followed by one query per line:
+//        bucket  map  mapWidth  mapHeight  startX  startY  goalX  goalY  optimalLength
+// Optimal lengths assume octile movement without corner cutting (MovementMode::EightWay).
+namespace MovingAI {
+    struct Query {
+        int bucket = 0;
+        std::string map;
+        int mapWidth = 0, mapHeight = 0;   // Size of the map the query was written for
+        int startX = 0, startY = 0;
+        int goalX = 0, goalY = 0;
+        double optimalLength = 0.0;
+    };
+
+    struct BucketStats {
+        int bucket = 0;
+        int queries = 0;
+        int solved = 0;
+        int optimal = 0;          // Solved with a cost matching the stated optimum
+        int skipped = 0;          // Not run: written for another map size, or an endpoint is blocked
+        Metrics total;            // Summed over the bucket's queries
+        RobustMetrics timing;     // Per-query time distribution (μs)
+    };
+
+    // Loads a .map as an imported Maze (8-connected). '.', 'G' and 'S' are passable.
+    bool loadMap(const std::string& path, Maze& maze, std::string& error);
+    bool loadScenario(const std::string& path, std::vector<Query>& queries, std::string& error);
+
+    // Resolves a query's map name: next to the .scen file first, then as given
+    std::string resolveMapPath(const std::string& scenPath, const std::string& mapName);
+
+    // Why 'query' can't be run on 'maze' (its map size differs, or an endpoint is outside
+    // the map or on a wall); empty when it can
+    std::string checkQuery(const Maze& maze, const Query& query);
+
+    // Runs every query against one algorithm. Queries must all belong to 'maze'; any that
+    // fail checkQuery() are counted as skipped instead of being solved.
+    std::vector<BucketStats> runQueries(Maze& maze, const std::vector<Query>& queries,
+                                        std::function<AlgorithmResult(Maze&)> algorithm);
+}
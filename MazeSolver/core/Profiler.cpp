@@ -0,0 +1,188 @@
+#include "Profiler.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+std::atomic<bool> Profiler::enabled{false};
+const std::chrono::steady_clock::time_point Profiler::epoch = std::chrono::steady_clock::now();
+
+namespace {
+    struct Event {
+        const char* category;
+        const char* name;
+        int64_t start;
+        int64_t duration;
+    };
+
+    // One per thread that ever recorded. Owned by the registry, so a buffer outlives its
+    // thread and the export still sees it. The lock is only contended during an export.
+    struct ThreadBuffer {
+        std::mutex lock;
+        std::vector<Event> events;
+        std::string name;
+        uint32_t id = 0;
+        size_t dropped = 0;
+    };
+
+    struct Registry {
+        std::mutex lock;
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    };
+
+    const std::thread::id mainThread = std::this_thread::get_id();
+
+    Registry& registry() {
+        static Registry r;
+        return r;
+    }
+
+    ThreadBuffer& localBuffer() {
+        thread_local ThreadBuffer* buffer = nullptr;
+        if (!buffer) {
+            Registry& r = registry();
+            std::lock_guard<std::mutex> guard(r.lock);
+            r.buffers.push_back(std::make_unique<ThreadBuffer>());
+            buffer = r.buffers.back().get();
+            buffer->id = static_cast<uint32_t>(r.buffers.size());
+            buffer->name = std::this_thread::get_id() == mainThread ? "main" : "thread " + std::to_string(buffer->id);
+        }
+        return *buffer;
+    }
+
+    std::string traceAtExit;
+
+    void writeAtExit() {
+        Profiler::stop();
+        std::string error;
+        if (!Profiler::writeChromeTrace(traceAtExit, error)) std::fprintf(stderr, "%s\n", error.c_str());
+    }
+
+    void appendEscaped(std::string& out, const char* text) {
+        for (const char* p = text; *p; ++p) {
+            if (*p == '"' || *p == '\\') out += '\\';
+            out += *p;
+        }
+    }
+
+    void appendMicros(std::string& out, int64_t ns) {
+        char digits[32];
+        std::snprintf(digits, sizeof(digits), "%lld.%03lld", static_cast<long long>(ns / 1000),
+                      static_cast<long long>(ns % 1000));
+        out += digits;
+    }
+}
+
+void Profiler::start() {
+    Registry& r = registry();
+    {
+        std::lock_guard<std::mutex> guard(r.lock);
+        for (auto& b : r.buffers) {
+            std::lock_guard<std::mutex> bufferGuard(b->lock);
+            b->events.clear();
+            b->dropped = 0;
+        }
+    }
+    enabled.store(true, std::memory_order_relaxed);
+}
+
+void Profiler::stop() {
+    enabled.store(false, std::memory_order_relaxed);
+}
+
+void Profiler::startFromEnvironment() {
+    const char* path = std::getenv("MAZE_TRACE");
+    if (!compiledIn() || !path || !*path) return;
+    traceAtExit = path;
+    start();
+    std::atexit(writeAtExit);
+}
+
+void Profiler::setThreadName(const char* name) {
+    ThreadBuffer& b = localBuffer();
+    std::lock_guard<std::mutex> guard(b.lock);
+    b.name = name;
+}
+
+void Profiler::emit(const char* category, const char* name, int64_t startNs, int64_t durationNs) {
+    ThreadBuffer& b = localBuffer();
+    std::lock_guard<std::mutex> guard(b.lock);
+    if (b.events.size() >= MAX_EVENTS) {
+        b.dropped++;
+        return;
+    }
+    b.events.push_back({category, name, startNs, durationNs});
+}
+
+size_t Profiler::eventCount() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> guard(r.lock);
+    size_t total = 0;
+    for (auto& b : r.buffers) {
+        std::lock_guard<std::mutex> bufferGuard(b->lock);
+        total += b->events.size();
+    }
+    return total;
+}
+
+size_t Profiler::droppedCount() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> guard(r.lock);
+    size_t total = 0;
+    for (auto& b : r.buffers) {
+        std::lock_guard<std::mutex> bufferGuard(b->lock);
+        total += b->dropped;
+    }
+    return total;
+}
+
+bool Profiler::writeChromeTrace(const std::string& path, std::string& error) {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) {
+        error = "Cannot open '" + path + "' for writing";
+        return false;
+    }
+    
+    // Complete ("X") events per zone, plus a thread_name metadata event per track
+    std::string json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    bool first = true;
+    auto separator = [&]() {
+        if (!first) json += ",\n";
+        first = false;
+    };
+    
+    Registry& r = registry();
+    std::lock_guard<std::mutex> guard(r.lock);
+    for (auto& b : r.buffers) {
+        std::lock_guard<std::mutex> bufferGuard(b->lock);
+        separator();
+        json += "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" + std::to_string(b->id) +
+                ",\"args\":{\"name\":\"";
+        appendEscaped(json, b->name.c_str());
+        json += "\"}}";
+        for (const Event& e : b->events) {
+            separator();
+            json += "{\"ph\":\"X\",\"cat\":\"";
+            appendEscaped(json, e.category);
+            json += "\",\"name\":\"";
+            appendEscaped(json, e.name);
+            json += "\",\"pid\":1,\"tid\":" + std::to_string(b->id) + ",\"ts\":";
+            appendMicros(json, e.start);
+            json += ",\"dur\":";
+            appendMicros(json, e.duration);
+            json += "}";
+        }
+        // Flush per thread so a long trace never needs one huge string
+        out << json;
+        json.clear();
+    }
+    out << "\n]}\n";
+    if (!out) {
+        error = "Write to '" + path + "' failed";
+        return false;
+    }
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Scoped phase tracing, exported as Chrome trace-event JSON (chrome://tracing, Perfetto).
+//
+//   PROFILE_ZONE("search", "solve");      // One complete event for the enclosing scope
+//   PROFILE_THREAD("bfs worker");         // Names the calling thread's track
+//
+// Built with MAZE_PROFILING defined (CMake -DMAZE_PROFILING=ON) the macros record into
+// per-thread buffers while recording is on; otherwise they expand to nothing and the
+// instrumented code is exactly what it was. Names and categories must be string
+// literals: only the pointer is stored.
+class Profiler {
+public:
+    static constexpr bool compiledIn() {
+#ifdef MAZE_PROFILING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Clears every buffer and starts recording
+    static void start();
+    static void stop();
+    static bool recording() { return enabled.load(std::memory_order_relaxed); }
+    // MAZE_TRACE=<file> in the environment: start now, write the trace at exit
+    static void startFromEnvironment();
+
+    // Writes what has been recorded. Returns false and fills 'error' on failure.
+    static bool writeChromeTrace(const std::string& path, std::string& error);
+    static size_t eventCount();
+    // Events lost to full buffers (MAX_EVENTS per thread)
+    static size_t droppedCount();
+
+    static void setThreadName(const char* name);
+    // Nanoseconds since the profiler's epoch
+    static int64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - epoch).count();
+    }
+    static void emit(const char* category, const char* name, int64_t startNs, int64_t durationNs);
+
+    static constexpr size_t MAX_EVENTS = 1 << 20;
+
+    class Zone {
+    public:
+        Zone(const char* category, const char* name)
+            : category(category), name(name), begin(recording() ? now() : -1) {}
+        ~Zone() { if (begin >= 0) emit(category, name, begin, now() - begin); }
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+    private:
+        const char* category;
+        const char* name;
+        int64_t begin;
+    };
+
+    // Splits a hot loop between N phases without an event per iteration. mark(p) charges
+    // the time since the previous mark to the phase that was running and switches to p.
+    // On destruction it emits one zone for its whole lifetime and, inside it, one zone per
+    // phase with that phase's total, laid end to end: proportions, not the literal order.
+    template <int N>
+    class PhaseClock {
+    public:
+#ifdef MAZE_PROFILING
+        PhaseClock(const char* category, const char* name, const char* const (&phases)[N])
+            : category(category), name(name), phases(phases), active(recording()) {
+            if (active) begin = last = now();
+        }
+        void mark(int phase) {
+            if (!active) return;
+            int64_t t = now();
+            if (current >= 0) totals[current] += t - last;
+            last = t;
+            current = phase;
+        }
+        ~PhaseClock() {
+            if (!active) return;
+            mark(-1);
+            emit(category, name, begin, last - begin);
+            int64_t at = begin;
+            for (int i = 0; i < N; ++i) {
+                if (totals[i] == 0) continue;
+                emit(category, phases[i], at, totals[i]);
+                at += totals[i];
+            }
+        }
+    private:
+        const char* category;
+        const char* name;
+        const char* const (&phases)[N];
+        bool active;
+        int64_t begin = 0, last = 0;
+        int current = -1;
+        int64_t totals[N] = {};
+#else
+        PhaseClock(const char*, const char*, const char* const (&)[N]) {}
+        void mark(int) {}
+#endif
+        PhaseClock(const PhaseClock&) = delete;
+        PhaseClock& operator=(const PhaseClock&) = delete;
+    };
+
+private:
+    static std::atomic<bool> enabled;
+    static const std::chrono::steady_clock::time_point epoch;
+};
+
+#ifdef MAZE_PROFILING
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(category, name) Profiler::Zone PROFILE_CONCAT(profileZone, __LINE__)(category, name)
+#define PROFILE_THREAD(name) Profiler::setThreadName(name)
+#else
+#define PROFILE_ZONE(category, name) ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+#endif
\ No newline at end of file
@@ -0,0 +1,102 @@
+#include "SearchStepper.h"
+#include "Utility.h"
+#include "Maze.h"
+#include "Profiler.h"
+
+SearchStepper::SearchStepper(SolveArena* shared) : arena(shared), allocationsBefore(0) {
+    if (!arena) {
+        ownArena.reset(new SolveArena());
+        arena = ownArena.get();
+        return;
+    }
+    // Counted before the reset, which may merge blocks the last run spilled into
+    allocationsBefore = arena->heapAllocations();
+    arena->reset();
+}
+
+void SearchStepper::finish(Status outcome, std::vector<Cell*> path, std::vector<SearchEvent>* events) {
+    state = outcome;
+    res.metrics.bytesAllocated = scratchBytes();
+    res.success = (outcome == Status::Found);
+    if (res.success) {
+        res.path = std::move(path);
+        res.metrics.pathLength = res.path.size();
+        res.metrics.pathCost = Utility::pathCost(res.path);
+        for (Cell* c : res.path) emit(events, c, SearchTrace::Path);
+    } else if (res.failure == FailureReason::None) {
+        res.failure = FailureReason::Exhausted;
+    }
+}
+
+void SearchStepper::finish(Status outcome, CompactPath route) {
+    if (outcome != Status::Found) {
+        finish(outcome, {}, nullptr);
+        return;
+    }
+    state = outcome;
+    res.metrics.bytesAllocated = scratchBytes();
+    res.success = true;
+    res.route = std::move(route);
+    res.metrics.pathLength = res.route.size();
+    res.metrics.pathCost = res.route.cost();
+}
+
+bool SearchStepper::rejectEarly(Maze& maze, Cell* start, Cell* goal) {
+    if (!start || !goal || !maze.isWalkable(start->x, start->y) || !maze.isWalkable(goal->x, goal->y)) {
+        res.failure = FailureReason::MissingEndpoints;
+    } else if (!maze.connected(start->x, start->y, goal->x, goal->y)) {
+        res.failure = FailureReason::Unreachable;
+    } else {
+        return false;
+    }
+    finish(Status::NoPath, {}, nullptr);
+    return true;
+}
+
+AlgorithmResult SearchStepper::run(SearchStepper& stepper, std::function<void(Cell*, Cell*)> stepCallback,
+                                   const std::atomic<bool>* cancel) {
+    PROFILE_ZONE("search", "solve");
+    std::vector<SearchEvent> events;
+    std::vector<SearchEvent>* sink = stepCallback ? &events : nullptr;
+    return drive(stepper, stepCallback != nullptr, [&](size_t n) {
+        stepper.step(n, sink);
+        if (events.empty()) return;
+        PROFILE_ZONE("search", "step callbacks");
+        for (const SearchEvent& e : events) {
+            if (e.type == SearchTrace::Visit) stepCallback(e.cell, nullptr);
+            else if (e.type == SearchTrace::Frontier) stepCallback(nullptr, e.cell);
+        }
+        events.clear();
+    }, cancel);
+}
+
+AlgorithmResult SearchStepper::drive(SearchStepper& stepper, bool animating, const std::function<void(size_t)>& batch,
+                                     const std::atomic<bool>* cancel) {
+    RobustTimer timer;
+
+    // [FIX] If animating (stepCallback exists), increase timeout to 5 minutes (300000ms)
+    // Otherwise keep 2 seconds for terminal benchmarks.
+    timer.start(animating ? 300000 : 2000);
+    bool cancelled = false;
+    while (!stepper.done() && !timer.isTimeout()) {
+        if (cancel && cancel->load(std::memory_order_relaxed)) {
+            cancelled = true;
+            break;
+        }
+        batch(BATCH);
+    }
+
+    long long elapsed = timer.stop();
+    AlgorithmResult result = stepper.takeResult();
+    result.metrics.timeTakenMs = elapsed;
+    result.metrics.heapAllocations = stepper.heapAllocations();
+    result.metrics.bytesAllocated = stepper.scratchBytes();   // Also when timed out
+    if (!stepper.done()) {
+        // Timed out or cancelled
+        result.success = false;
+        result.failure = cancelled ? FailureReason::Cancelled : FailureReason::TimedOut;
+        result.path.clear();
+        result.route = CompactPath();
+    }
+    return result;
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+#include "Cell.h"
+#include "Types.h"
+#include "SearchTrace.h"
+#include "SolveArena.h"
+
+class Maze;
+
+// What a search did during a step: expanded a cell, pushed a frontier cell,
+// or (once the goal is reached) the final path, in order from start to goal.
+struct SearchEvent {
+    Cell* cell;
+    SearchTrace::EventType type;
+};
+
+// Resumable form of a solver. The object owns its open set and bookkeeping, so a
+// caller can expand a few nodes, draw, and come back later - or interleave several
+// searches on one thread. Cost/parent state still lives in the Maze's cells, so run
+// at most one stepper per Maze at a time (use separate Maze copies to interleave).
+//
+// Open lists, closed sets and other per-search arrays come from a SolveArena. Pass one
+// in to reuse its memory across searches (it is reset here); otherwise the stepper
+// makes its own.
+class SearchStepper {
+public:
+    enum class Status { Running, Found, NoPath };
+
+    explicit SearchStepper(SolveArena* arena = nullptr);
+    virtual ~SearchStepper() = default;
+
+    // Expands up to n nodes. If 'events' is non-null, what happened is appended to it.
+    virtual Status step(size_t n, std::vector<SearchEvent>* events = nullptr) = 0;
+
+    Status status() const { return state; }
+    bool done() const { return state != Status::Running; }
+
+    // Visit order so far; path and metrics once done(). Timing is left to the caller.
+    const AlgorithmResult& result() const { return res; }
+    // Hands the result over without copying; for drivers done with the stepper
+    AlgorithmResult takeResult() { return std::move(res); }
+
+    // Compact: count expansions without recording them and keep the path as a route.
+    // Set before the first step().
+    void setDetail(ResultDetail level) { detail = level; }
+
+    // Heap allocations the search's temporaries have caused so far
+    size_t heapAllocations() const { return arena->heapAllocations() - allocationsBefore; }
+    // Bytes they have taken from the arena (a bump allocator, so regrown vectors count twice)
+    size_t scratchBytes() const { return arena->bytesInUse(); }
+
+    // Drives the stepper to the end through drive(), forwarding expansions/pushes to the
+    // old-style callback
+    static AlgorithmResult run(SearchStepper& stepper, std::function<void(Cell*, Cell*)> stepCallback,
+                               const std::atomic<bool>* cancel = nullptr);
+
+    // The one run-to-completion loop behind run() and Search::solve: calls 'batch' (expand
+    // up to n nodes) until the search is done, the usual solver timeout passes (2 s, or
+    // 5 min when animating) or '*cancel' is set, then times the result and adds the
+    // allocation counters. Batches keep those checks off the per-node path.
+    static constexpr size_t BATCH = 256;
+    static AlgorithmResult drive(SearchStepper& stepper, bool animating, const std::function<void(size_t)>& batch,
+                                 const std::atomic<bool>* cancel = nullptr);
+
+protected:
+    Status state = Status::Running;
+    AlgorithmResult res;
+    ResultDetail detail = ResultDetail::Full;
+
+    std::pmr::memory_resource* scratch() const { return arena; }
+
+    static void emit(std::vector<SearchEvent>* events, Cell* cell, SearchTrace::EventType type) {
+        if (events) events->push_back({cell, type});
+    }
+
+    // Open-list bookkeeping for the search counters in res.metrics
+    void recordPush(size_t openSize) {
+        res.metrics.heapPushes++;
+        if (openSize > res.metrics.peakOpenSize) res.metrics.peakOpenSize = openSize;
+    }
+
+    void recordExpansion(Cell* cell) {
+        res.metrics.nodesExplored++;
+        if (detail == ResultDetail::Full) res.visitedOrder.push_back(cell);
+    }
+
+    // Records the outcome; on success fills in path metrics and emits the path
+    void finish(Status outcome, std::vector<Cell*> path, std::vector<SearchEvent>* events);
+    // Compact detail: the path as move codes, with no events to emit
+    void finish(Status outcome, CompactPath route);
+
+    // Ends the search before any expansion when an endpoint is missing or a wall, or when
+    // the maze's component index puts them apart. True if it did.
+    bool rejectEarly(Maze& maze, Cell* start, Cell* goal);
+
+private:
+    std::unique_ptr<SolveArena> ownArena;
+    SolveArena* arena;
+    size_t allocationsBefore;
+};
\ No newline at end of file
@@ -0,0 +1,100 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "Cell.h"
+
+// Compact record of everything a solver touched, in order, for replay.
+// Each event is (cell index, type). Consecutive events are usually spatially close,
+// so the index is stored as a zig-zag delta from the previous event and packed with
+// the 2-bit type into a varint: most events take 1-2 bytes in one flat buffer.
+class SearchTrace {
+public:
+    enum EventType : uint8_t { Visit = 0, Frontier = 1, Path = 2 };
+
+    struct Event {
+        uint32_t cell;
+        EventType type;
+    };
+
+    // Sequential decoder; replay just keeps one of these and pulls the next batch
+    class Cursor {
+    private:
+        const SearchTrace* trace = nullptr;
+        size_t pos = 0;
+        uint32_t last = 0;
+
+    public:
+        Cursor() = default;
+        explicit Cursor(const SearchTrace& t) : trace(&t) {}
+
+        bool done() const { return !trace || pos >= trace->bytes.size(); }
+
+        bool next(Event& event) {
+            if (done()) return false;
+            uint64_t v = 0;
+            int shift = 0;
+            uint8_t b;
+            do {
+                b = trace->bytes[pos++];
+                v |= uint64_t(b & 0x7F) << shift;
+                shift += 7;
+            } while (b & 0x80);
+
+            uint64_t zz = v >> 2;
+            int64_t delta = static_cast<int64_t>(zz >> 1) ^ -static_cast<int64_t>(zz & 1);
+            last = static_cast<uint32_t>(static_cast<int64_t>(last) + delta);
+            event.cell = last;
+            event.type = static_cast<EventType>(v & 3);
+            return true;
+        }
+    };
+
+    explicit SearchTrace(int width = 0) : width(width) {}
+
+    void record(uint32_t cell, EventType type) {
+        int64_t delta = static_cast<int64_t>(cell) - static_cast<int64_t>(last);
+        last = cell;
+        uint64_t zz = (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63);
+        uint64_t v = (zz << 2) | type;
+        while (v >= 0x80) {
+            bytes.push_back(static_cast<uint8_t>(v) | 0x80);
+            v >>= 7;
+        }
+        bytes.push_back(static_cast<uint8_t>(v));
+        ++events;
+    }
+
+    void record(const Cell* c, EventType type) {
+        record(static_cast<uint32_t>(c->y * width + c->x), type);
+    }
+
+    void recordPath(const std::vector<Cell*>& path) {
+        for (const Cell* c : path) record(c, Path);
+    }
+
+    // Drop-in stepCallback for the solvers: (visited, frontier)
+    std::function<void(Cell*, Cell*)> recorder() {
+        return [this](Cell* visited, Cell* frontier) {
+            if (visited) record(visited, Visit);
+            if (frontier) record(frontier, Frontier);
+        };
+    }
+
+    void clear() {
+        bytes.clear();
+        events = 0;
+        last = 0;
+    }
+
+    int getWidth() const { return width; }
+    size_t eventCount() const { return events; }
+    size_t byteSize() const { return bytes.size(); }
+
+private:
+    int width;
+    std::vector<uint8_t> bytes;
+    size_t events = 0;
+    uint32_t last = 0;
+};
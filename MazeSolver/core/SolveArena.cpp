@@ -0,0 +1,64 @@
+#include "SolveArena.h"
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+SolveArena::SolveArena(size_t initialBytes, std::pmr::memory_resource* upstream) : upstream(upstream) {
+    if (initialBytes > 0) grow(initialBytes);
+}
+
+SolveArena::~SolveArena() {
+    for (Block& b : blocks) upstream->deallocate(b.data, b.size, alignof(std::max_align_t));
+}
+
+size_t SolveArena::capacity() const {
+    size_t total = 0;
+    for (const Block& b : blocks) total += b.size;
+    return total;
+}
+
+void SolveArena::grow(size_t minimum) {
+    // Doubling keeps the number of blocks per solve logarithmic in its peak size
+    size_t size = std::max(minimum, blocks.empty() ? size_t(64 * 1024) : blocks.back().size * 2);
+    blocks.push_back({static_cast<std::byte*>(upstream->allocate(size, alignof(std::max_align_t))), size});
+    allocations++;
+}
+
+void SolveArena::reset() {
+    if (blocks.size() > 1) {
+        size_t total = capacity();
+        for (Block& b : blocks) upstream->deallocate(b.data, b.size, alignof(std::max_align_t));
+        blocks.clear();
+        grow(total);
+    }
+    current = 0;
+    offset = 0;
+    retired = 0;
+}
+
+void* SolveArena::do_allocate(size_t bytes, size_t alignment) {
+    while (true) {
+        if (current < blocks.size()) {
+            Block& b = blocks[current];
+            uintptr_t base = reinterpret_cast<uintptr_t>(b.data);
+            uintptr_t aligned = (base + offset + alignment - 1) & ~uintptr_t(alignment - 1);
+            if (aligned + bytes <= base + b.size) {
+                offset = aligned + bytes - base;
+                return reinterpret_cast<void*>(aligned);
+            }
+            if (current + 1 < blocks.size()) {
+                retired += offset;
+                current++;
+                offset = 0;
+                continue;
+            }
+        }
+        // Out of room: a fresh block big enough for this request even after alignment
+        if (current < blocks.size()) {
+            retired += offset;
+            current++;
+            offset = 0;
+        }
+        grow(bytes + alignment);
+    }
+}
\ No newline at end of file
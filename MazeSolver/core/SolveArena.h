@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+// Bump allocator for one solve's temporaries (open lists, closed sets, per-direction
+// labels, flood bitmaps). Nothing is freed until reset(), which rewinds to the start but
+// keeps the memory, so once the arena has grown to fit a query, further queries of that
+// size make no heap allocations at all. One solve at a time; not thread-safe.
+// Blocks come from 'upstream', e.g. a GridMemory resource for huge-page backing.
+class SolveArena : public std::pmr::memory_resource {
+public:
+    explicit SolveArena(size_t initialBytes = 64 * 1024,
+                        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    ~SolveArena() override;
+    SolveArena(const SolveArena&) = delete;
+    SolveArena& operator=(const SolveArena&) = delete;
+
+    // Rewinds for the next solve. If the last one spilled into several blocks they are
+    // merged into one, so the next run of the same size fits without growing.
+    void reset();
+
+    // Blocks taken from upstream over the arena's lifetime
+    size_t heapAllocations() const { return allocations; }
+    size_t bytesInUse() const { return retired + offset; }
+    size_t capacity() const;
+
+private:
+    struct Block {
+        std::byte* data;
+        size_t size;
+    };
+    std::pmr::memory_resource* upstream;
+    std::vector<Block> blocks;
+    size_t current = 0;         // Block being carved
+    size_t offset = 0;          // Bytes used in it
+    size_t retired = 0;         // Bytes used in the blocks before it
+    size_t allocations = 0;
+
+    void grow(size_t minimum);
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread.
+// Capacity is rounded up to a power of two so wrapping is a mask. Each side keeps a
+// cached copy of the other side's index and only reloads it when the ring looks
+// full/empty, so the shared cache lines are touched rarely.
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t minCapacity) {
+        size_t capacity = 2;
+        while (capacity < minCapacity) capacity <<= 1;
+        slots.resize(capacity);
+        mask = capacity - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer only. Returns false instead of waiting when the ring is full.
+    bool push(const T& item) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h - cachedTail == slots.size()) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (h - cachedTail == slots.size()) return false;
+        }
+        slots[h & mask] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only. Returns false when the ring is empty.
+    bool pop(T& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t == cachedHead) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (t == cachedHead) return false;
+        }
+        item = slots[t & mask];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t capacity() const { return slots.size(); }
+
+private:
+    std::vector<T> slots;
+    size_t mask = 0;
+
+    // Producer's line
+    alignas(64) std::atomic<size_t> head{0};
+    size_t cachedTail = 0;
+
+    // Consumer's line
+    alignas(64) std::atomic<size_t> tail{0};
+    size_t cachedHead = 0;
+};
\ No newline at end of file
@@ -0,0 +1,262 @@
+#include "TiledMaze.h"
+#include "Maze.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cstring>
+
+static const char TILED_MAGIC[8] = {'M', 'A', 'Z', 'E', 'T', 'I', 'L', '\0'};
+
+namespace {
+    uint64_t splitmix64(uint64_t x) {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+}
+
+bool TiledMaze::write(const std::string& path, int width, int height, int tileSize,
+                      const std::function<bool(int, int)>& wall,
+                      int startX, int startY, int goalX, int goalY, uint32_t seed, std::string& error) {
+    if (width <= 0 || height <= 0 || tileSize <= 0 || tileSize % 64 != 0) {
+        error = "Tile size must be a positive multiple of 64 and the maze non-empty";
+        return false;
+    }
+    TiledMazeHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, TILED_MAGIC, sizeof(TILED_MAGIC));
+    h.version = VERSION;
+    h.headerSize = sizeof(TiledMazeHeader);
+    h.width = width;
+    h.height = height;
+    h.tileSize = tileSize;
+    h.tilesX = (width + tileSize - 1) / tileSize;
+    h.tilesY = (height + tileSize - 1) / tileSize;
+    h.startX = startX;
+    h.startY = startY;
+    h.goalX = goalX;
+    h.goalY = goalY;
+    h.seed = seed;
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        error = "Cannot open '" + path + "' for writing";
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+
+    // One band of tiles at a time: tileSize rows across the whole width
+    const size_t rowWords = tileSize / 64;
+    const size_t words = rowWords * tileSize;
+    std::vector<uint64_t> band(words * h.tilesX);
+    for (uint32_t ty = 0; ty < h.tilesY; ++ty) {
+        std::fill(band.begin(), band.end(), ~uint64_t(0));    // Padding stays wall
+        for (int ly = 0; ly < tileSize; ++ly) {
+            int y = static_cast<int>(ty) * tileSize + ly;
+            if (y >= height) break;
+            for (int x = 0; x < width; ++x) {
+                if (wall(x, y)) continue;
+                int lx = x % tileSize;
+                band[(x / tileSize) * words + ly * rowWords + lx / 64] &= ~(uint64_t(1) << (lx & 63));
+            }
+        }
+        out.write(reinterpret_cast<const char*>(band.data()), band.size() * sizeof(uint64_t));
+        if (!out) {
+            error = "Write to '" + path + "' failed";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TiledMaze::save(Maze& maze, const std::string& path, int tileSize, std::string& error) {
+    if (!maze.getStart() || !maze.getGoal()) {
+        error = "Maze has no start or goal";
+        return false;
+    }
+    return write(path, maze.getWidth(), maze.getHeight(), tileSize,
+                 [&](int x, int y) { return !maze.isWalkable(x, y); },
+                 maze.getStart()->x, maze.getStart()->y, maze.getGoal()->x, maze.getGoal()->y, maze.getSeed(), error);
+}
+
+bool TiledMaze::generate(const std::string& path, int width, int height, int tileSize,
+                         double density, uint32_t seed, std::string& error) {
+    const int gx = width - 2, gy = height - 2;
+    const uint64_t threshold = static_cast<uint64_t>(std::clamp(density, 0.0, 1.0) * 9007199254740992.0);   // 2^53
+    const uint64_t salt = splitmix64(seed);
+    auto wall = [&](int x, int y) {
+        if (x == 0 || y == 0 || x == width - 1 || y == height - 1) return true;
+        if ((x == 1 && y == 1) || (x == gx && y == gy)) return false;
+        return (splitmix64(salt ^ (static_cast<uint64_t>(y) * width + x)) >> 11) < threshold;
+    };
+    return write(path, width, height, tileSize, wall, 1, 1, gx, gy, seed, error);
+}
+
+std::unique_ptr<TiledMaze> TiledMaze::open(const std::string& path, size_t cacheTiles, std::string& error) {
+    std::unique_ptr<TiledMaze> maze(new TiledMaze());
+    maze->path = path;
+    maze->reader.open(path, std::ios::binary);
+    if (!maze->reader) {
+        error = "Cannot open '" + path + "'";
+        return nullptr;
+    }
+    TiledMazeHeader& h = maze->header;
+    if (!maze->reader.read(reinterpret_cast<char*>(&h), sizeof(h)) ||
+        std::memcmp(h.magic, TILED_MAGIC, sizeof(TILED_MAGIC)) != 0) {
+        error = "'" + path + "' is not a tiled maze file";
+        return nullptr;
+    }
+    if (h.version != VERSION || h.headerSize < sizeof(TiledMazeHeader)) {
+        error = "Unsupported tiled maze version " + std::to_string(h.version);
+        return nullptr;
+    }
+    if (h.width == 0 || h.height == 0 || h.width > INT32_MAX || h.height > INT32_MAX ||
+        h.tileSize == 0 || h.tileSize % 64 != 0 ||
+        h.tilesX != (h.width + h.tileSize - 1) / h.tileSize || h.tilesY != (h.height + h.tileSize - 1) / h.tileSize) {
+        error = "Corrupt tiled maze header";
+        return nullptr;
+    }
+    maze->wordsPerTileRow = h.tileSize / 64;
+    maze->tileWords = maze->wordsPerTileRow * h.tileSize;
+
+    maze->reader.seekg(0, std::ios::end);
+    uint64_t expected = h.headerSize + static_cast<uint64_t>(h.tilesX) * h.tilesY * maze->tileBytes();
+    if (static_cast<uint64_t>(maze->reader.tellg()) < expected) {
+        error = "'" + path + "' is truncated";
+        return nullptr;
+    }
+    maze->prefetchReader.open(path, std::ios::binary);
+    maze->capacity = std::max<size_t>(cacheTiles, 1);
+    maze->prefetcher = std::thread(&TiledMaze::prefetchLoop, maze.get());
+    return maze;
+}
+
+TiledMaze::~TiledMaze() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    if (prefetcher.joinable()) prefetcher.join();
+}
+
+bool TiledMaze::isWalkable(int x, int y) {
+    if (x < 0 || y < 0 || x >= getWidth() || y >= getHeight()) return false;
+    uint64_t id = tileId(x, y);
+    if (id != lastId) {
+        lastTile = fetch(id);
+        lastId = id;
+    }
+    int lx = x % header.tileSize, ly = y % header.tileSize;
+    return !(((*lastTile)[ly * wordsPerTileRow + lx / 64] >> (lx & 63)) & 1u);
+}
+
+bool TiledMaze::canStep(int x, int y, int dx, int dy) {
+    if (!isWalkable(x + dx, y + dy)) return false;
+    if (dx != 0 && dy != 0) return isWalkable(x + dx, y) && isWalkable(x, y + dy);
+    return true;
+}
+
+void TiledMaze::prefetchAhead(int x, int y, int dx, int dy) {
+    int margin = header.tileSize / 4;
+    int ax = x + dx * margin, ay = y + dy * margin;
+    if (ax < 0 || ay < 0 || ax >= getWidth() || ay >= getHeight()) return;
+    uint64_t id = tileId(ax, ay);
+    if (id == lastPrefetch || id == tileId(x, y)) return;
+    lastPrefetch = id;
+    
+    std::lock_guard<std::mutex> guard(lock);
+    if (tiles.count(id) || reading == id || std::find(queue.begin(), queue.end(), id) != queue.end()) return;
+    if (queue.size() >= MAX_QUEUED) queue.pop_front();
+    queue.push_back(id);
+    wake.notify_one();
+}
+
+TiledMaze::CacheStats TiledMaze::stats() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return counters;
+}
+
+void TiledMaze::resetStats() {
+    std::lock_guard<std::mutex> guard(lock);
+    counters = CacheStats();
+}
+
+std::shared_ptr<const TiledMaze::Tile> TiledMaze::fetch(uint64_t id) {
+    std::unique_lock<std::mutex> guard(lock);
+    counters.lookups++;
+    while (true) {
+        auto it = tiles.find(id);
+        if (it != tiles.end()) {
+            counters.hits++;
+            if (it->second.prefetched) {
+                counters.prefetchHits++;
+                it->second.prefetched = false;
+            }
+            recency.splice(recency.begin(), recency, it->second.position);
+            return it->second.bits;
+        }
+        if (reading != id) break;
+        // Already being read ahead: waiting is cheaper than reading it twice
+        loaded.wait(guard);
+    }
+    
+    // Queued but not started: read it here instead
+    auto queued = std::find(queue.begin(), queue.end(), id);
+    if (queued != queue.end()) queue.erase(queued);
+    counters.misses++;
+    guard.unlock();
+    
+    auto bits = std::make_shared<Tile>(tileWords);
+    // A failed read leaves the tile all walls: the search sees a dead region, not garbage
+    if (!readTile(reader, id, *bits)) std::fill(bits->begin(), bits->end(), ~uint64_t(0));
+    
+    guard.lock();
+    counters.bytesRead += tileBytes();
+    insert(id, bits, false);
+    return bits;
+}
+
+bool TiledMaze::readTile(std::ifstream& in, uint64_t id, Tile& out) {
+    PROFILE_ZONE("io", "read tile");
+    in.clear();
+    in.seekg(static_cast<std::streamoff>(header.headerSize + id * tileBytes()));
+    in.read(reinterpret_cast<char*>(out.data()), static_cast<std::streamsize>(tileBytes()));
+    return static_cast<bool>(in);
+}
+
+void TiledMaze::insert(uint64_t id, std::shared_ptr<const Tile> bits, bool prefetched) {
+    if (tiles.count(id)) return;
+    recency.push_front(id);
+    tiles.emplace(id, Entry{std::move(bits), recency.begin(), prefetched});
+    while (tiles.size() > capacity) {
+        tiles.erase(recency.back());
+        recency.pop_back();
+        counters.evictions++;
+    }
+}
+
+void TiledMaze::prefetchLoop() {
+    PROFILE_THREAD("tile prefetch");
+    std::unique_lock<std::mutex> guard(lock);
+    while (true) {
+        wake.wait(guard, [&] { return stopping || !queue.empty(); });
+        if (stopping) return;
+        uint64_t id = queue.front();
+        queue.pop_front();
+        if (tiles.count(id)) continue;
+        
+        reading = id;
+        guard.unlock();
+        auto bits = std::make_shared<Tile>(tileWords);
+        bool ok = readTile(prefetchReader, id, *bits);
+        guard.lock();
+        reading = UINT64_MAX;
+        if (ok) {
+            counters.prefetches++;
+            counters.bytesRead += tileBytes();
+            insert(id, std::move(bits), true);
+        }
+        loaded.notify_all();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,136 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class Maze;
+
+// On-disk layout (version 1, little-endian):
+//   [TiledMazeHeader, 64 bytes][tiles, row by row of tiles]
+// A tile is tileSize x tileSize cells, one bit per cell (1 = wall), each tile row padded
+// to whole 64-bit words, so a tile is one contiguous read. Tiles past the right and bottom
+// edges are padded with walls.
+struct TiledMazeHeader {
+    char magic[8];              // "MAZETIL\0"
+    uint32_t version;
+    uint32_t headerSize;        // Offset of the first tile
+    uint32_t width;
+    uint32_t height;
+    uint32_t tileSize;          // Cells per tile side, a multiple of 64
+    uint32_t tilesX, tilesY;
+    uint32_t startX, startY;
+    uint32_t goalX, goalY;
+    uint32_t seed;
+    uint8_t reserved[8];
+};
+static_assert(sizeof(TiledMazeHeader) == 64, "TiledMazeHeader must stay 64 bytes");
+
+// A maze that never has to be resident: walls are read tile by tile through a bounded
+// LRU cache, and a background thread reads ahead the tiles a search is heading for.
+// Wall queries are for one search thread at a time; prefetching is its own thread.
+class TiledMaze {
+public:
+    static constexpr uint32_t VERSION = 1;
+    static constexpr int DEFAULT_TILE = 256;
+    static constexpr size_t MAX_QUEUED = 16;  // Oldest read-ahead requests are dropped past this
+
+    // Counted per tile switch: consecutive queries inside the last tile are free
+    struct CacheStats {
+        size_t lookups = 0;         // Queries that left the previous tile
+        size_t hits = 0;            // ... and found the new one cached
+        size_t misses = 0;          // ... and read it on the search thread
+        size_t prefetches = 0;      // Tiles read ahead by the background thread
+        size_t prefetchHits = 0;    // Hits on a tile the prefetcher brought in
+        size_t evictions = 0;
+        uint64_t bytesRead = 0;     // Demand reads and prefetches
+        double hitRate() const { return lookups ? double(hits) / lookups : 0.0; }
+    };
+
+    // Streams a tiled file from wall(x, y) one band of tiles at a time, so the maze
+    // being written is never in memory either. Returns false and fills 'error' on failure.
+    static bool write(const std::string& path, int width, int height, int tileSize,
+                      const std::function<bool(int, int)>& wall,
+                      int startX, int startY, int goalX, int goalY, uint32_t seed, std::string& error);
+    static bool save(Maze& maze, const std::string& path, int tileSize, std::string& error);
+    // Synthetic obstacle field: walled border, each inner cell a wall with probability
+    // 'density' (hashed from the seed, so any size is reproducible), endpoints kept open
+    static bool generate(const std::string& path, int width, int height, int tileSize,
+                         double density, uint32_t seed, std::string& error);
+
+    // Validates the header and starts the prefetch thread. 'cacheTiles' bounds residency.
+    static std::unique_ptr<TiledMaze> open(const std::string& path, size_t cacheTiles, std::string& error);
+    ~TiledMaze();
+    TiledMaze(const TiledMaze&) = delete;
+    TiledMaze& operator=(const TiledMaze&) = delete;
+
+    int getWidth() const { return static_cast<int>(header.width); }
+    int getHeight() const { return static_cast<int>(header.height); }
+    int getTileSize() const { return static_cast<int>(header.tileSize); }
+    int getStartX() const { return static_cast<int>(header.startX); }
+    int getStartY() const { return static_cast<int>(header.startY); }
+    int getGoalX() const { return static_cast<int>(header.goalX); }
+    int getGoalY() const { return static_cast<int>(header.goalY); }
+    size_t cacheCapacity() const { return capacity; }
+    size_t tileBytes() const { return tileWords * sizeof(uint64_t); }
+
+    // Anything outside the maze counts as wall
+    bool isWalkable(int x, int y);
+    // Same corner-cutting rule as Maze::canStep
+    bool canStep(int x, int y, int dx, int dy);
+    // Moving (dx, dy) from (x, y): queue the next tile over once we are within a quarter
+    // tile of its edge. Cheap when there is nothing to do; never blocks on I/O.
+    void prefetchAhead(int x, int y, int dx, int dy);
+
+    CacheStats stats() const;
+    void resetStats();
+
+private:
+    using Tile = std::vector<uint64_t>;
+    struct Entry {
+        std::shared_ptr<const Tile> bits;
+        std::list<uint64_t>::iterator position;
+        bool prefetched;            // Read ahead and not used yet
+    };
+
+    TiledMazeHeader header{};
+    std::string path;
+    size_t tileWords = 0;
+    size_t wordsPerTileRow = 0;
+    size_t capacity = 0;
+    std::ifstream reader;           // Search thread's handle
+    std::ifstream prefetchReader;   // Prefetch thread's handle
+
+    // Search thread's last tile, so queries inside it skip the lock
+    uint64_t lastId = UINT64_MAX;
+    std::shared_ptr<const Tile> lastTile;
+    uint64_t lastPrefetch = UINT64_MAX;
+
+    mutable std::mutex lock;
+    std::condition_variable wake;   // Prefetch queue non-empty, or stopping
+    std::condition_variable loaded; // A prefetch landed
+    std::unordered_map<uint64_t, Entry> tiles;
+    std::list<uint64_t> recency;    // Front = most recently used
+    std::deque<uint64_t> queue;
+    uint64_t reading = UINT64_MAX;  // Tile the prefetch thread is reading now
+    bool stopping = false;
+    CacheStats counters;
+    std::thread prefetcher;
+
+    TiledMaze() = default;
+    uint64_t tileId(int x, int y) const {
+        return static_cast<uint64_t>(y / header.tileSize) * header.tilesX + static_cast<uint64_t>(x / header.tileSize);
+    }
+    std::shared_ptr<const Tile> fetch(uint64_t id);
+    bool readTile(std::ifstream& in, uint64_t id, Tile& out);
+    void insert(uint64_t id, std::shared_ptr<const Tile> bits, bool prefetched);
+    void prefetchLoop();
+};
\ No newline at end of file
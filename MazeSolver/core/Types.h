@@ -1,16 +1,55 @@
 #pragma once
 #include <vector>
+#include <cstddef>
+#include "CompactPath.h"
 
 // Forward declarations
 struct Cell;
 class Maze;
 
+// 4-connected: orthogonal steps only (cost 1).
+// 8-connected: adds diagonal steps (cost sqrt 2) that may not cut wall corners.
+enum class MovementMode { FourWay, EightWay };
+
+// Why a search came back without a path
+enum class FailureReason {
+    None,               // Found a path (or hasn't finished)
+    MissingEndpoints,   // Start or goal outside the maze, or a wall
+    Unreachable,        // Start and goal in different components: rejected before searching
+    Exhausted,          // Searched everything reachable without meeting the goal
+    TimedOut,           // Hit the solver timeout
+    Cancelled           // Stopped by the caller (a GUI solve replaced or abandoned)
+};
+
+// How much a solver keeps besides the metrics.
+// Full: every expansion in visitedOrder and the path as Cell* (display, animation).
+// Compact: no trace and the path only as 'route' - all a benchmark reads.
+enum class ResultDetail { Full, Compact };
+
 struct Metrics {
     size_t pathLength = 0;
     size_t nodesExplored = 0;
     long long timeTakenMs = 0;
+    double pathCost = 0.0;
+    size_t heapAllocations = 0;     // Made by the solver's temporaries (not the returned path)
+
+    // Search counters. Solvers without an open list (the bit-parallel floods) leave the heap ones at 0.
+    size_t heapPushes = 0;
+    size_t heapPops = 0;            // Including stale pops
+    size_t stalePops = 0;           // Popped cells that were already closed
+    size_t peakOpenSize = 0;
+    size_t reopenings = 0;          // Cheaper paths found to closed cells; 0 with a consistent heuristic
+    size_t heuristicEvaluations = 0;
+    size_t bytesAllocated = 0;      // Scratch memory the solver's temporaries used
     
-    Metrics() : pathLength(0), nodesExplored(0), timeTakenMs(0) {}
+    Metrics() : pathLength(0), nodesExplored(0), timeTakenMs(0), pathCost(0.0), heapAllocations(0),
+                heapPushes(0), heapPops(0), stalePops(0), peakOpenSize(0), reopenings(0),
+                heuristicEvaluations(0), bytesAllocated(0) {}
+
+    // timeTakenMs holds microseconds
+    double expansionsPerSecond() const {
+        return timeTakenMs > 0 ? nodesExplored * 1e6 / timeTakenMs : 0.0;
+    }
 };
 
 struct RobustMetrics {
@@ -24,10 +63,12 @@ struct RobustMetrics {
 };
 
 struct AlgorithmResult {
-    std::vector<Cell*> path;
-    std::vector<Cell*> visitedOrder;
+    std::vector<Cell*> path;            // Full detail only
+    std::vector<Cell*> visitedOrder;    // Full detail only; nodesExplored counts either way
+    CompactPath route;                  // Compact detail only
     Metrics metrics;
     bool success = false;
+    FailureReason failure = FailureReason::None;
     
     AlgorithmResult() : success(false) {}
 };
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "Utility.h"
 #include "Maze.h"
 #include "AlgorithmResult.h"
+#include "Profiler.h"
 #include <algorithm>
 #include <cmath>
 #include <numeric>
@@ -10,30 +11,18 @@
 // RobustTimer implementation
 void RobustTimer::start(long long timeout_ms) {
     start_time = std::chrono::high_resolution_clock::now();
-    timeout_flag = false;
-    
-    // Start timeout thread
-    timeout_thread = std::thread([this, timeout_ms]() {
-        std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
-        timeout_flag = true;
-    });
+    deadline = start_time + std::chrono::milliseconds(timeout_ms);
 }
 
 long long RobustTimer::stop() {
     auto end_time = std::chrono::high_resolution_clock::now();
-    
-    // Stop timeout thread
-    if (timeout_thread.joinable()) {
-        timeout_thread.detach(); // Detach to avoid blocking
-    }
-    
     auto micro = std::chrono::duration_cast<std::chrono::microseconds>(
         end_time - start_time).count();
     return micro > 0 ? micro : 1;
 }
 
 bool RobustTimer::isTimeout() const {
-    return timeout_flag.load();
+    return std::chrono::high_resolution_clock::now() >= deadline;
 }
 
 // TimeoutTimer implementation
@@ -53,7 +42,42 @@ double Utility::manhattanDistance(const Cell* a, const Cell* b) {
     return std::abs(a->x - b->x) + std::abs(a->y - b->y);
 }
 
+double Utility::octileDistance(const Cell* a, const Cell* b) {
+    int dx = std::abs(a->x - b->x);
+    int dy = std::abs(a->y - b->y);
+    // Take the shared part diagonally, the rest straight
+    return std::max(dx, dy) + (SQRT2 - 1.0) * std::min(dx, dy);
+}
+
+double Utility::heuristic(const Maze& maze, const Cell* a, const Cell* b) {
+    if (maze.getMovementMode() == MovementMode::EightWay) return octileDistance(a, b);
+    return manhattanDistance(a, b);
+}
+
+double Utility::stepCost(const Cell* a, const Cell* b) {
+    return (a->x != b->x && a->y != b->y) ? SQRT2 : 1.0;
+}
+
+double Utility::pathCost(const std::vector<Cell*>& path) {
+    double cost = 0.0;
+    for (size_t i = 1; i < path.size(); ++i) cost += stepCost(path[i-1], path[i]);
+    return cost;
+}
+
+const char* Utility::failureName(FailureReason reason) {
+    switch (reason) {
+        case FailureReason::None: return "none";
+        case FailureReason::MissingEndpoints: return "start or goal is missing or a wall";
+        case FailureReason::Unreachable: return "start and goal are not connected";
+        case FailureReason::Exhausted: return "search exhausted";
+        case FailureReason::TimedOut: return "timed out";
+        case FailureReason::Cancelled: return "cancelled";
+    }
+    return "unknown";
+}
+
 std::vector<Cell*> Utility::reconstructPath(Cell* endNode) {
+    PROFILE_ZONE("path", "reconstruct path");
     std::vector<Cell*> path;
     Cell* current = endNode;
     
@@ -66,11 +90,27 @@ std::vector<Cell*> Utility::reconstructPath(Cell* endNode) {
     return path;
 }
 
+CompactPath Utility::reconstructCompactPath(const Maze& maze, Cell* endNode) {
+    PROFILE_ZONE("path", "reconstruct path");
+    if (!endNode) return CompactPath();
+    // The parent chain runs goal to start: measure it, then fill the moves in from the back
+    size_t moves = 0;
+    Cell* root = endNode;
+    for (; root->parent; root = root->parent) moves++;
+    
+    const int width = maze.getWidth();
+    CompactPath path(static_cast<uint32_t>(root->y * width + root->x), width, maze.getMovementMode());
+    path.resize(moves);
+    for (Cell* c = endNode; c->parent; c = c->parent) path.set(--moves, c->x - c->parent->x, c->y - c->parent->y);
+    return path;
+}
+
 long long Utility::getCellKey(int x, int y) {
     return ((long long)x << 32) | (y & 0xFFFFFFFFLL);
 }
 
 bool Utility::validatePath(Maze& maze, const std::vector<Cell*>& path) {
+    PROFILE_ZONE("path", "validate");
     if (path.empty()) {
         std::cout << "VALIDATION FAILED: Empty path\n";
         return false;
@@ -85,33 +125,77 @@ bool Utility::validatePath(Maze& maze, const std::vector<Cell*>& path) {
     }
     
     for (size_t i = 1; i < path.size(); ++i) {
-        int dx = std::abs(path[i]->x - path[i-1]->x);
-        int dy = std::abs(path[i]->y - path[i-1]->y);
+        int dx = path[i]->x - path[i-1]->x;
+        int dy = path[i]->y - path[i-1]->y;
         
-        if (dx + dy != 1) {
+        if (std::abs(dx) > 1 || std::abs(dy) > 1 || (dx == 0 && dy == 0)) {
             std::cout << "VALIDATION FAILED: Non-adjacent cells at step " << i 
                       << ": (" << path[i-1]->x << "," << path[i-1]->y 
                       << ") -> (" << path[i]->x << "," << path[i]->y << ")\n";
             return false;
         }
         
-        if (path[i]->wall) {
+        if (!maze.isWalkable(path[i]->x, path[i]->y)) {
             std::cout << "VALIDATION FAILED: Path goes through wall at (" 
                       << path[i]->x << "," << path[i]->y << ")\n";
             return false;
         }
+        
+        if (!maze.canStep(path[i-1]->x, path[i-1]->y, dx, dy)) {
+            std::cout << "VALIDATION FAILED: Illegal diagonal step at " << i 
+                      << ": (" << path[i-1]->x << "," << path[i-1]->y 
+                      << ") -> (" << path[i]->x << "," << path[i]->y << ")\n";
+            return false;
+        }
     }
     
     return true;
 }
 
+bool Utility::validatePath(Maze& maze, const CompactPath& path) {
+    PROFILE_ZONE("path", "validate");
+    if (path.empty()) {
+        std::cout << "VALIDATION FAILED: Empty path\n";
+        return false;
+    }
+    const int width = maze.getWidth();
+    Cell* start = maze.getStart();
+    Cell* goal = maze.getGoal();
+    if (path.getWidth() != width || !start || path.startIndex() != static_cast<uint32_t>(start->y * width + start->x)) {
+        std::cout << "VALIDATION FAILED: Path doesn't start at start position\n";
+        return false;
+    }
+    
+    // Walk the moves in coordinates, so a step can't wrap around a row edge
+    int x = start->x, y = start->y;
+    for (size_t i = 0; i + 1 < path.size(); ++i) {
+        int dx = CompactPath::DX[path.move(i)];
+        int dy = CompactPath::DY[path.move(i)];
+        if (!maze.canStep(x, y, dx, dy)) {
+            std::cout << "VALIDATION FAILED: Illegal step at " << (i + 1)
+                      << ": (" << x << "," << y << ") -> (" << (x + dx) << "," << (y + dy) << ")\n";
+            return false;
+        }
+        x += dx;
+        y += dy;
+    }
+    
+    if (!goal || x != goal->x || y != goal->y) {
+        std::cout << "VALIDATION FAILED: Path doesn't end at goal position\n";
+        return false;
+    }
+    return true;
+}
+
 AlgorithmResult Utility::runAlgorithmSafely(Maze& maze, std::function<AlgorithmResult(Maze&)> algorithm) {
     AlgorithmResult result;
     
     try {
         result = algorithm(maze);
         
-        if (result.success && !validatePath(maze, result.path)) {
+        // Compact results carry only the route
+        if (result.success && !(result.route.empty() ? validatePath(maze, result.path)
+                                                     : validatePath(maze, result.route))) {
             result.success = false;
             std::cout << "⚠️  Path validation failed!\n";
         }
@@ -130,10 +214,7 @@ AlgorithmResult Utility::runAlgorithmSafely(Maze& maze, std::function<AlgorithmR
 }
 
 RobustMetrics Utility::runAlgorithmMultipleTimes(Maze& maze, std::function<AlgorithmResult(Maze&)> algorithm, int runs) {
-    RobustMetrics metrics;
     std::vector<long long> times;
-    metrics.successfulRuns = 0;
-    metrics.totalRuns = runs;
     
     for (int i = 0; i < runs; ++i) {
         std::cout << "Run " << (i+1) << "/" << runs << "... ";
@@ -141,7 +222,6 @@ RobustMetrics Utility::runAlgorithmMultipleTimes(Maze& maze, std::function<Algor
         
         if (result.success && result.metrics.timeTakenMs > 0) {
             times.push_back(result.metrics.timeTakenMs);
-            metrics.successfulRuns++;
             std::cout << "✓ (" << result.metrics.timeTakenMs << " μs)\n";
         } else {
             std::cout << "✗ (Failed)\n";
@@ -150,6 +230,16 @@ RobustMetrics Utility::runAlgorithmMultipleTimes(Maze& maze, std::function<Algor
         std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
     
+    RobustMetrics summary = summarizeTimes(times);
+    summary.totalRuns = runs;
+    return summary;
+}
+
+RobustMetrics Utility::summarizeTimes(std::vector<long long> times) {
+    RobustMetrics metrics;
+    metrics.successfulRuns = static_cast<int>(times.size());
+    metrics.totalRuns = static_cast<int>(times.size());
+    
     if (!times.empty()) {
         std::sort(times.begin(), times.end());
         metrics.bestTime = times.front();
@@ -9,11 +9,11 @@
 // Forward declaration
 class Maze;
 
+// Deadline checked against the clock: no helper thread that could outlive the timer
 class RobustTimer {
 private:
     std::chrono::time_point<std::chrono::high_resolution_clock> start_time;
-    std::atomic<bool> timeout_flag{false};
-    std::thread timeout_thread;
+    std::chrono::time_point<std::chrono::high_resolution_clock> deadline;
     
 public:
     void start(long long timeout_ms = 5000);
@@ -32,10 +32,25 @@ public:
 };
 
 namespace Utility {
+    constexpr double SQRT2 = 1.41421356237309504880;
+    
     double manhattanDistance(const Cell* a, const Cell* b);
+    double octileDistance(const Cell* a, const Cell* b);
+    // Admissible heuristic for the maze's movement mode (Manhattan or octile)
+    double heuristic(const Maze& maze, const Cell* a, const Cell* b);
+    // Cost of a single step between adjacent cells (1 or sqrt 2)
+    double stepCost(const Cell* a, const Cell* b);
+    double pathCost(const std::vector<Cell*>& path);
     std::vector<Cell*> reconstructPath(Cell* endNode);
+    // Same walk up the parent chain, straight into move codes
+    CompactPath reconstructCompactPath(const Maze& maze, Cell* endNode);
     long long getCellKey(int x, int y);
     bool validatePath(Maze& maze, const std::vector<Cell*>& path);
+    bool validatePath(Maze& maze, const CompactPath& path);
     AlgorithmResult runAlgorithmSafely(Maze& maze, std::function<AlgorithmResult(Maze&)> algorithm);
     RobustMetrics runAlgorithmMultipleTimes(Maze& maze, std::function<AlgorithmResult(Maze&)> algorithm, int runs = 3);
+    // Short human-readable form, e.g. "start and goal are not connected"
+    const char* failureName(FailureReason reason);
+    // Best/worst/mean/median/stddev over a set of run times (μs)
+    RobustMetrics summarizeTimes(std::vector<long long> times);
 }
\ No newline at end of file
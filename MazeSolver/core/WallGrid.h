@@ -0,0 +1,24 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Non-owning view of a bit-packed wall bitmap.
+// One bit per cell (1 = wall), row-major, every row padded to whole 64-bit words
+// so a row always starts on a word boundary. Bit (x % 64) of word (x / 64) is cell x.
+struct WallGrid {
+    int width = 0;
+    int height = 0;
+    size_t wordsPerRow = 0;
+    const uint64_t* words = nullptr;
+
+    static size_t wordsForWidth(int width) { return (static_cast<size_t>(width) + 63) / 64; }
+
+    bool empty() const { return words == nullptr; }
+    size_t wordCount() const { return wordsPerRow * static_cast<size_t>(height); }
+
+    // Anything outside the grid counts as wall
+    bool isWall(int x, int y) const {
+        if (x < 0 || x >= width || y < 0 || y >= height) return true;
+        return (words[static_cast<size_t>(y) * wordsPerRow + (x >> 6)] >> (x & 63)) & 1u;
+    }
+};
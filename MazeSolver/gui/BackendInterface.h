@@ -1,14 +1,15 @@
 #pragma once
+#include <atomic>
 #include <vector>
 #include <functional>
+#include <memory>
 #include <thread>
-#include <chrono>
-#include <QCoreApplication> 
-#include <QThread>
 
 #include "Types.h"
 #include "../core/Maze.h"
 #include "../core/Utility.h"
+#include "../core/Profiler.h"
+#include "SolveSession.h"
 #include "../algorithms/Dijkstra.h"
 #include "../algorithms/AStar.h"
 #include "../algorithms/DoubleAStar.h"
@@ -17,22 +18,54 @@
 enum class MazeGenerator { RecursiveBacktracker };
 enum class PathfindingAlgorithm { Dijkstra, AStar, BidirectionalAStar, JumpPointSearch };
 
-struct AnimationFrame {
-    std::vector<Cell*> visitedCells;
-    std::vector<Cell*> currentCells;
-    std::vector<Cell*> pathCells;
-};
-
 // [SINGLETON FIX] This class guarantees only ONE maze exists
 class BackendInterface {
 private:
     Maze* globalMaze = nullptr;
+    MovementMode movementMode = MovementMode::FourWay;
+
+    // At most one solve or generation runs at a time, on 'worker'
+    std::thread worker;
+    std::shared_ptr<SolveSession> activeSolve;
+
+    // A generation builds its maze off to the side; the GUI keeps showing (and the
+    // layout calls keep reading) globalMaze until pollGenerate() swaps the new one in
+    bool generating = false;
+    std::atomic<bool> generationDone{false};
+    std::unique_ptr<Maze> generatedMaze;
+
+    // Step Forward runs a resumable search on the GUI thread instead
+    std::unique_ptr<SearchStepper> stepper;
+    PathfindingAlgorithm stepperAlgorithm = PathfindingAlgorithm::AStar;
 
     // Private Constructor
     BackendInterface() {
         globalMaze = new Maze(21, 21); // Default maze on startup
     }
 
+    ~BackendInterface() {
+        // No callbacks here: the widgets they point at are already gone
+        if (activeSolve) activeSolve->cancel();
+        if (worker.joinable()) worker.join();
+    }
+
+    // Anything that touches the maze must stop the worker first. The search checks the
+    // cancel flag between batches, so this returns within one batch, not one solve.
+    // A generation can't be cancelled; it is waited for and its maze installed.
+    void stopSolve() {
+        if (activeSolve) activeSolve->cancel();
+        if (worker.joinable()) worker.join();
+        if (generating) installGeneratedMaze();
+    }
+
+    void installGeneratedMaze() {
+        generating = false;
+        delete globalMaze;
+        globalMaze = generatedMaze.release();
+        globalMaze->setMovementMode(movementMode);
+        if (onMazeGenerated) onMazeGenerated();
+    }
+
 public:
     // Delete copy constructors to prevent duplicates
     BackendInterface(const BackendInterface&) = delete;
@@ -45,30 +78,62 @@ public:
     }
 
     // Signals
+    std::function<void()> onGenerateStarted;
     std::function<void()> onMazeGenerated;
-    std::function<void(const AnimationFrame&)> onAnimationFrame;
+    std::function<void(std::shared_ptr<SolveSession>)> onSolveStarted;
+    std::function<void()> onStepStarted;
+    std::function<void(const std::vector<SearchEvent>&)> onStepEvents;
     std::function<void(const AlgorithmResult&)> onSolveComplete;
 
-    void generateMaze(int width, int height, MazeGenerator type) {
+    void generateMaze(int width, int height, MazeGenerator type,
+                      const GeneratorOptions& options = GeneratorOptions()) {
         (void)type;
-        if (globalMaze) delete globalMaze;
-        globalMaze = new Maze(width, height); // This generates the maze
-        if (onMazeGenerated) onMazeGenerated();
+        stopSolve();
+        activeSolve.reset();
+        stepper.reset();
+
+        // Carving a 10k x 10k maze takes seconds, so it runs on the worker like a solve
+        generating = true;
+        generationDone.store(false, std::memory_order_relaxed);
+        worker = std::thread([this, width, height, options]() {
+            PROFILE_THREAD("generate worker");
+            generatedMaze = std::make_unique<Maze>(width, height, options); // This generates the maze
+            generationDone.store(true, std::memory_order_release);
+        });
+        if (onGenerateStarted) onGenerateStarted();
+    }
+
+    // Called from the GUI thread's frame timer. Installs the new maze once the worker is done.
+    void pollGenerate() {
+        if (!generating || !generationDone.load(std::memory_order_acquire)) return;
+        if (worker.joinable()) worker.join();
+        installGeneratedMaze();
+    }
+
+    void setMovementMode(MovementMode mode) {
+        if (mode == movementMode) return;
+        movementMode = mode;
+        stopSolve();
+        stepper.reset();
+        if (globalMaze) globalMaze->setMovementMode(mode);
     }
 
     MazeState getCurrentMazeState() {
         if (!globalMaze) return MazeState(21, 21);
 
         MazeState state(globalMaze->getWidth(), globalMaze->getHeight());
-        auto& coreCells = globalMaze->getCells();
         state.cells.clear();
         
-        // Convert Core Cells to GUI Cells
-        for (const auto& c : coreCells) {
-            // IMPORTANT: Copy the 'wall' and 'visited' status correctly
-            Cell guiCell(c.x, c.y, c.wall);
-            guiCell.visited = c.visited;
-            state.cells.push_back(guiCell);
+        // Convert Core Cells to GUI Cells, row by row whatever the core's storage order
+        for (int y = 0; y < globalMaze->getHeight(); ++y) {
+            for (int x = 0; x < globalMaze->getWidth(); ++x) {
+                const Cell& c = *globalMaze->getCellPtr(x, y);
+                // IMPORTANT: Copy the 'wall' and 'visited' status correctly
+                Cell guiCell(c.x, c.y, !globalMaze->isWalkable(c.x, c.y));
+                // 'visited' is written by the worker mid-solve; walls never change
+                if (!activeSolve) guiCell.visited = c.visited;
+                state.cells.push_back(guiCell);
+            }
         }
 
         if (globalMaze->getStart()) 
@@ -80,50 +145,90 @@ public:
         return state;
     }
 
-    void startSolve(PathfindingAlgorithm algorithm, int speed) {
+    MazeLayout getMazeLayout() {
+        MazeLayout layout;
+        if (!globalMaze) return layout;
+        layout.width = globalMaze->getWidth();
+        layout.height = globalMaze->getHeight();
+        layout.walls = globalMaze->packWalls();
+        if (Cell* s = globalMaze->getStart()) { layout.startX = s->x; layout.startY = s->y; }
+        if (Cell* g = globalMaze->getGoal()) { layout.goalX = g->x; layout.goalY = g->y; }
+        return layout;
+    }
+
+    void startSolve(PathfindingAlgorithm algorithm) {
         if (!globalMaze) return;
+        stopSolve();
+        stepper.reset();
         globalMaze->reset(); 
 
-        std::vector<Cell*> visited;
-        std::vector<Cell*> frontier;
-
-        auto stepCallback = [&](Cell* v, Cell* f) {
-            if (v) visited.push_back(v);
-            if (f) frontier.push_back(f);
-
-            if (speed < 10) {
-                unsigned long delay = (11 - speed) * 5; 
-                QThread::msleep(delay);
-            }
-
-            AnimationFrame frame;
-            frame.visitedCells = visited;
-            frame.currentCells = frontier;
-
-            if (onAnimationFrame) onAnimationFrame(frame);
-            QCoreApplication::processEvents(); 
-        };
-
-        AlgorithmResult result;
-        switch (algorithm) {
-            case PathfindingAlgorithm::Dijkstra: result = Dijkstra::solve(*globalMaze, stepCallback); break;
-            case PathfindingAlgorithm::AStar: result = AStar::solve(*globalMaze, stepCallback); break;
-            case PathfindingAlgorithm::BidirectionalAStar: result = DoubleAStar::solve(*globalMaze, stepCallback); break;
-            case PathfindingAlgorithm::JumpPointSearch: result = JumpPointSearch::solve(*globalMaze, stepCallback); break;
-        }
+        // Solve on a worker thread; the GUI drains the session on its own frame timer,
+        // so the solver never waits for painting and timeTakenMs is pure search time
+        auto session = std::make_shared<SolveSession>(globalMaze->getWidth());
+        activeSolve = session;
+        Maze* maze = globalMaze;
+
+        worker = std::thread([session, maze, algorithm]() {
+            PROFILE_THREAD("solve worker");
+            auto stepCallback = [&session](Cell* visited, Cell* frontier) {
+                if (visited) session->publish(visited, SearchTrace::Visit);
+                if (frontier) session->publish(frontier, SearchTrace::Frontier);
+            };
+
+            // The stepper each solve() runs when animated, driven here so it can be cancelled
+            std::unique_ptr<SearchStepper> search = makeStepper(algorithm, *maze);
+            AlgorithmResult result = SearchStepper::run(*search, stepCallback, session->cancelFlag());
+            search.reset();
+            for (Cell* c : result.path) session->publish(c, SearchTrace::Path);
+            session->finish(result);
+        });
+
+        if (onSolveStarted) onSolveStarted(session);
+    }
 
-        AnimationFrame finalFrame;
-        finalFrame.visitedCells = visited;
-        finalFrame.pathCells = result.path;
-        
-        if (onAnimationFrame) onAnimationFrame(finalFrame);
-        if (onSolveComplete) onSolveComplete(result);
+    // Called from the GUI thread's frame timer. Reports the result once the worker is done.
+    void pollSolve() {
+        if (!activeSolve || !activeSolve->isFinished()) return;
+        if (worker.joinable()) worker.join();
+        auto session = activeSolve;
+        activeSolve.reset();
+        if (onSolveComplete) onSolveComplete(session->getResult());
     }
 
     void reset() {
+        stopSolve();
+        activeSolve.reset();
+        stepper.reset();
         if (globalMaze) globalMaze->reset();
         if (onMazeGenerated) onMazeGenerated();
     }
 
-    void step() {} // Placeholder
+    static std::unique_ptr<SearchStepper> makeStepper(PathfindingAlgorithm algorithm, Maze& maze) {
+        switch (algorithm) {
+            case PathfindingAlgorithm::Dijkstra: return Dijkstra::makeStepper(maze);
+            case PathfindingAlgorithm::AStar: return AStar::makeStepper(maze);
+            case PathfindingAlgorithm::BidirectionalAStar: return std::make_unique<DoubleAStar::Stepper>(maze);
+            case PathfindingAlgorithm::JumpPointSearch: return std::make_unique<JumpPointSearch::Stepper>(maze);
+        }
+        return nullptr;
+    }
+
+    // Expands n nodes on the GUI thread, starting a new search if none is in progress
+    // (or the algorithm changed). A running worker solve is cancelled first, which takes
+    // at most one batch, so it is safe to call from a click.
+    void step(PathfindingAlgorithm algorithm, size_t n = 1) {
+        if (!globalMaze) return;
+        if (!stepper || stepper->done() || algorithm != stepperAlgorithm) {
+            stopSolve();
+            activeSolve.reset();
+            stepper = makeStepper(algorithm, *globalMaze);
+            stepperAlgorithm = algorithm;
+            if (onStepStarted) onStepStarted();
+        }
+
+        std::vector<SearchEvent> events;
+        stepper->step(n, &events);
+        if (onStepEvents) onStepEvents(events);
+        if (stepper->done() && onSolveComplete) onSolveComplete(stepper->result());
+    }
 };
\ No newline at end of file
@@ -1,8 +1,10 @@
 #include "ControlPanel.h"
+#include "../core/Utility.h"
 #include <QLabel>
 #include <QHBoxLayout>
 #include <QVBoxLayout>
 #include <QGroupBox>
+#include <algorithm>
 
 ControlPanel::ControlPanel(QWidget* parent)
     : QWidget(parent)
@@ -44,11 +46,11 @@ void ControlPanel::setupMazeControls(QVBoxLayout* mainLayout)
     sizeLayout->setSpacing(10);
 
     widthSpin_ = new QSpinBox();
-    widthSpin_->setRange(5, 101);
+    widthSpin_->setRange(5, 10001);
     widthSpin_->setValue(21);
 
     heightSpin_ = new QSpinBox();
-    heightSpin_->setRange(5, 101);
+    heightSpin_->setRange(5, 10001);
     heightSpin_->setValue(21);
 
     sizeLayout->addWidget(new QLabel("Width:"));
@@ -63,11 +65,37 @@ void ControlPanel::setupMazeControls(QVBoxLayout* mainLayout)
     generatorCombo_->addItem("Kruskal's Algorithm");
     generatorCombo_->addItem("DFS Randomized");
 
+    // Scenario options (loops, open rooms, obstacles)
+    auto* scenarioLayout = new QHBoxLayout();
+    scenarioLayout->setSpacing(10);
+
+    braidSpin_ = new QSpinBox();
+    braidSpin_->setRange(0, 100);
+    braidSpin_->setSuffix("%");
+    braidSpin_->setToolTip("Dead ends knocked through to create loops");
+
+    roomsSpin_ = new QSpinBox();
+    roomsSpin_->setRange(0, 50);
+    roomsSpin_->setToolTip("Open rooms to carve");
+
+    obstacleSpin_ = new QSpinBox();
+    obstacleSpin_->setRange(0, 40);
+    obstacleSpin_->setSuffix("%");
+    obstacleSpin_->setToolTip("Random obstacle density inside open areas");
+
+    scenarioLayout->addWidget(new QLabel("Braid:"));
+    scenarioLayout->addWidget(braidSpin_);
+    scenarioLayout->addWidget(new QLabel("Rooms:"));
+    scenarioLayout->addWidget(roomsSpin_);
+    scenarioLayout->addWidget(new QLabel("Obstacles:"));
+    scenarioLayout->addWidget(obstacleSpin_);
+
     generateButton_ = new QPushButton("Generate New Maze");
 
     layout->addLayout(sizeLayout);
     layout->addWidget(new QLabel("Generator:"));
     layout->addWidget(generatorCombo_);
+    layout->addLayout(scenarioLayout);
     layout->addWidget(generateButton_);
 
     // Signal
@@ -107,6 +135,10 @@ void ControlPanel::setupAlgorithmControls(QVBoxLayout* mainLayout)
     layout->addWidget(bidirectionalRadio_);
     layout->addWidget(jpsRadio_);
 
+    // Movement mode (applies to every algorithm)
+    diagonalCheck_ = new QCheckBox("Allow Diagonal Moves (8-connected)");
+    layout->addWidget(diagonalCheck_);
+
     mainLayout->addWidget(group);
 }
 
@@ -177,11 +209,19 @@ void ControlPanel::setupResultsPanel(QVBoxLayout* mainLayout)
     pathLengthLabel_ = new QLabel("Path Length: --");
     nodesExploredLabel_ = new QLabel("Nodes Explored: --");
     timeTakenLabel_ = new QLabel("Time Taken: --");
+    openListLabel_ = new QLabel("Open List: --");
+    heuristicLabel_ = new QLabel("Heuristic Evaluations: --");
+    memoryLabel_ = new QLabel("Scratch Memory: --");
+    rateLabel_ = new QLabel("Expansions/s: --");
 
     layout->addWidget(statusLabel_);
     layout->addWidget(pathLengthLabel_);
     layout->addWidget(nodesExploredLabel_);
     layout->addWidget(timeTakenLabel_);
+    layout->addWidget(openListLabel_);
+    layout->addWidget(heuristicLabel_);
+    layout->addWidget(memoryLabel_);
+    layout->addWidget(rateLabel_);
 
     mainLayout->addWidget(group);
 }
@@ -197,19 +237,33 @@ void ControlPanel::onGenerateClicked() {
     int height = heightSpin_->value();
     MazeGenerator gen = static_cast<MazeGenerator>(generatorCombo_->currentIndex());
 
+    GeneratorOptions options;
+    options.braidFraction = braidSpin_->value() / 100.0;
+    options.roomCount = roomsSpin_->value();
+    options.maxRoomSize = std::max(3, std::min(width, height) / 4);
+    options.obstacleDensity = obstacleSpin_->value() / 100.0;
+
     // [FIX] Use Singleton
-    BackendInterface::get().generateMaze(width, height, gen);
+    BackendInterface::get().generateMaze(width, height, gen, options);
 
-    emit mazeGenerated();
+    // The worker carves the maze; mazeReady() follows once it is installed
+    generateButton_->setEnabled(false);
+    statusLabel_->setText("Status: Generating...");
+}
+
+void ControlPanel::mazeReady() {
+    generateButton_->setEnabled(true);
     statusLabel_->setText("Status: Maze Generated");
+    emit mazeGenerated();
 }
 
 void ControlPanel::onSolveClicked() {
     PathfindingAlgorithm algorithm = static_cast<PathfindingAlgorithm>(algorithmGroup_->checkedId());
-    int speed = speedSlider_->value();
 
     // [FIX] Use Singleton
-    BackendInterface::get().startSolve(algorithm, speed);
+    BackendInterface::get().setMovementMode(diagonalCheck_->isChecked()
+                                            ? MovementMode::EightWay : MovementMode::FourWay);
+    BackendInterface::get().startSolve(algorithm);
 
     emit solveStarted();
     statusLabel_->setText("Status: Solving...");
@@ -225,14 +279,17 @@ void ControlPanel::onResetClicked() {
 
 void ControlPanel::onStepClicked()
 {
-    BackendInterface::get().step();
+    PathfindingAlgorithm algorithm = static_cast<PathfindingAlgorithm>(algorithmGroup_->checkedId());
+    BackendInterface::get().setMovementMode(diagonalCheck_->isChecked()
+                                            ? MovementMode::EightWay : MovementMode::FourWay);
+    BackendInterface::get().step(algorithm);
     emit stepRequested();
 }
 
 void ControlPanel::onSpeedChanged(int value)
 {
-    Q_UNUSED(value);
-    // Can be used if real-time speed adjustments are required
+    // Replay speed only; the solver itself always runs flat out
+    emit speedChanged(value);
 }
 
 void ControlPanel::updateResults(const AlgorithmResult& results)
@@ -249,10 +306,31 @@ void ControlPanel::updateResults(const AlgorithmResult& results)
         } else {
              timeTakenLabel_->setText(QString("Time Taken: %1 ms").arg(timeVal / 1000.0, 0, 'f', 2));
         }
+
+        const Metrics& m = results.metrics;
+        openListLabel_->setText(QString("Open List: %1 pushes, %2 stale pops, peak %3")
+                                .arg(m.heapPushes).arg(m.stalePops).arg(m.peakOpenSize));
+        heuristicLabel_->setText(QString("Heuristic Evaluations: %1 (%2 reopenings)")
+                                 .arg(m.heuristicEvaluations).arg(m.reopenings));
+        memoryLabel_->setText(QString("Scratch Memory: %1 KB").arg((m.bytesAllocated + 1023) / 1024));
+        // Step Forward results carry no time, so no rate either
+        if (m.timeTakenMs > 0) {
+            rateLabel_->setText(QString("Expansions/s: %1 M").arg(m.expansionsPerSecond() / 1e6, 0, 'f', 2));
+        } else {
+            rateLabel_->setText("Expansions/s: --");
+        }
     } else {
-        statusLabel_->setText("Status: No Solution Found");
+        if (results.failure != FailureReason::None) {
+            statusLabel_->setText(QString("Status: No Solution Found (%1)").arg(Utility::failureName(results.failure)));
+        } else {
+            statusLabel_->setText("Status: No Solution Found");
+        }
         pathLengthLabel_->setText("Path Length: --");
         nodesExploredLabel_->setText("Nodes Explored: --");
         timeTakenLabel_->setText("Time Taken: --");
+        openListLabel_->setText("Open List: --");
+        heuristicLabel_->setText("Heuristic Evaluations: --");
+        memoryLabel_->setText("Scratch Memory: --");
+        rateLabel_->setText("Expansions/s: --");
     }
 }
\ No newline at end of file
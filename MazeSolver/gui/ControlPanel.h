@@ -7,6 +7,7 @@
 #include <QPushButton>
 #include <QRadioButton>
 #include <QButtonGroup>
+#include <QCheckBox>
 #include <QSlider>
 #include <QLabel>
 #include <QVBoxLayout>
@@ -26,11 +27,16 @@ class ControlPanel : public QWidget {
 public:
     explicit ControlPanel(QWidget* parent = nullptr);
 
+public slots:
+    // The backend installed a new (or reset) maze
+    void mazeReady();
+
 signals:
     void mazeGenerated();
     void solveStarted();
     void resetRequested();
     void stepRequested();
+    void speedChanged(int speed);
 
 private slots:
     void onGenerateClicked();
@@ -54,6 +60,9 @@ private:
     QSpinBox* widthSpin_;
     QSpinBox* heightSpin_;
     QComboBox* generatorCombo_;
+    QSpinBox* braidSpin_;
+    QSpinBox* roomsSpin_;
+    QSpinBox* obstacleSpin_;
     QPushButton* generateButton_;
 
     // =================
@@ -64,6 +73,7 @@ private:
     QRadioButton* astarRadio_;
     QRadioButton* bidirectionalRadio_;
     QRadioButton* jpsRadio_;
+    QCheckBox* diagonalCheck_;
 
     // ====================
     // Simulation Controls
@@ -80,5 +90,9 @@ private:
     QLabel* pathLengthLabel_;
     QLabel* nodesExploredLabel_;
     QLabel* timeTakenLabel_;
+    QLabel* openListLabel_;
+    QLabel* heuristicLabel_;
+    QLabel* memoryLabel_;
+    QLabel* rateLabel_;
 };
 
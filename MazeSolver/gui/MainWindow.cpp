@@ -65,13 +65,27 @@ void MainWindow::setupUI() {
 void MainWindow::setupConnections() {
     connect(controlPanel_, &ControlPanel::mazeGenerated, mazeWidget_, &MazeWidget::resetView);
     connect(controlPanel_, &ControlPanel::resetRequested, mazeWidget_, &MazeWidget::resetView);
+    connect(controlPanel_, &ControlPanel::speedChanged, mazeWidget_, &MazeWidget::setPlaybackSpeed);
 
     // [FIX] Use Singleton for signals
-    BackendInterface::get().onAnimationFrame = [this](const AnimationFrame& frame) {
-        mazeWidget_->updateAnimationFrame(frame);
+    BackendInterface::get().onSolveStarted = [this](std::shared_ptr<SolveSession> session) {
+        mazeWidget_->playSession(session);
+    };
+
+    BackendInterface::get().onStepStarted = [this]() {
+        mazeWidget_->beginStepping();
+    };
+
+    BackendInterface::get().onStepEvents = [this](const std::vector<SearchEvent>& events) {
+        mazeWidget_->applyStepEvents(events);
+    };
+
+    // Generation runs on the worker; the widget's frame timer polls for the new maze
+    BackendInterface::get().onGenerateStarted = [this]() {
+        mazeWidget_->waitForMaze();
     };
 
     BackendInterface::get().onMazeGenerated = [this]() {
-        mazeWidget_->resetView();
+        controlPanel_->mazeReady();
     };
 }
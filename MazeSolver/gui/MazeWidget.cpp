@@ -1,72 +1,276 @@
 #include "MazeWidget.h"
+#include "../core/Profiler.h"
 #include <QPainter>
 #include <QPaintEvent>
+#include <QResizeEvent>
+#include <QWheelEvent>
+#include <QMouseEvent>
 #include <algorithm>
+#include <cmath>
 
 MazeWidget::MazeWidget(QWidget* parent) : QWidget(parent) {
     setMinimumSize(600, 600);
     setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+
+    // ~60 fps drain/replay clock
+    replayTimer_.setInterval(16);
+    connect(&replayTimer_, &QTimer::timeout, this, &MazeWidget::advanceReplay);
 }
 
-void MazeWidget::updateAnimationFrame(const AnimationFrame& frame) {
-    currentFrame_ = frame;
+void MazeWidget::playSession(std::shared_ptr<SolveSession> session) {
+    if (imageDirty_) rebuildImage();
+    clearMarks();
+
+    session_ = session;
+    replayTimer_.start();
     update();
 }
 
+void MazeWidget::setPlaybackSpeed(int speed) {
+    speed_ = std::max(1, std::min(10, speed));
+}
+
+void MazeWidget::waitForMaze() {
+    // The old maze stays on screen until the worker hands over the new one
+    session_.reset();
+    replayTimer_.start();
+}
+
+void MazeWidget::advanceReplay() {
+    PROFILE_ZONE("gui", "replay tick");
+    BackendInterface::get().pollGenerate();
+    BackendInterface::get().pollSolve();
+    if (!session_) return;
+
+    // Speed 1 = one event per frame, each step up is 4x more, speed 10 ~ 260k per frame
+    size_t budget = size_t(1) << (2 * (speed_ - 1));
+
+    bool paint = canPaintIncrementally();
+    QRect dirtyCells;
+    SearchTrace::Event event;
+    while (budget-- > 0 && session_->next(event)) {
+        applyEvent(event, paint, dirtyCells);
+    }
+
+    if (session_->exhausted()) {
+        replayTimer_.stop();
+        session_.reset();
+        BackendInterface::get().pollSolve();
+    }
+    flushDirty(paint, dirtyCells);
+}
+
+void MazeWidget::beginStepping() {
+    replayTimer_.stop();
+    session_.reset();
+    if (imageDirty_) rebuildImage();
+    clearMarks();
+    update();
+}
+
+void MazeWidget::applyStepEvents(const std::vector<SearchEvent>& events) {
+    bool paint = canPaintIncrementally();
+    QRect dirtyCells;
+    const uint32_t mazeW = static_cast<uint32_t>(image_.width());
+    for (const SearchEvent& e : events) {
+        SearchTrace::Event event{static_cast<uint32_t>(e.cell->y) * mazeW + static_cast<uint32_t>(e.cell->x), e.type};
+        applyEvent(event, paint, dirtyCells);
+    }
+    flushDirty(paint, dirtyCells);
+}
+
+bool MazeWidget::canPaintIncrementally() const {
+    // Marks go straight into the pixel buffer, unless it is about to be rebuilt for a
+    // new maze (which clears the marks too)
+    return !imageDirty_ && !image_.isNull();
+}
+
+void MazeWidget::applyEvent(const SearchTrace::Event& event, bool paint, QRect& dirtyCells) {
+    if (event.cell >= marks_.size()) return;
+    uint8_t& mark = marks_[event.cell];
+    uint8_t before = mark;
+    switch (event.type) {
+        case SearchTrace::Visit:    if (mark != OnPath) mark = Visited; break;
+        case SearchTrace::Frontier: if (mark == Unmarked) mark = Frontier; break;
+        case SearchTrace::Path:     mark = OnPath; break;
+    }
+    if (before == Unmarked && mark != Unmarked) touched_.push_back(event.cell);
+    if (!paint || mark == before || event.cell == startIndex_ || event.cell == goalIndex_) return;
+
+    int x = static_cast<int>(event.cell % image_.width());
+    int y = static_cast<int>(event.cell / image_.width());
+    reinterpret_cast<QRgb*>(image_.scanLine(y))[x] = markColor(mark);
+    dirtyCells |= QRect(x, y, 1, 1);
+}
+
+void MazeWidget::flushDirty(bool painted, const QRect& dirtyCells) {
+    if (!painted) update();
+    else if (!dirtyCells.isEmpty()) update(screenRect(dirtyCells.left(), dirtyCells.top(),
+                                                      dirtyCells.right() + 1, dirtyCells.bottom() + 1));
+}
+
 void MazeWidget::resetView() {
-    currentFrame_ = AnimationFrame();
+    replayTimer_.stop();
+    session_.reset();
+    marks_.clear();
+    touched_.clear();
+    // Called after generate and reset: the maze itself may have changed
+    imageDirty_ = true;
+    fitToWindow_ = true;
     update();
 }
 
-void MazeWidget::paintEvent(QPaintEvent* event) {
-    Q_UNUSED(event);
-    QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing);
+void MazeWidget::rebuildImage() {
+    PROFILE_ZONE("gui", "rebuild image");
+    MazeLayout layout = BackendInterface::get().getMazeLayout();
+    startIndex_ = layout.startX >= 0 ? static_cast<size_t>(layout.startY) * layout.width + layout.startX : SIZE_MAX;
+    goalIndex_ = layout.goalX >= 0 ? static_cast<size_t>(layout.goalY) * layout.width + layout.goalX : SIZE_MAX;
+
+    // Release the old image before allocating the new one, so two never coexist
+    image_ = QImage();
+    image_ = QImage(layout.width, layout.height, QImage::Format_RGB32);
+    imageDirty_ = false;
+    if (image_.isNull()) return;
+
+    const QRgb wall = wallColor_.rgb();
+    const QRgb empty = emptyColor_.rgb();
+    const size_t wordsPerRow = WallGrid::wordsForWidth(layout.width);
+    for (int y = 0; y < layout.height; ++y) {
+        const uint64_t* row = layout.walls.data() + y * wordsPerRow;
+        QRgb* line = reinterpret_cast<QRgb*>(image_.scanLine(y));
+        for (int x = 0; x < layout.width; ++x) {
+            line[x] = ((row[x >> 6] >> (x & 63)) & 1u) ? wall : empty;
+        }
+    }
+    // Start/End
+    if (startIndex_ != SIZE_MAX) image_.setPixel(layout.startX, layout.startY, startColor_.rgb());
+    if (goalIndex_ != SIZE_MAX)  image_.setPixel(layout.goalX, layout.goalY, endColor_.rgb());
+    if (fitToWindow_) fitView();
+}
 
-    // [FIX] Use Singleton to get data
-    MazeState mazeState = BackendInterface::get().getCurrentMazeState();
-    if (mazeState.cells.empty()) return;
+void MazeWidget::clearMarks() {
+    const size_t cells = static_cast<size_t>(image_.width()) * image_.height();
+    if (marks_.size() != cells) {
+        marks_.assign(cells, Unmarked);
+        touched_.clear();
+        return;
+    }
 
-    // Dimensions
-    int maxW = width() - 80;
-    int maxH = height() - 80;
-    int cellW = maxW / mazeState.width;
-    int cellH = maxH / mazeState.height;
-    cellSize_ = std::max(1, std::min(cellW, cellH));
+    // Marks only ever land on floor cells, so floor is what each one covered
+    const QRgb empty = emptyColor_.rgb();
+    QRgb* pixels = reinterpret_cast<QRgb*>(image_.bits());
+    for (uint32_t i : touched_) {
+        marks_[i] = Unmarked;
+        if (i != startIndex_ && i != goalIndex_) pixels[i] = empty;
+    }
+    touched_.clear();
+}
+
+QRgb MazeWidget::markColor(uint8_t mark) const {
+    switch (mark) {
+        case Visited:  return visitedColor_.rgb();
+        case Frontier: return currentColor_.rgb();
+        case OnPath:   return pathColor_.rgb();
+        default:       return emptyColor_.rgb();
+    }
+}
 
-    int mazePixelW = mazeState.width * cellSize_;
-    int mazePixelH = mazeState.height * cellSize_;
-    int offsetX = (width() - mazePixelW) / 2;
-    int offsetY = (height() - mazePixelH) / 2;
+void MazeWidget::fitView() {
+    if (image_.isNull()) return;
+    double zw = (width() - 80) / double(image_.width());
+    double zh = (height() - 80) / double(image_.height());
+    zoom_ = std::min(zw, zh);
+    // Whole pixels per cell keep every cell the same size; huge mazes get a fractional zoom
+    if (zoom_ >= 1.0) zoom_ = std::floor(zoom_);
+    zoom_ = std::max(zoom_, 1e-3);
+
+    pan_ = QPointF((width() - image_.width() * zoom_) / 2.0,
+                   (height() - image_.height() * zoom_) / 2.0);
+}
+
+QRect MazeWidget::screenRect(int x0, int y0, int x1, int y1) const {
+    QPointF topLeft = pan_ + QPointF(x0, y0) * zoom_;
+    QPointF bottomRight = pan_ + QPointF(x1, y1) * zoom_;
+    return QRectF(topLeft, bottomRight).toAlignedRect();
+}
+
+void MazeWidget::paintEvent(QPaintEvent* event) {
+    PROFILE_ZONE("gui", "paint");
+    if (imageDirty_) rebuildImage();
+    if (image_.isNull()) return;
+
+    QPainter painter(this);
+    painter.setClipRect(event->rect());
 
     // Draw Background
-    QRect borderRect(offsetX - 10, offsetY - 10, mazePixelW + 20, mazePixelH + 20);
+    QRectF mazeRect(pan_, QSizeF(image_.width() * zoom_, image_.height() * zoom_));
+    painter.setRenderHint(QPainter::Antialiasing);
     painter.setBrush(QColor("#2f3336")); 
     painter.setPen(Qt::NoPen);
-    painter.drawRoundedRect(borderRect, 8, 8);
+    painter.drawRoundedRect(mazeRect.adjusted(-10, -10, 10, 10), 8, 8);
 
-    painter.translate(offsetX, offsetY);
+    // Viewport culling: sample only the cells under the exposed area
+    QRectF visible = mazeRect.intersected(QRectF(event->rect()));
+    if (visible.isEmpty()) return;
+    int x0 = std::max(0, int(std::floor((visible.left() - pan_.x()) / zoom_)));
+    int y0 = std::max(0, int(std::floor((visible.top() - pan_.y()) / zoom_)));
+    int x1 = std::min(image_.width(), int(std::ceil((visible.right() - pan_.x()) / zoom_)));
+    int y1 = std::min(image_.height(), int(std::ceil((visible.bottom() - pan_.y()) / zoom_)));
+    if (x0 >= x1 || y0 >= y1) return;
 
-    // Draw Cells
-    for (const auto& cell : mazeState.cells) {
-        if (cell.wall) {
-            drawCell(painter, cell.x, cell.y, wallColor_);
-        } else {
-            drawCell(painter, cell.x, cell.y, emptyColor_);
-        }
+    QRectF source(x0, y0, x1 - x0, y1 - y0);
+    QRectF target(pan_ + QPointF(x0, y0) * zoom_, QSizeF((x1 - x0) * zoom_, (y1 - y0) * zoom_));
+    painter.setRenderHint(QPainter::Antialiasing, false);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, false);  // Nearest-neighbour
+    painter.drawImage(target, image_, source);
+}
+
+void MazeWidget::resizeEvent(QResizeEvent* event) {
+    if (fitToWindow_) fitView();
+    QWidget::resizeEvent(event);
+}
+
+void MazeWidget::wheelEvent(QWheelEvent* event) {
+    if (image_.isNull()) return;
+    // One notch (120) = 1.25x, anchored on the cell under the cursor
+    double factor = std::pow(1.25, event->angleDelta().y() / 120.0);
+    double newZoom = std::max(1e-3, std::min(256.0, zoom_ * factor));
+    QPointF anchor = event->position();
+    pan_ = anchor - (anchor - pan_) * (newZoom / zoom_);
+    zoom_ = newZoom;
+    fitToWindow_ = false;
+    update();
+    event->accept();
+}
+
+void MazeWidget::mousePressEvent(QMouseEvent* event) {
+    if (event->button() == Qt::LeftButton || event->button() == Qt::MiddleButton) {
+        dragging_ = true;
+        lastMousePos_ = event->position().toPoint();
+        setCursor(Qt::ClosedHandCursor);
     }
+}
 
-    // Draw Visited/Path
-    for (const auto* cell : currentFrame_.visitedCells) { if(cell) drawCell(painter, cell->x, cell->y, visitedColor_); }
-    for (const auto* cell : currentFrame_.currentCells) { if(cell) drawCell(painter, cell->x, cell->y, currentColor_); }
-    for (const auto* cell : currentFrame_.pathCells)    { if(cell) drawCell(painter, cell->x, cell->y, pathColor_); }
+void MazeWidget::mouseMoveEvent(QMouseEvent* event) {
+    if (!dragging_) return;
+    QPoint pos = event->position().toPoint();
+    pan_ += QPointF(pos - lastMousePos_);
+    lastMousePos_ = pos;
+    fitToWindow_ = false;
+    update();
+}
 
-    // Start/End
-    if (mazeState.startCell) drawCell(painter, mazeState.startCell->x, mazeState.startCell->y, startColor_);
-    if (mazeState.endCell)   drawCell(painter, mazeState.endCell->x, mazeState.endCell->y, endColor_);
+void MazeWidget::mouseReleaseEvent(QMouseEvent* event) {
+    Q_UNUSED(event);
+    if (dragging_) {
+        dragging_ = false;
+        unsetCursor();
+    }
 }
 
-void MazeWidget::drawCell(QPainter& painter, int x, int y, const QColor& color) {
-    QRect cellRect(x * cellSize_, y * cellSize_, cellSize_, cellSize_);
-    painter.fillRect(cellRect, color);
+void MazeWidget::mouseDoubleClickEvent(QMouseEvent* event) {
+    Q_UNUSED(event);
+    fitToWindow_ = true;
+    fitView();
+    update();
 }
\ No newline at end of file
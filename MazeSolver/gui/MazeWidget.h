@@ -2,15 +2,23 @@
 
 #include <QWidget>
 #include <QPainter>
+#include <QImage>
 #include <QTimer>
+#include <algorithm>
+#include <cstdint>
 #include "BackendInterface.h"
 
 /*
  * MazeWidget:
  * - Renders the maze grid
  * - Renders walls, empty tiles, visited, current, and path cells
+ * - Maze and search state live in a QImage at one pixel per cell; each frame writes only
+ *   the cells that changed and paints only the visible part, scaled nearest-neighbour
+ * - A new solve repaints only the cells the previous one marked, so huge mazes keep a
+ *   single image and no per-solve copy
+ * - Mouse wheel zooms around the cursor, drag pans, double-click fits the maze again
  * - Centers the maze inside a styled container (defined in MainWindow/QSS)
- * - Responds to BackendInterface animation updates
+ * - Drains the running solve's event channel on a frame timer, applying only new events
  */
 
 class MazeWidget : public QWidget {
@@ -19,27 +27,68 @@ class MazeWidget : public QWidget {
 public:
     explicit MazeWidget(QWidget* parent = nullptr);
 
+    // Fixed zoom in screen pixels per cell (leaves fit-to-window mode)
     void setCellSize(int size) {
-        cellSize_ = size;
+        fitToWindow_ = false;
+        zoom_ = std::max(1, size);
         update();
     }
 
 public slots:
-    void updateAnimationFrame(const AnimationFrame& frame);
+    void playSession(std::shared_ptr<SolveSession> session);
+    void beginStepping();
+    void applyStepEvents(const std::vector<SearchEvent>& events);
+    void setPlaybackSpeed(int speed);
     void resetView();
+    void waitForMaze();
+
+private slots:
+    void advanceReplay();
 
 protected:
     void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void wheelEvent(QWheelEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+    void mouseReleaseEvent(QMouseEvent* event) override;
+    void mouseDoubleClickEvent(QMouseEvent* event) override;
 
 private:
-    void drawGrid(QPainter& painter, const MazeState& mazeState);
-    void drawCells(QPainter& painter, const MazeState& mazeState);
-    void drawCell(QPainter& painter, int x, int y, const QColor& color);
+    void rebuildImage();
+    // Restores every marked cell to floor, leaving walls and endpoints untouched
+    void clearMarks();
+    void fitView();
+    QRgb markColor(uint8_t mark) const;
+    bool canPaintIncrementally() const;
+    // Updates one cell's mark, writing the pixel when 'paint'; grows dirtyCells (cell coords)
+    void applyEvent(const SearchTrace::Event& event, bool paint, QRect& dirtyCells);
+    void flushDirty(bool painted, const QRect& dirtyCells);
+    // Screen rectangle covering cells [x0, x1) x [y0, y1)
+    QRect screenRect(int x0, int y0, int x1, int y1) const;
 
 private:
-    int cellSize_ = 25;
+    // Replay state, one byte per cell
+    enum CellMark : uint8_t { Unmarked, Visited, Frontier, OnPath };
+
+    // Pixel buffer: one pixel per cell
+    QImage image_;              // Walls/floor + marks + endpoints
+    bool imageDirty_ = true;
+    size_t startIndex_ = SIZE_MAX;
+    size_t goalIndex_ = SIZE_MAX;
+
+    // View: a cell (x, y) is drawn at pan_ + (x, y) * zoom_
+    double zoom_ = 25.0;
+    QPointF pan_;
+    bool fitToWindow_ = true;
+    bool dragging_ = false;
+    QPoint lastMousePos_;
 
-    AnimationFrame currentFrame_;
+    std::shared_ptr<SolveSession> session_;
+    std::vector<uint8_t> marks_;
+    std::vector<uint32_t> touched_;   // Cells with a mark, in the order they got one
+    QTimer replayTimer_;
+    int speed_ = 5;
 
     // ==========================
     // Modern Color Palette
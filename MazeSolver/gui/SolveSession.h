@@ -0,0 +1,83 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+#include "../core/Types.h"
+#include "../core/SearchTrace.h"
+#include "../core/SpscRing.h"
+
+/*
+ * SolveSession:
+ * - Channel between one solver worker thread and the GUI thread
+ * - The worker publishes events into a lock-free SPSC ring; if the GUI falls behind it
+ *   spills into a SearchTrace instead of waiting, so painting never slows the solver
+ * - The GUI drains ring first, then the spilled tail once the worker has finished
+ * - The GUI can cancel: the worker's search checks the flag between batches and
+ *   finishes early with FailureReason::Cancelled
+ */
+class SolveSession {
+public:
+    explicit SolveSession(int width) : width(width), overflow(width) {}
+
+    SolveSession(const SolveSession&) = delete;
+    SolveSession& operator=(const SolveSession&) = delete;
+
+    // ---- Worker thread ----
+    void publish(const Cell* cell, SearchTrace::EventType type) {
+        SearchTrace::Event event{static_cast<uint32_t>(cell->y * width + cell->x), type};
+        // Once spilling, keep spilling so the GUI still sees events in order
+        if (spilling || !ring.push(event)) {
+            spilling = true;
+            overflow.record(event.cell, type);
+        }
+    }
+
+    void finish(const AlgorithmResult& solved) {
+        result = solved;
+        finished.store(true, std::memory_order_release);
+    }
+
+    // Checked by the search between batches of expansions
+    const std::atomic<bool>* cancelFlag() const { return &cancelled; }
+
+    // ---- GUI thread ----
+    bool isFinished() const { return finished.load(std::memory_order_acquire); }
+
+    // Asks the worker to stop; it finishes within one batch
+    void cancel() { cancelled.store(true, std::memory_order_relaxed); }
+
+    // Result is only valid once isFinished() returned true
+    const AlgorithmResult& getResult() const { return result; }
+
+    bool next(SearchTrace::Event& event) {
+        // Read the flag before popping: if the worker was already done, an empty ring is final
+        bool done = isFinished();
+        if (ring.pop(event)) return true;
+        if (!done) return false;
+
+        if (!replayingOverflow) {
+            cursor = SearchTrace::Cursor(overflow);
+            replayingOverflow = true;
+        }
+        return cursor.next(event);
+    }
+
+    // Every event has been handed to the GUI
+    bool exhausted() const { return replayingOverflow && cursor.done(); }
+
+private:
+    int width;
+
+    SpscRing<SearchTrace::Event> ring{1 << 16};
+    std::atomic<bool> finished{false};
+    std::atomic<bool> cancelled{false};
+
+    // Worker-owned until 'finished' is published
+    SearchTrace overflow;
+    bool spilling = false;
+    AlgorithmResult result;
+
+    // GUI-owned
+    SearchTrace::Cursor cursor;
+    bool replayingOverflow = false;
+};
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <vector>
 #include "../core/Cell.h" // Import core cell definition
 
@@ -12,4 +13,13 @@ struct MazeState {
     MazeState(int w = 21, int h = 21) : width(w), height(h), startCell(nullptr), endCell(nullptr) {
         cells.reserve(width * height);
     }
+};
+
+// Walls only, bit-packed in WallGrid layout (1 bit per cell).
+// Used by the pixel renderer so huge mazes never get copied cell by cell.
+struct MazeLayout {
+    int width = 0, height = 0;
+    std::vector<uint64_t> walls;
+    int startX = -1, startY = -1;
+    int goalX = -1, goalY = -1;
 };
\ No newline at end of file
@@ -1,7 +1,10 @@
 #include <QApplication>
 #include "MainWindow.h"
+#include "../core/Profiler.h"
 
 int main(int argc, char* argv[]) {
+    // MAZE_TRACE=trace.json records phase zones until exit (MAZE_PROFILING builds)
+    Profiler::startFromEnvironment();
     QApplication app(argc, argv);
     
     // Application info
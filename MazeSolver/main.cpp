@@ -1,18 +1,49 @@
 #include <iostream>
 #include <iomanip>
+#include <sstream>
+#include <cmath>
 #include <limits>
+#include <chrono>
+#include <map>
+#include <thread>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
 #include "core/Utility.h"
 #include "core/Maze.h"
+#include "core/MazeFile.h"
+#include "core/MovingAI.h"
+#include "core/Landmarks.h"
 #include "core/Types.h"
+#include "core/GridMemory.h"
+#include "core/HardwareCounter.h"
+#include "core/TiledMaze.h"
+#include "core/Profiler.h"
 #include "algorithms/Dijkstra.h"
 #include "algorithms/AStar.h"
 #include "algorithms/DoubleAStar.h"
 #include "algorithms/JumpPointSearch.h"
+#include "algorithms/ParallelBFS.h"
+#include "algorithms/BitBFS.h"
+#include "algorithms/OutOfCoreSearch.h"
+#include "server/QueryServer.h"
+
+// 12.3 M/s style, for expansion rates
+std::string formatRate(double perSecond) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    if (perSecond >= 1e6) out << perSecond / 1e6 << " M/s";
+    else if (perSecond >= 1e3) out << perSecond / 1e3 << " K/s";
+    else out << perSecond << " /s";
+    return out.str();
+}
 
 void printMetrics(const std::string& algorithmName, const AlgorithmResult& result) {
     std::cout << "\n===== " << algorithmName << " =====\n";
     std::cout << "Path Length: " << result.metrics.pathLength << "\n";
     std::cout << "Nodes Explored: " << result.metrics.nodesExplored << "\n";
+    std::cout << "Path Cost: " << std::fixed << std::setprecision(2) << result.metrics.pathCost
+              << std::defaultfloat << "\n";
     
     if (result.metrics.timeTakenMs == -1) {
         std::cout << "Time: FAILED\n";
@@ -22,7 +53,17 @@ void printMetrics(const std::string& algorithmName, const AlgorithmResult& resul
         std::cout << "Time: " << (result.metrics.timeTakenMs / 1000.0) << " ms\n";
     }
     
+    std::cout << "Heap Allocations: " << result.metrics.heapAllocations << "\n";
+    std::cout << "Open List: " << result.metrics.heapPushes << " pushes, " << result.metrics.heapPops << " pops ("
+              << result.metrics.stalePops << " stale), peak " << result.metrics.peakOpenSize << "\n";
+    std::cout << "Reopenings: " << result.metrics.reopenings << "\n";
+    std::cout << "Heuristic Evaluations: " << result.metrics.heuristicEvaluations << "\n";
+    std::cout << "Scratch Memory: " << (result.metrics.bytesAllocated + 1023) / 1024 << " KB\n";
+    std::cout << "Expansions/s: " << formatRate(result.metrics.expansionsPerSecond()) << "\n";
     std::cout << "Success: " << (result.success ? "Yes" : "No") << "\n";
+    if (!result.success && result.failure != FailureReason::None) {
+        std::cout << "Reason: " << Utility::failureName(result.failure) << "\n";
+    }
 }
 
 void printRobustMetrics(const std::string& algorithmName, const RobustMetrics& metrics) {
@@ -41,7 +82,31 @@ void printRobustMetrics(const std::string& algorithmName, const RobustMetrics& m
     }
 }
 
-void displayMenu() {
+std::string movementName(MovementMode mode) {
+    return mode == MovementMode::EightWay ? "8-connected" : "4-connected";
+}
+
+// Rooms + full braiding: wide open areas where diagonal moves and pruning matter
+GeneratorOptions openRoomOptions(int size) {
+    GeneratorOptions opts;
+    opts.braidFraction = 1.0;
+    opts.roomCount = size * size / 150;
+    opts.maxRoomSize = 15;
+    opts.obstacleDensity = 0.05;
+    opts.seed = static_cast<unsigned>(size);
+    return opts;
+}
+
+std::string describeScenario(const GeneratorOptions& opts) {
+    if (opts.braidFraction <= 0.0 && opts.roomCount <= 0 && opts.obstacleDensity <= 0.0) return "Perfect maze";
+    std::ostringstream out;
+    out << "Braid " << int(opts.braidFraction * 100 + 0.5) << "%, "
+        << opts.roomCount << " rooms, "
+        << "obstacles " << int(opts.obstacleDensity * 100 + 0.5) << "%";
+    return out.str();
+}
+
+void displayMenu(const Maze& maze) {
     std::cout << "\n"
                  "🚀 Interactive Maze Solver - C++17 Terminal Version\n"
                  "==================================================\n"
@@ -54,8 +119,24 @@ void displayMenu() {
                  "7. Solve with All Algorithms (Compare)\n"
                  "8. Robust Analysis (Multiple Runs)\n"
                  "9. Display Current Maze\n"
-                 "10. Exit\n"
-                 "Choose an option (1-10): ";
+                 "10. Toggle Movement (Current: " << movementName(maze.getMovementMode()) << ")\n"
+                 "11. Benchmark 8-Connected JPS vs A*\n"
+                 "12. Scenario Settings (Braid / Rooms / Obstacles)\n"
+                 "13. Benchmark Scenarios (All Algorithms)\n"
+                 "14. Save Maze to File\n"
+                 "15. Load Maze File (Memory-Mapped)\n"
+                 "16. Run MovingAI Benchmark (.map/.scen)\n"
+                 "17. ALT Landmark Benchmark (A* / Bidirectional A*)\n"
+                 "18. Parallel Bidirectional A* Benchmark (1 vs 2 threads)\n"
+                 "19. Parallel BFS Distance Field (throughput vs cores)\n"
+                 "20. Cell Layout Benchmark (row-major / tiled / Morton)\n"
+                 "21. Grid Memory Benchmark (huge pages / NUMA)\n"
+                 "22. Out-of-Core Tiled Maze Benchmark (tile cache)\n"
+                 "23. Phase Trace (Current: " << (!Profiler::compiledIn() ? "compiled out"
+                                                  : Profiler::recording() ? "recording" : "off") << ")\n"
+                 "24. Query Server (Unix socket, until SHUTDOWN)\n"
+                 "25. Exit\n"
+                 "Choose an option (1-25): ";
 }
 
 int getIntegerInput(const std::string& prompt, int minVal, int maxVal) {
@@ -117,10 +198,10 @@ void solveAllAlgorithms(Maze& maze) {
     std::cout << "\n🧪 Running All Algorithms for Comparison...\n";
     
     // UPDATED: Wrapped in lambdas to handle the stepCallback parameter mismatch
-    AlgorithmResult dijkstra = Utility::runAlgorithmSafely(maze, [](Maze& m){ return Dijkstra::solve(m); });
-    AlgorithmResult astar = Utility::runAlgorithmSafely(maze, [](Maze& m){ return AStar::solve(m); });
-    AlgorithmResult doubleAstar = Utility::runAlgorithmSafely(maze, [](Maze& m){ return DoubleAStar::solve(m); });
-    AlgorithmResult jps = Utility::runAlgorithmSafely(maze, [](Maze& m){ return JumpPointSearch::solve(m); });
+    AlgorithmResult dijkstra = Utility::runAlgorithmSafely(maze, [](Maze& m){ return Dijkstra::solve(m, nullptr, ResultDetail::Compact); });
+    AlgorithmResult astar = Utility::runAlgorithmSafely(maze, [](Maze& m){ return AStar::solve(m, nullptr, ResultDetail::Compact); });
+    AlgorithmResult doubleAstar = Utility::runAlgorithmSafely(maze, [](Maze& m){ return DoubleAStar::solve(m, nullptr, ResultDetail::Compact); });
+    AlgorithmResult jps = Utility::runAlgorithmSafely(maze, [](Maze& m){ return JumpPointSearch::solve(m, nullptr, ResultDetail::Compact); });
     
     // Display individual results
     printMetrics("Dijkstra", dijkstra);
@@ -131,13 +212,16 @@ void solveAllAlgorithms(Maze& maze) {
     // Display comparison table
     std::cout << "\n📊 PERFORMANCE COMPARISON\n";
     std::cout << "=========================\n";
+    std::cout << "Scenario: " << describeScenario(maze.getGeneratorOptions()) << ", "
+              << movementName(maze.getMovementMode()) << "\n";
     std::cout << std::left << std::setw(20) << "Algorithm" 
               << std::setw(12) << "Path Length" 
+              << std::setw(10) << "Cost" 
               << std::setw(15) << "Nodes Explored" 
               << std::setw(10) << "Time" 
               << std::setw(8) << "Success" << "\n";
     
-    std::cout << std::string(65, '-') << "\n";
+    std::cout << std::string(75, '-') << "\n";
     
     auto printRow = [](const std::string& name, const AlgorithmResult& result) {
         std::string timeStr;
@@ -149,8 +233,12 @@ void solveAllAlgorithms(Maze& maze) {
             timeStr = std::to_string(result.metrics.timeTakenMs / 1000.0) + " ms";
         }
         
+        std::ostringstream cost;
+        cost << std::fixed << std::setprecision(1) << result.metrics.pathCost;
+        
         std::cout << std::left << std::setw(20) << name
                   << std::setw(12) << result.metrics.pathLength
+                  << std::setw(10) << cost.str()
                   << std::setw(15) << result.metrics.nodesExplored
                   << std::setw(10) << timeStr
                   << std::setw(8) << (result.success ? "Yes" : "No") << "\n";
@@ -161,6 +249,33 @@ void solveAllAlgorithms(Maze& maze) {
     printRow("Bidirectional A*", doubleAstar);
     printRow("Jump Point Search", jps);
     
+    std::cout << "\n" << std::left << std::setw(20) << "Search Counters"
+              << std::setw(10) << "Pushes"
+              << std::setw(10) << "Stale"
+              << std::setw(11) << "Peak Open"
+              << std::setw(9) << "Reopen"
+              << std::setw(10) << "h Evals"
+              << std::setw(11) << "Scratch"
+              << std::setw(12) << "Expansions" << "\n";
+    std::cout << std::string(93, '-') << "\n";
+    
+    auto printCounters = [](const std::string& name, const AlgorithmResult& result) {
+        const Metrics& m = result.metrics;
+        std::cout << std::left << std::setw(20) << name
+                  << std::setw(10) << m.heapPushes
+                  << std::setw(10) << m.stalePops
+                  << std::setw(11) << m.peakOpenSize
+                  << std::setw(9) << m.reopenings
+                  << std::setw(10) << m.heuristicEvaluations
+                  << std::setw(11) << (std::to_string((m.bytesAllocated + 1023) / 1024) + " KB")
+                  << std::setw(12) << formatRate(m.expansionsPerSecond()) << "\n";
+    };
+    
+    printCounters("Dijkstra", dijkstra);
+    printCounters("A*", astar);
+    printCounters("Bidirectional A*", doubleAstar);
+    printCounters("Jump Point Search", jps);
+    
     // Show visualization of the fastest successful algorithm
     AlgorithmResult* fastest = nullptr;
     if (astar.success) fastest = &astar;
@@ -170,7 +285,8 @@ void solveAllAlgorithms(Maze& maze) {
     
     if (fastest) {
         std::cout << "\nFastest Algorithm Path Visualization:\n";
-        maze.markPath(fastest->path);
+        // The timed runs are Compact, so the path is only the route until expanded here
+        maze.markPath(fastest->route.cells(maze));
         std::cout << maze.toAscii() << std::endl;
         maze.reset();
     }
@@ -180,10 +296,10 @@ void runRobustAnalysis(Maze& maze) {
     std::cout << "\n🔬 Running Robust Analysis (3 runs per algorithm)...\n";
     
     // UPDATED: Wrapped in lambdas here as well
-    RobustMetrics dijkstraMetrics = Utility::runAlgorithmMultipleTimes(maze, [](Maze& m){ return Dijkstra::solve(m); }, 3);
-    RobustMetrics astarMetrics = Utility::runAlgorithmMultipleTimes(maze, [](Maze& m){ return AStar::solve(m); }, 3);
-    RobustMetrics doubleAstarMetrics = Utility::runAlgorithmMultipleTimes(maze, [](Maze& m){ return DoubleAStar::solve(m); }, 3);
-    RobustMetrics jpsMetrics = Utility::runAlgorithmMultipleTimes(maze, [](Maze& m){ return JumpPointSearch::solve(m); }, 3);
+    RobustMetrics dijkstraMetrics = Utility::runAlgorithmMultipleTimes(maze, [](Maze& m){ return Dijkstra::solve(m, nullptr, ResultDetail::Compact); }, 3);
+    RobustMetrics astarMetrics = Utility::runAlgorithmMultipleTimes(maze, [](Maze& m){ return AStar::solve(m, nullptr, ResultDetail::Compact); }, 3);
+    RobustMetrics doubleAstarMetrics = Utility::runAlgorithmMultipleTimes(maze, [](Maze& m){ return DoubleAStar::solve(m, nullptr, ResultDetail::Compact); }, 3);
+    RobustMetrics jpsMetrics = Utility::runAlgorithmMultipleTimes(maze, [](Maze& m){ return JumpPointSearch::solve(m, nullptr, ResultDetail::Compact); }, 3);
     
     printRobustMetrics("Dijkstra", dijkstraMetrics);
     printRobustMetrics("A*", astarMetrics);
@@ -191,22 +307,856 @@ void runRobustAnalysis(Maze& maze) {
     printRobustMetrics("Jump Point Search", jpsMetrics);
 }
 
-int main() {
+void runDiagonalBenchmark() {
+    std::cout << "\n📐 8-Connected Benchmark: Jump Point Search vs A* (open-room maps)\n";
+    std::cout << std::left << std::setw(10) << "Size"
+              << std::setw(14) << "A* Nodes"
+              << std::setw(14) << "JPS Nodes"
+              << std::setw(12) << "Pruned"
+              << std::setw(12) << "A* Time"
+              << std::setw(12) << "JPS Time"
+              << std::setw(10) << "Optimal" << "\n";
+    std::cout << std::string(84, '-') << "\n";
+    
+    const int sizes[] = {51, 101, 201, 401};
+    for (int size : sizes) {
+        Maze maze(size, size, openRoomOptions(size));
+        maze.setMovementMode(MovementMode::EightWay);
+        
+        AlgorithmResult astar = Utility::runAlgorithmSafely(maze, [](Maze& m){ return AStar::solve(m, nullptr, ResultDetail::Compact); });
+        AlgorithmResult jps = Utility::runAlgorithmSafely(maze, [](Maze& m){ return JumpPointSearch::solve(m, nullptr, ResultDetail::Compact); });
+        
+        double pruned = astar.metrics.nodesExplored > 0
+            ? 100.0 * (1.0 - double(jps.metrics.nodesExplored) / astar.metrics.nodesExplored) : 0.0;
+        bool optimal = astar.success && jps.success &&
+                       std::abs(astar.metrics.pathCost - jps.metrics.pathCost) < 1e-6;
+        
+        std::ostringstream prunedStr;
+        prunedStr << std::fixed << std::setprecision(1) << pruned << "%";
+        
+        std::cout << std::left << std::setw(10) << (std::to_string(maze.getWidth()) + "x" + std::to_string(maze.getHeight()))
+                  << std::setw(14) << astar.metrics.nodesExplored
+                  << std::setw(14) << jps.metrics.nodesExplored
+                  << std::setw(12) << prunedStr.str()
+                  << std::setw(12) << (std::to_string(astar.metrics.timeTakenMs) + " μs")
+                  << std::setw(12) << (std::to_string(jps.metrics.timeTakenMs) + " μs")
+                  << std::setw(10) << (optimal ? "Yes" : "No") << "\n";
+    }
+}
+
+void configureScenario(Maze& maze) {
+    GeneratorOptions opts = maze.getGeneratorOptions();
+    std::cout << "\n🧱 Scenario Settings (current: " << describeScenario(opts) << ")\n";
+    opts.braidFraction = getIntegerInput("Dead ends to braid into loops (0-100%): ", 0, 100) / 100.0;
+    opts.roomCount = getIntegerInput("Open rooms to carve (0-50): ", 0, 50);
+    if (opts.roomCount > 0) opts.maxRoomSize = getIntegerInput("Largest room side (3-31): ", 3, 31);
+    opts.obstacleDensity = getIntegerInput("Random obstacle density (0-40%): ", 0, 40) / 100.0;
+    opts.seed = 0;
+    
+    maze.setGeneratorOptions(opts);
+    maze.generate();
+    std::cout << "New maze generated: " << describeScenario(opts) << "\n";
+    if (opts.obstacleDensity > 0.0) {
+        std::cout << "Obstacles placed: " << std::fixed << std::setprecision(1)
+                  << maze.getObstacleDensity() * 100 << "% of the open area\n";
+    }
+}
+
+void runScenarioBenchmark() {
+    std::cout << "\n🗺️  Scenario Benchmark: all algorithms on perfect, looped and open maps\n";
+    
+    struct Scenario { std::string name; GeneratorOptions opts; };
+    std::vector<Scenario> scenarios(4);
+    scenarios[0].name = "Perfect";
+    scenarios[1].name = "Braided 50%";
+    scenarios[1].opts.braidFraction = 0.5;
+    scenarios[2].name = "Open rooms";
+    scenarios[2].opts.braidFraction = 1.0;
+    scenarios[2].opts.roomCount = 12;
+    scenarios[2].opts.maxRoomSize = 21;
+    scenarios[3].name = "Obstacles 20%";
+    scenarios[3].opts.braidFraction = 1.0;
+    scenarios[3].opts.roomCount = 30;
+    scenarios[3].opts.maxRoomSize = 31;
+    scenarios[3].opts.obstacleDensity = 0.2;
+    
+    const int size = 101;
+    std::cout << std::left << std::setw(16) << "Scenario"
+              << std::setw(20) << "Algorithm"
+              << std::setw(10) << "Cost"
+              << std::setw(15) << "Nodes Explored"
+              << std::setw(12) << "Time"
+              << std::setw(10) << "Pushes"
+              << std::setw(11) << "Peak Open"
+              << std::setw(12) << "Expansions"
+              << std::setw(8) << "Success" << "\n";
+    std::cout << std::string(114, '-') << "\n";
+    
+    for (auto& scenario : scenarios) {
+        scenario.opts.seed = 2024;
+        Maze maze(size, size, scenario.opts);
+        
+        const std::pair<std::string, std::function<AlgorithmResult(Maze&)>> algorithms[] = {
+            {"Dijkstra", [](Maze& m){ return Dijkstra::solve(m, nullptr, ResultDetail::Compact); }},
+            {"A*", [](Maze& m){ return AStar::solve(m, nullptr, ResultDetail::Compact); }},
+            {"Bidirectional A*", [](Maze& m){ return DoubleAStar::solve(m, nullptr, ResultDetail::Compact); }},
+            {"Jump Point Search", [](Maze& m){ return JumpPointSearch::solve(m, nullptr, ResultDetail::Compact); }},
+        };
+        for (const auto& [name, algorithm] : algorithms) {
+            AlgorithmResult result = Utility::runAlgorithmSafely(maze, algorithm);
+            std::ostringstream cost;
+            cost << std::fixed << std::setprecision(1) << result.metrics.pathCost;
+            std::cout << std::left << std::setw(16) << scenario.name
+                      << std::setw(20) << name
+                      << std::setw(10) << cost.str()
+                      << std::setw(15) << result.metrics.nodesExplored
+                      << std::setw(12) << (std::to_string(result.metrics.timeTakenMs) + " μs")
+                      << std::setw(10) << result.metrics.heapPushes
+                      << std::setw(11) << result.metrics.peakOpenSize
+                      << std::setw(12) << formatRate(result.metrics.expansionsPerSecond())
+                      << std::setw(8) << (result.success ? "Yes" : "No") << "\n";
+        }
+    }
+}
+
+std::string getPathInput(const std::string& prompt) {
+    std::string path;
+    std::cout << prompt;
+    std::cin >> std::ws;
+    std::getline(std::cin, path);
+    return path;
+}
+
+void saveMaze(Maze& maze) {
+    std::string path = getPathInput("File to write (e.g. maze.mazebin): ");
+    std::string error;
+    if (MazeFile::save(maze, path, error)) {
+        std::cout << "Saved " << maze.getWidth() << "x" << maze.getHeight() << " maze to " << path << "\n";
+    } else {
+        std::cout << "⚠️  " << error << "\n";
+    }
+}
+
+void loadMaze(Maze& maze) {
+    std::string path = getPathInput("File to open: ");
+    std::string error;
+    
+    auto t0 = std::chrono::high_resolution_clock::now();
+    std::shared_ptr<MappedMaze> file = MappedMaze::open(path, error);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    if (!file) {
+        std::cout << "⚠️  " << error << "\n";
+        return;
+    }
+    
+    bool checksumOk = file->verifyChecksum();
+    auto t2 = std::chrono::high_resolution_clock::now();
+    
+    MovementMode mode = maze.getMovementMode();
+    maze = Maze(file);
+    maze.setMovementMode(mode);
+    
+    auto micros = [](auto d) { return std::chrono::duration_cast<std::chrono::microseconds>(d).count(); };
+    std::cout << "Mapped " << maze.getWidth() << "x" << maze.getHeight() << " maze ("
+              << file->fileSize() << " bytes) in " << micros(t1 - t0) << " μs\n";
+    std::cout << "Checksum " << (checksumOk ? "OK" : "MISMATCH") << " (verified in " << micros(t2 - t1) << " μs)\n";
+}
+
+void runMovingAIBenchmark() {
+    std::string scenPath = getPathInput("Scenario file (.scen): ");
+    std::string error;
+    std::vector<MovingAI::Query> queries;
+    if (!MovingAI::loadScenario(scenPath, queries, error)) {
+        std::cout << "⚠️  " << error << "\n";
+        return;
+    }
+    
+    // A .scen normally targets one map, but group by name to be safe
+    std::map<std::string, std::vector<MovingAI::Query>> byMap;
+    for (const auto& q : queries) byMap[q.map].push_back(q);
+    
+    // One arena for every query: after the first few, solves stop touching the heap
+    SolveArena arena;
+    const std::pair<std::string, std::function<AlgorithmResult(Maze&)>> algorithms[] = {
+        {"Dijkstra", [&arena](Maze& m){ return Dijkstra::solve(m, nullptr, ResultDetail::Compact, &arena); }},
+        {"A*", [&arena](Maze& m){ return AStar::solve(m, nullptr, ResultDetail::Compact, &arena); }},
+        {"Bidirectional A*", [&arena](Maze& m){ return DoubleAStar::solve(m, nullptr, ResultDetail::Compact, &arena); }},
+        {"Jump Point Search", [&arena](Maze& m){ return JumpPointSearch::solve(m, nullptr, ResultDetail::Compact, &arena); }},
+    };
+    
+    for (const auto& [mapName, mapQueries] : byMap) {
+        std::string mapPath = MovingAI::resolveMapPath(scenPath, mapName);
+        Maze maze(1, 1);
+        if (!MovingAI::loadMap(mapPath, maze, error)) {
+            std::cout << "⚠️  " << error << "\n";
+            continue;
+        }
+        
+        std::cout << "\n🗺️  " << mapName << " (" << maze.getWidth() << "x" << maze.getHeight() << "), "
+                  << mapQueries.size() << " queries\n";
+        // Mismatched queries are skipped by runQueries; name the first few here
+        size_t badQueries = 0;
+        for (const auto& q : mapQueries) {
+            std::string why = MovingAI::checkQuery(maze, q);
+            if (why.empty()) continue;
+            if (++badQueries <= 3) {
+                std::cout << "⚠️  Skipping query (" << q.startX << "," << q.startY << ") -> (" << q.goalX << ","
+                          << q.goalY << "): " << why << "\n";
+            }
+        }
+        if (badQueries > 3) std::cout << "⚠️  ... " << badQueries - 3 << " more skipped\n";
+        std::cout << std::left << std::setw(20) << "Algorithm"
+                  << std::setw(8) << "Bucket"
+                  << std::setw(9) << "Solved"
+                  << std::setw(9) << "Optimal"
+                  << std::setw(9) << "Skipped"
+                  << std::setw(12) << "Avg Nodes"
+                  << std::setw(12) << "Avg Time"
+                  << std::setw(12) << "Median"
+                  << std::setw(10) << "Allocs" << "\n";
+        std::cout << std::string(101, '-') << "\n";
+        
+        for (const auto& [name, algorithm] : algorithms) {
+            std::vector<MovingAI::BucketStats> buckets = MovingAI::runQueries(maze, mapQueries, algorithm);
+            int queriesTotal = 0, optimalTotal = 0;
+            for (const auto& b : buckets) {
+                queriesTotal += b.queries;
+                optimalTotal += b.optimal;
+                size_t avgNodes = b.solved ? b.total.nodesExplored / b.solved : 0;
+                std::cout << std::left << std::setw(20) << name
+                          << std::setw(8) << b.bucket
+                          << std::setw(9) << (std::to_string(b.solved) + "/" + std::to_string(b.queries))
+                          << std::setw(9) << b.optimal
+                          << std::setw(9) << b.skipped
+                          << std::setw(12) << avgNodes
+                          << std::setw(12) << (b.solved ? std::to_string(b.timing.averageTime) + " μs" : "-")
+                          << std::setw(12) << (b.solved ? std::to_string(b.timing.medianTime) + " μs" : "-")
+                          << std::setw(10) << b.total.heapAllocations << "\n";
+            }
+            std::cout << std::left << std::setw(20) << name << "optimal on " << optimalTotal << "/"
+                      << queriesTotal << " queries\n";
+        }
+    }
+}
+
+void runLandmarkBenchmark(const Maze& source) {
+    // Work on a copy: endpoints get moved around and landmarks attached
+    Maze maze = source;
+    const int queryCount = 50;
+    
+    // Random open start/goal pairs, fixed seed so every k sees the same queries
+    std::vector<std::pair<Cell*, Cell*>> queries;
+    std::vector<Cell*> open;
+    for (int y = 0; y < maze.getHeight(); ++y)
+        for (int x = 0; x < maze.getWidth(); ++x)
+            if (maze.isWalkable(x, y)) open.push_back(maze.getCellPtr(x, y));
+    if (open.size() < 2) {
+        std::cout << "Maze has no open cells to query!\n";
+        return;
+    }
+    std::mt19937 gen(12345);
+    std::uniform_int_distribution<size_t> pick(0, open.size() - 1);
+    for (int i = 0; i < queryCount; ++i) queries.push_back({open[pick(gen)], open[pick(gen)]});
+    
+    // Reference costs for the optimality check
+    SolveArena arena;
+    std::vector<double> optimal;
+    for (auto& [s, g] : queries) {
+        maze.setEndpoints(s->x, s->y, g->x, g->y);
+        AlgorithmResult r = Dijkstra::solve(maze, nullptr, ResultDetail::Compact, &arena);
+        optimal.push_back(r.success ? r.metrics.pathCost : -1.0);
+    }
+    
+    std::cout << "\n🧭 ALT Landmarks: " << maze.getWidth() << "x" << maze.getHeight() << ", "
+              << movementName(maze.getMovementMode()) << ", " << queryCount << " random queries\n";
+    std::cout << std::left << std::setw(6) << "k"
+              << std::setw(12) << "Build"
+              << std::setw(14) << "Mem/Landmark"
+              << std::setw(12) << "Total Mem"
+              << std::setw(14) << "A* Nodes"
+              << std::setw(10) << "Saved"
+              << std::setw(14) << "BiA* Nodes"
+              << std::setw(10) << "Saved"
+              << std::setw(10) << "Optimal" << "\n";
+    std::cout << std::string(102, '-') << "\n";
+    
+    double baseAStar = 0.0, baseBi = 0.0;
+    const int ks[] = {0, 1, 2, 4, 8, 16};
+    for (int k : ks) {
+        auto buildStart = std::chrono::high_resolution_clock::now();
+        std::shared_ptr<LandmarkTable> table = k > 0 ? LandmarkTable::build(maze, k) : nullptr;
+        auto buildUs = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now() - buildStart).count();
+        maze.setLandmarks(table);
+        
+        size_t astarNodes = 0, biNodes = 0;
+        int optimalCount = 0, solvable = 0;
+        for (size_t i = 0; i < queries.size(); ++i) {
+            Cell* s = queries[i].first;
+            Cell* g = queries[i].second;
+            maze.setEndpoints(s->x, s->y, g->x, g->y);
+            AlgorithmResult astar = AStar::solve(maze, nullptr, ResultDetail::Compact, &arena);
+            AlgorithmResult bi = DoubleAStar::solve(maze, nullptr, ResultDetail::Compact, &arena);
+            astarNodes += astar.metrics.nodesExplored;
+            biNodes += bi.metrics.nodesExplored;
+            if (optimal[i] >= 0.0) {
+                solvable++;
+                if (astar.success && std::abs(astar.metrics.pathCost - optimal[i]) < 1e-6) optimalCount++;
+            }
+        }
+        double avgAStar = double(astarNodes) / queries.size();
+        double avgBi = double(biNodes) / queries.size();
+        if (k == 0) { baseAStar = avgAStar; baseBi = avgBi; }
+        
+        auto percent = [](double base, double now) {
+            std::ostringstream out;
+            out << std::fixed << std::setprecision(1) << (base > 0 ? 100.0 * (1.0 - now / base) : 0.0) << "%";
+            return out.str();
+        };
+        auto kib = [](size_t bytes) {
+            std::ostringstream out;
+            out << std::fixed << std::setprecision(1) << bytes / 1024.0 << " KiB";
+            return out.str();
+        };
+        std::ostringstream a, b;
+        a << std::fixed << std::setprecision(0) << avgAStar;
+        b << std::fixed << std::setprecision(0) << avgBi;
+        
+        std::cout << std::left << std::setw(6) << (table ? table->count() : 0)
+                  << std::setw(12) << (std::to_string(buildUs / 1000) + " ms")
+                  << std::setw(14) << (table ? kib(table->bytesPerLandmark()) : "-")
+                  << std::setw(12) << (table ? kib(table->memoryBytes()) : "-")
+                  << std::setw(14) << a.str()
+                  << std::setw(10) << percent(baseAStar, avgAStar)
+                  << std::setw(14) << b.str()
+                  << std::setw(10) << percent(baseBi, avgBi)
+                  << std::setw(10) << (std::to_string(optimalCount) + "/" + std::to_string(solvable)) << "\n";
+    }
+    std::cout << "(Optimal = A* queries matching Dijkstra's cost; nodes are per-query averages)\n";
+}
+
+void runParallelBidirectionalBenchmark(const Maze& source) {
+    const GeneratorOptions opts = source.getGeneratorOptions();
+    const MovementMode mode = source.getMovementMode();
+    const int runs = 3;
+    
+    std::cout << "\n🧵 Parallel Bidirectional A*: " << describeScenario(opts) << ", " << movementName(mode)
+              << ", " << std::thread::hardware_concurrency() << " hardware threads (best of " << runs << ")\n";
+    std::cout << std::left << std::setw(12) << "Size"
+              << std::setw(12) << "Path Cost"
+              << std::setw(14) << "1 Thread"
+              << std::setw(14) << "2 Threads"
+              << std::setw(10) << "Speedup"
+              << std::setw(14) << "Nodes (1T)"
+              << std::setw(14) << "Nodes (2T)"
+              << std::setw(10) << "Optimal" << "\n";
+    std::cout << std::string(100, '-') << "\n";
+    
+    SolveArena arena;
+    const int sizes[] = {251, 501, 1001, 2001};
+    for (int size : sizes) {
+        Maze maze(size, size, opts);
+        maze.setMovementMode(mode);
+        
+        AlgorithmResult single, parallel;
+        long long bestSingle = std::numeric_limits<long long>::max();
+        long long bestParallel = std::numeric_limits<long long>::max();
+        for (int i = 0; i < runs; ++i) {
+            single = DoubleAStar::solve(maze, nullptr, ResultDetail::Compact, &arena);
+            parallel = DoubleAStar::solveParallel(maze, ResultDetail::Compact, &arena);
+            bestSingle = std::min(bestSingle, single.metrics.timeTakenMs);
+            bestParallel = std::min(bestParallel, parallel.metrics.timeTakenMs);
+        }
+        bool optimal = single.success == parallel.success &&
+                       std::abs(single.metrics.pathCost - parallel.metrics.pathCost) < 1e-6;
+        
+        std::ostringstream cost, speedup;
+        cost << std::fixed << std::setprecision(1) << parallel.metrics.pathCost;
+        speedup << std::fixed << std::setprecision(2) << double(bestSingle) / bestParallel << "x";
+        
+        std::cout << std::left << std::setw(12) << (std::to_string(size) + "x" + std::to_string(size))
+                  << std::setw(12) << cost.str()
+                  << std::setw(14) << (std::to_string(bestSingle) + " μs")
+                  << std::setw(14) << (std::to_string(bestParallel) + " μs")
+                  << std::setw(10) << speedup.str()
+                  << std::setw(14) << single.metrics.nodesExplored
+                  << std::setw(14) << parallel.metrics.nodesExplored
+                  << std::setw(10) << (optimal ? "Yes" : "No") << "\n";
+    }
+    std::cout << "(Uses the current scenario settings and movement mode)\n";
+}
+
+void runDistanceFieldBenchmark(const Maze& source) {
+    const GeneratorOptions opts = source.getGeneratorOptions();
+    const MovementMode mode = source.getMovementMode();
+    const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    const int runs = 3;
+    
+    std::cout << "\n🌊 Parallel BFS Distance Field: " << describeScenario(opts) << ", " << movementName(mode)
+              << ", " << hardware << " hardware threads (best of " << runs << ")\n";
+    std::cout << std::left << std::setw(12) << "Size"
+              << std::setw(10) << "Threads"
+              << std::setw(14) << "Time"
+              << std::setw(12) << "Reached"
+              << std::setw(12) << "Max Dist"
+              << std::setw(14) << "Levels TD/BU"
+              << std::setw(14) << "MEdges/s"
+              << std::setw(10) << "Speedup"
+              << std::setw(8) << "Match" << "\n";
+    std::cout << std::string(106, '-') << "\n";
+    
+    std::vector<unsigned> threadCounts;
+    for (unsigned t = 1; t < hardware; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(hardware);
+    
+    const int sizes[] = {501, 1001, 2001};
+    for (int size : sizes) {
+        Maze maze(size, size, opts);
+        maze.setMovementMode(mode);
+        Cell* start = maze.getStart();
+        
+        DistanceField baseline;
+        auto printRow = [&](const std::string& engine, const DistanceField& field, const std::string& levels) {
+            std::ostringstream rate, speedup;
+            rate << std::fixed << std::setprecision(1) << field.edgesPerSecond() / 1e6;
+            speedup << std::fixed << std::setprecision(2) << double(baseline.timeTakenUs) / field.timeTakenUs << "x";
+            
+            std::cout << std::left << std::setw(12) << (std::to_string(size) + "x" + std::to_string(size))
+                      << std::setw(10) << engine
+                      << std::setw(14) << (std::to_string(field.timeTakenUs) + " μs")
+                      << std::setw(12) << field.reached
+                      << std::setw(12) << field.eccentricity
+                      << std::setw(14) << levels
+                      << std::setw(14) << rate.str()
+                      << std::setw(10) << speedup.str()
+                      << std::setw(8) << (field.distance == baseline.distance ? "Yes" : "No") << "\n";
+        };
+        
+        for (unsigned threads : threadCounts) {
+            DistanceField field;
+            long long best = std::numeric_limits<long long>::max();
+            for (int i = 0; i < runs; ++i) {
+                field = ParallelBFS::distances(maze, start->x, start->y, threads);
+                best = std::min(best, field.timeTakenUs);
+            }
+            field.timeTakenUs = best;
+            if (threads == 1) baseline = field;
+            printRow(std::to_string(threads),
+                     field, std::to_string(field.topDownLevels) + "/" + std::to_string(field.bottomUpLevels));
+        }
+        
+        // Unit costs: the single-threaded bit-parallel flood as well
+        if (mode == MovementMode::FourWay) {
+            DistanceField field;
+            long long best = std::numeric_limits<long long>::max();
+            for (int i = 0; i < runs; ++i) {
+                field = BitBFS::distances(maze, start->x, start->y);
+                best = std::min(best, field.timeTakenUs);
+            }
+            field.timeTakenUs = best;
+            printRow(BitBFS::usesAvx2() ? "bits+AVX2" : "bits", field, "-");
+        }
+    }
+    std::cout << "(Distances in steps from the start cell; edges = edges inside the reached component)\n";
+}
+
+void runLayoutBenchmark(const Maze& source) {
+    const GeneratorOptions opts = source.getGeneratorOptions();
+    const MovementMode mode = source.getMovementMode();
+    const int runs = 3;
+    
+    struct Solver {
+        const char* name;
+        AlgorithmResult (*solve)(Maze&, std::function<void(Cell*, Cell*)>, ResultDetail, SolveArena*);
+    };
+    const Solver solvers[] = {
+        {"Dijkstra", Dijkstra::solve},
+        {"A*", AStar::solve},
+        {"Bidir A*", DoubleAStar::solve},
+        {"JPS", JumpPointSearch::solve},
+    };
+    const CellOrder orders[] = {CellOrder::RowMajor, CellOrder::Tiled, CellOrder::Morton};
+    
+    std::cout << "\n🧱 Cell Layout Benchmark: " << describeScenario(opts) << ", " << movementName(mode)
+              << " (best of " << runs << ")\n";
+    std::cout << std::left << std::setw(12) << "Size"
+              << std::setw(11) << "Layout";
+    for (const Solver& solver : solvers) std::cout << std::setw(14) << solver.name;
+    std::cout << std::setw(12) << "Slots" << std::setw(8) << "Match" << "\n";
+    std::cout << std::string(99, '-') << "\n";
+    
+    SolveArena arena;
+    const int sizes[] = {501, 1001, 2001};
+    for (int size : sizes) {
+        Maze maze(size, size, opts);
+        maze.setMovementMode(mode);
+        
+        // Row-major results are the reference: a layout only moves cells in memory
+        std::vector<AlgorithmResult> reference;
+        for (CellOrder order : orders) {
+            maze.setCellOrder(order);
+            std::cout << std::left << std::setw(12) << (std::to_string(size) + "x" + std::to_string(size))
+                      << std::setw(11) << CellLayout::name(order);
+            
+            bool match = true;
+            for (size_t s = 0; s < std::size(solvers); ++s) {
+                AlgorithmResult result;
+                long long best = std::numeric_limits<long long>::max();
+                for (int i = 0; i < runs; ++i) {
+                    result = solvers[s].solve(maze, nullptr, ResultDetail::Compact, &arena);
+                    best = std::min(best, result.metrics.timeTakenMs);
+                }
+                if (order == CellOrder::RowMajor) {
+                    reference.push_back(result);
+                } else {
+                    const AlgorithmResult& expected = reference[s];
+                    match = match && result.success == expected.success &&
+                            std::abs(result.metrics.pathCost - expected.metrics.pathCost) < 1e-6 &&
+                            result.metrics.nodesExplored == expected.metrics.nodesExplored;
+                }
+                std::cout << std::setw(14) << (std::to_string(best) + " μs");
+            }
+            std::cout << std::setw(12) << maze.slotCount()
+                      << std::setw(8) << (match ? "Yes" : "No") << "\n";
+        }
+    }
+    std::cout << "(Same mazes and queries in every layout; Match = same costs and expansions as row-major)\n";
+}
+
+void runMemoryBackendBenchmark(const Maze& source) {
+    const GeneratorOptions opts = source.getGeneratorOptions();
+    const MovementMode mode = source.getMovementMode();
+    const int queryCount = 8;
+    
+    std::vector<MemoryOptions> backends = {
+        {PageMode::Default, NumaPolicy::Local, 0},
+        {PageMode::Transparent, NumaPolicy::Local, 0},
+        {PageMode::Explicit, NumaPolicy::Local, 0},
+        {PageMode::Transparent, NumaPolicy::Interleave, 0},
+    };
+    const int nodes = GridMemory::numaNodes();
+    if (nodes > 1) backends.push_back({PageMode::Transparent, NumaPolicy::Bind, nodes - 1});
+    
+    HardwareCounter tlb(HardwareCounter::Event::DtlbLoadMisses);
+    std::cout << "\n🗺️  Grid Memory Backends: " << describeScenario(opts) << ", " << movementName(mode) << ", "
+              << nodes << " NUMA node(s), " << queryCount << " random A* + bidirectional A* queries"
+              << (tlb.available() ? "" : " (dTLB counter unavailable)") << "\n";
+    std::cout << std::left << std::setw(12) << "Size"
+              << std::setw(20) << "Backend"
+              << std::setw(12) << "Mapped MB"
+              << std::setw(14) << "Time"
+              << std::setw(10) << "Delta"
+              << std::setw(14) << "dTLB Misses"
+              << std::setw(10) << "Delta"
+              << std::setw(12) << "Fallbacks"
+              << std::setw(8) << "Match" << "\n";
+    std::cout << std::string(112, '-') << "\n";
+    
+    auto percent = [](double value, double base) {
+        std::ostringstream out;
+        out << std::showpos << std::fixed << std::setprecision(1) << (value / base - 1.0) * 100.0 << "%";
+        return out.str();
+    };
+    
+    const int sizes[] = {1001, 2001, 3001};
+    for (int size : sizes) {
+        Maze maze(size, size, opts);
+        maze.setMovementMode(mode);
+        
+        // Coordinates, not cell pointers: the cells move with every backend switch
+        std::vector<std::pair<int, int>> open;
+        for (int y = 0; y < maze.getHeight(); ++y)
+            for (int x = 0; x < maze.getWidth(); ++x)
+                if (maze.isWalkable(x, y)) open.push_back({x, y});
+        std::mt19937 gen(12345);
+        std::uniform_int_distribution<size_t> pick(0, open.size() - 1);
+        std::vector<std::pair<std::pair<int, int>, std::pair<int, int>>> queries;
+        for (int i = 0; i < queryCount; ++i) queries.push_back({open[pick(gen)], open[pick(gen)]});
+        
+        long long baseTime = 0, baseMisses = -1;
+        double baseCost = 0.0;
+        for (const MemoryOptions& backend : backends) {
+            auto* grid = dynamic_cast<GridMemory*>(GridMemory::get(backend));
+            GridMemory::Stats before = grid ? grid->stats() : GridMemory::Stats();
+            maze.setMemory(backend);
+            SolveArena arena(64 * 1024, GridMemory::get(backend));
+            auto runAll = [&]() {
+                double cost = 0.0;
+                for (auto& [s, g] : queries) {
+                    maze.setEndpoints(s.first, s.second, g.first, g.second);
+                    cost += AStar::solve(maze, nullptr, ResultDetail::Compact, &arena).metrics.pathCost;
+                    cost += DoubleAStar::solve(maze, nullptr, ResultDetail::Compact, &arena).metrics.pathCost;
+                }
+                return cost;
+            };
+            // Warm-up pass: faults the pages in and grows the arena to its working size
+            runAll();
+            
+            tlb.start();
+            auto begin = std::chrono::high_resolution_clock::now();
+            double cost = runAll();
+            long long us = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::high_resolution_clock::now() - begin).count();
+            long long misses = tlb.stop();
+            
+            GridMemory::Stats stats = grid ? grid->stats() : GridMemory::Stats();
+            if (backend.pages == PageMode::Default) {
+                baseTime = us;
+                baseMisses = misses;
+                baseCost = cost;
+            }
+            
+            std::ostringstream mapped;
+            mapped << std::fixed << std::setprecision(1) << stats.bytesMapped / (1024.0 * 1024.0);
+            std::cout << std::left << std::setw(12) << (std::to_string(size) + "x" + std::to_string(size))
+                      << std::setw(20) << GridMemory::describe(backend)
+                      << std::setw(12) << mapped.str()
+                      << std::setw(14) << (std::to_string(us) + " μs")
+                      << std::setw(10) << (backend.pages == PageMode::Default ? "-" : percent(us, baseTime))
+                      << std::setw(14) << (misses < 0 ? std::string("n/a") : std::to_string(misses))
+                      << std::setw(10) << (misses < 0 || baseMisses <= 0 || backend.pages == PageMode::Default
+                                           ? std::string("-") : percent(misses, baseMisses))
+                      << std::setw(12) << (std::to_string(stats.hugeFallbacks - before.hugeFallbacks) + "/" +
+                                           std::to_string(stats.policyFailures - before.policyFailures))
+                      << std::setw(8) << (std::abs(cost - baseCost) < 1e-6 ? "Yes" : "No") << "\n";
+        }
+        maze.setMemory(MemoryOptions());
+    }
+    std::cout << "(Deltas against the heap; Fallbacks = hugetlb requests served by THP / NUMA policies refused)\n";
+}
+
+void runOutOfCoreBenchmark(const Maze& source) {
+    const GeneratorOptions opts = source.getGeneratorOptions();
+    const MovementMode mode = source.getMovementMode();
+    std::string path = getPathInput("Scratch file for the tiled mazes (e.g. world.mazetiles): ");
+    std::string error;
+    
+    // 1) Agreement with the in-memory solvers on a maze that does fit
+    {
+        const int size = 1001, queryCount = 8;
+        Maze maze(size, size, opts);
+        maze.setMovementMode(mode);
+        if (!TiledMaze::save(maze, path, TiledMaze::DEFAULT_TILE, error)) {
+            std::cout << "⚠️  " << error << "\n";
+            return;
+        }
+        std::unique_ptr<TiledMaze> tiled = TiledMaze::open(path, 8, error);
+        if (!tiled) {
+            std::cout << "⚠️  " << error << "\n";
+            return;
+        }
+        
+        std::vector<std::pair<int, int>> open;
+        for (int y = 0; y < size; ++y)
+            for (int x = 0; x < size; ++x)
+                if (maze.isWalkable(x, y)) open.push_back({x, y});
+        std::mt19937 gen(12345);
+        std::uniform_int_distribution<size_t> pick(0, open.size() - 1);
+        
+        int bfsMatch = 0, astarMatch = 0;
+        for (int i = 0; i < queryCount; ++i) {
+            auto [s, g] = std::make_pair(open[pick(gen)], open[pick(gen)]);
+            maze.setEndpoints(s.first, s.second, g.first, g.second);
+            AlgorithmResult reference = AStar::solve(maze, nullptr, ResultDetail::Compact);
+            OutOfCoreResult a = OutOfCoreSearch::astar(*tiled, s.first, s.second, g.first, g.second, mode);
+            OutOfCoreResult b = OutOfCoreSearch::bfs(*tiled, s.first, s.second, g.first, g.second, mode);
+            astarMatch += a.success == reference.success &&
+                          std::abs(a.metrics.pathCost - reference.metrics.pathCost) < 1e-6 &&
+                          OutOfCoreSearch::validate(*tiled, s.first, s.second, g.first, g.second, mode, a.moves);
+            // BFS counts steps, which are only path costs on 4-connected grids
+            bfsMatch += b.success == reference.success &&
+                        (mode == MovementMode::EightWay || std::abs(b.metrics.pathCost - reference.metrics.pathCost) < 1e-6);
+        }
+        std::cout << "\n💾 Out-of-core check: " << size << "x" << size << " " << describeScenario(opts) << ", "
+                  << movementName(mode) << ", 8-tile cache: A* " << astarMatch << "/" << queryCount
+                  << ", BFS " << bfsMatch << "/" << queryCount << " agree with the in-memory A*\n";
+    }
+    
+    // 2) A synthetic world far bigger than Maze would hold, through small caches
+    const int size = 20000, queryCount = 5, reach = 600;
+    const double density = 0.2;
+    std::cout << "Writing " << size << "x" << size << " obstacle field (" << int(density * 100) << "% walls)... "
+              << std::flush;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    if (!TiledMaze::generate(path, size, size, TiledMaze::DEFAULT_TILE, density, 2024, error)) {
+        std::cout << "\n⚠️  " << error << "\n";
+        return;
+    }
+    auto writeMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - t0).count();
+    
+    // Open endpoints within 'reach' of each other, picked through a throwaway cache
+    std::vector<std::array<int, 4>> queries;
+    {
+        std::unique_ptr<TiledMaze> picker = TiledMaze::open(path, 4, error);
+        if (!picker) {
+            std::cout << "\n⚠️  " << error << "\n";
+            return;
+        }
+        std::mt19937 gen(777);
+        std::uniform_int_distribution<int> coord(1, size - 2), offset(-reach, reach);
+        while (static_cast<int>(queries.size()) < queryCount) {
+            int sx = coord(gen), sy = coord(gen);
+            int gx = std::clamp(sx + offset(gen), 1, size - 2), gy = std::clamp(sy + offset(gen), 1, size - 2);
+            if (picker->isWalkable(sx, sy) && picker->isWalkable(gx, gy)) queries.push_back({sx, sy, gx, gy});
+        }
+    }
+    
+    const double tileKB = TiledMaze::DEFAULT_TILE * double(TiledMaze::DEFAULT_TILE) / 8 / 1024;
+    std::cout << "done in " << writeMs << " ms. As std::vector<Cell> it would need "
+              << (uint64_t(size) * size * sizeof(Cell) >> 20) << " MB; tiles are " << tileKB << " KB each.\n";
+    std::cout << std::left << std::setw(8) << "Solver"
+              << std::setw(14) << "Cache"
+              << std::setw(10) << "Prefetch"
+              << std::setw(14) << "Avg Time"
+              << std::setw(12) << "Avg Nodes"
+              << std::setw(10) << "Lookups"
+              << std::setw(9) << "Hit %"
+              << std::setw(14) << "Prefetch Hits"
+              << std::setw(12) << "KB/Query"
+              << std::setw(8) << "Spills"
+              << std::setw(8) << "Valid" << "\n";
+    std::cout << std::string(119, '-') << "\n";
+    
+    struct Config { size_t tiles; bool prefetch; };
+    const Config configs[] = {{4, false}, {4, true}, {64, true}};
+    for (int solver = 0; solver < 2; ++solver) {
+        for (const Config& config : configs) {
+            std::unique_ptr<TiledMaze> tiled = TiledMaze::open(path, config.tiles, error);
+            if (!tiled) {
+                std::cout << "⚠️  " << error << "\n";
+                return;
+            }
+            long long totalUs = 0;
+            size_t nodes = 0, lookups = 0, hits = 0, prefetchHits = 0, spills = 0;
+            uint64_t bytes = 0;
+            int valid = 0;
+            for (const auto& q : queries) {
+                OutOfCoreResult r = solver == 0
+                    ? OutOfCoreSearch::bfs(*tiled, q[0], q[1], q[2], q[3], mode, config.prefetch)
+                    : OutOfCoreSearch::astar(*tiled, q[0], q[1], q[2], q[3], mode, config.prefetch);
+                totalUs += r.metrics.timeTakenMs;
+                nodes += r.metrics.nodesExplored;
+                lookups += r.io.lookups;
+                hits += r.io.hits;
+                prefetchHits += r.io.prefetchHits;
+                bytes += r.io.bytesRead;
+                spills += r.labelSpills;
+                valid += r.success && OutOfCoreSearch::validate(*tiled, q[0], q[1], q[2], q[3], mode, r.moves);
+            }
+            std::ostringstream cache, hitRate;
+            cache << config.tiles << " (" << config.tiles * tileKB << " KB)";
+            hitRate << std::fixed << std::setprecision(1) << (lookups ? 100.0 * hits / lookups : 0.0);
+            std::cout << std::left << std::setw(8) << (solver == 0 ? "BFS" : "A*")
+                      << std::setw(14) << cache.str()
+                      << std::setw(10) << (config.prefetch ? "On" : "Off")
+                      << std::setw(14) << (std::to_string(totalUs / queryCount) + " μs")
+                      << std::setw(12) << nodes / queryCount
+                      << std::setw(10) << lookups / queryCount
+                      << std::setw(9) << hitRate.str()
+                      << std::setw(14) << prefetchHits / queryCount
+                      << std::setw(12) << (bytes / queryCount >> 10)
+                      << std::setw(8) << spills / queryCount
+                      << std::setw(8) << (std::to_string(valid) + "/" + std::to_string(queryCount)) << "\n";
+        }
+    }
+    std::remove(path.c_str());
+    std::cout << "(Per-query averages over " << queryCount << " queries with endpoints at most " << reach
+              << " cells apart per axis; the scratch file has been removed)\n";
+}
+
+void togglePhaseTrace() {
+    if (!Profiler::compiledIn()) {
+        std::cout << "Phase tracing is compiled out. Rebuild with -DMAZE_PROFILING=ON (CMake) "
+                     "or -DMAZE_PROFILING (g++) to record zones.\n";
+        return;
+    }
+    if (!Profiler::recording()) {
+        Profiler::start();
+        std::cout << "Recording phase zones. Run some solves or benchmarks, then choose this option again to export.\n";
+        return;
+    }
+    
+    Profiler::stop();
+    std::string path = getPathInput("Trace file to write (e.g. trace.json): ");
+    std::string error;
+    if (Profiler::writeChromeTrace(path, error)) {
+        std::cout << "Wrote " << Profiler::eventCount() << " zones to " << path;
+        if (Profiler::droppedCount() > 0) std::cout << " (" << Profiler::droppedCount() << " dropped: buffers full)";
+        std::cout << ". Open it in chrome://tracing or ui.perfetto.dev\n";
+    } else {
+        std::cout << "⚠️  " << error << "\n";
+    }
+}
+
+// Serves path queries until a client sends SHUTDOWN, then prints the latency table
+bool runQueryServer(const std::string& socketPath, int workers,
+                    size_t memoryBudgetMB = QueryServer::DEFAULT_MEMORY_BUDGET_MB) {
+    QueryServer server(socketPath, workers, memoryBudgetMB);
+    std::string error;
+    if (!server.start(error)) {
+        std::cout << "⚠️  " << error << "\n";
+        return false;
+    }
+    std::cout << "\n🛰️  Query server listening on " << socketPath << " with " << workers << " workers and a "
+              << memoryBudgetMB << " MB maze budget\n";
+    std::cout << "One request per line, e.g. with: socat - UNIX-CONNECT:" << socketPath << "\n";
+    std::cout << "  GENERATE m 1001 1001 braid=50 mode=8 landmarks=8\n";
+    std::cout << "  SOLVE m astar 1 1 999 999\n";
+    std::cout << "  STATS | LIST | DROP m | QUIT | SHUTDOWN\n";
+    server.wait();
+    
+    std::cout << "\nServer stopped. Latency per endpoint (server side):\n";
+    std::cout << std::left << std::setw(10) << "Endpoint"
+              << std::setw(10) << "Requests"
+              << std::setw(8) << "Errors"
+              << std::setw(14) << "Mean"
+              << std::setw(14) << "p50"
+              << std::setw(14) << "p99"
+              << std::setw(14) << "Max" << "\n";
+    std::cout << std::string(84, '-') << "\n";
+    auto micros = [](long long nanos) {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(1) << nanos / 1000.0 << " μs";
+        return out.str();
+    };
+    for (const QueryServer::EndpointStats& s : server.stats()) {
+        std::cout << std::left << std::setw(10) << QueryServer::endpointName(s.endpoint)
+                  << std::setw(10) << s.requests
+                  << std::setw(8) << s.errors
+                  << std::setw(14) << micros(s.latency.averageTime)
+                  << std::setw(14) << micros(s.latency.medianTime)
+                  << std::setw(14) << micros(s.p99)
+                  << std::setw(14) << micros(s.latency.worstTime) << "\n";
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    // MazeSolver --serve <socket> [workers] [budget MB]: the query server alone, no menu
+    if (argc >= 3 && std::string(argv[1]) == "--serve") {
+        int workers = argc >= 4 ? std::max(1, std::atoi(argv[3])) : 4;
+        long long budget = argc >= 5 ? std::atoll(argv[4]) : 0;
+        return runQueryServer(argv[2], workers, budget > 0 ? static_cast<size_t>(budget)
+                                                           : QueryServer::DEFAULT_MEMORY_BUDGET_MB) ? 0 : 1;
+    }
+    
     int mazeSize = 21;
     Maze maze(mazeSize, mazeSize);
     int choice;
+    // MAZE_TRACE=trace.json records phase zones until exit (MAZE_PROFILING builds)
+    Profiler::startFromEnvironment();
     
     std::cout << "🚀 Interactive Maze Solver - C++17 Terminal Version\n";
     std::cout << "==================================================\n";
     
     do {
-        displayMenu();
+        displayMenu(maze);
         std::cin >> choice;
         
         if (std::cin.fail()) {
             std::cin.clear();
             std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-            std::cout << "Invalid input! Please enter a number 1-10.\n";
+            std::cout << "Invalid input! Please enter a number 1-25.\n";
             continue;
         }
         
@@ -214,7 +1164,10 @@ int main() {
             case 1: {
                 int newSize = getIntegerInput("Enter maze size (minimum 5, maximum 101): ", 5, 101);
                 mazeSize = newSize;
-                maze = Maze(mazeSize, mazeSize);
+                MovementMode mode = maze.getMovementMode();
+                GeneratorOptions opts = maze.getGeneratorOptions();
+                maze = Maze(mazeSize, mazeSize, opts);
+                maze.setMovementMode(mode);
                 std::cout << "Maze size set to " << mazeSize << "x" << mazeSize << "\n";
                 break;
             }
@@ -259,15 +1212,80 @@ int main() {
                 break;
             
             case 10:
+                maze.setMovementMode(maze.getMovementMode() == MovementMode::EightWay
+                                     ? MovementMode::FourWay : MovementMode::EightWay);
+                std::cout << "Movement set to " << movementName(maze.getMovementMode()) << "\n";
+                break;
+            
+            case 11:
+                runDiagonalBenchmark();
+                break;
+            
+            case 12:
+                configureScenario(maze);
+                break;
+            
+            case 13:
+                runScenarioBenchmark();
+                break;
+            
+            case 14:
+                saveMaze(maze);
+                break;
+            
+            case 15:
+                loadMaze(maze);
+                break;
+            
+            case 16:
+                runMovingAIBenchmark();
+                break;
+            
+            case 17:
+                runLandmarkBenchmark(maze);
+                break;
+            
+            case 18:
+                runParallelBidirectionalBenchmark(maze);
+                break;
+            
+            case 19:
+                runDistanceFieldBenchmark(maze);
+                break;
+            
+            case 20:
+                runLayoutBenchmark(maze);
+                break;
+            
+            case 21:
+                runMemoryBackendBenchmark(maze);
+                break;
+            
+            case 22:
+                runOutOfCoreBenchmark(maze);
+                break;
+            
+            case 23:
+                togglePhaseTrace();
+                break;
+            
+            case 24: {
+                std::string socketPath = getPathInput("Socket path (e.g. /tmp/mazesolver.sock): ");
+                int workers = getIntegerInput("Worker threads (1-64): ", 1, 64);
+                runQueryServer(socketPath, workers);
+                break;
+            }
+            
+            case 25:
                 std::cout << "Thank you for using Maze Solver! Goodbye!\n";
                 break;
             
             default:
-                std::cout << "Invalid choice! Please enter 1-10.\n";
+                std::cout << "Invalid choice! Please enter 1-25.\n";
                 break;
         }
         
-    } while (choice != 10);
+    } while (choice != 25);
     
     return 0;
 }
\ No newline at end of file
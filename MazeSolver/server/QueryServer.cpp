@@ -0,0 +1,568 @@
+#include "QueryServer.h"
+#include "../core/Landmarks.h"
+#include "../core/MazeFile.h"
+#include "../core/MovingAI.h"
+#include "../core/Profiler.h"
+#include "../core/Utility.h"
+#include "../algorithms/Dijkstra.h"
+#include "../algorithms/AStar.h"
+#include "../algorithms/DoubleAStar.h"
+#include "../algorithms/JumpPointSearch.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    std::vector<std::string> tokenize(const std::string& line) {
+        std::vector<std::string> tokens;
+        std::istringstream in(line);
+        std::string token;
+        while (in >> token) tokens.push_back(token);
+        return tokens;
+    }
+
+    bool parseInt(const std::string& text, int& value) {
+        char* end = nullptr;
+        errno = 0;
+        long parsed = std::strtol(text.c_str(), &end, 10);
+        if (text.empty() || *end != '\0' || errno != 0 || parsed < INT_MIN || parsed > INT_MAX) return false;
+        value = static_cast<int>(parsed);
+        return true;
+    }
+
+    // key=value options after the positional arguments
+    bool parseOptions(const std::vector<std::string>& args, size_t first, std::map<std::string, int>& options,
+                      std::string& error) {
+        for (size_t i = first; i < args.size(); ++i) {
+            size_t eq = args[i].find('=');
+            int value = 0;
+            if (eq == std::string::npos || !parseInt(args[i].substr(eq + 1), value)) {
+                error = "bad option '" + args[i] + "' (expected key=integer)";
+                return false;
+            }
+            options[args[i].substr(0, eq)] = value;
+        }
+        return true;
+    }
+
+    bool parseMode(const std::map<std::string, int>& options, MovementMode fallback, MovementMode& mode,
+                   std::string& error) {
+        auto it = options.find("mode");
+        if (it == options.end()) {
+            mode = fallback;
+            return true;
+        }
+        if (it->second != 4 && it->second != 8) {
+            error = "mode must be 4 or 8";
+            return false;
+        }
+        mode = it->second == 8 ? MovementMode::EightWay : MovementMode::FourWay;
+        return true;
+    }
+
+    int optionOr(const std::map<std::string, int>& options, const std::string& key, int fallback) {
+        auto it = options.find(key);
+        return it == options.end() ? fallback : it->second;
+    }
+
+    bool endsWith(const std::string& text, const std::string& suffix) {
+        return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    // Case-insensitive verbs: the rest of the line is left as typed (names, paths)
+    std::string upper(std::string text) {
+        for (char& c : text) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        return text;
+    }
+}
+
+QueryServer::QueryServer(const std::string& socketPath, int workers, size_t memoryBudgetMB)
+    : socketPath(socketPath), workerCount(std::max(1, workers)), memoryBudget(uint64_t(memoryBudgetMB) << 20) {
+    for (LatencyLog& log : latency) log.samples.reserve(LATENCY_SAMPLES);
+}
+
+QueryServer::~QueryServer() {
+    stop();
+    wait();
+}
+
+const char* QueryServer::endpointName(Endpoint endpoint) {
+    switch (endpoint) {
+        case Endpoint::Ping: return "PING";
+        case Endpoint::Generate: return "GENERATE";
+        case Endpoint::Load: return "LOAD";
+        case Endpoint::Drop: return "DROP";
+        case Endpoint::List: return "LIST";
+        case Endpoint::Solve: return "SOLVE";
+        case Endpoint::Stats: return "STATS";
+        case Endpoint::Other: return "OTHER";
+        case Endpoint::Count: break;
+    }
+    return "?";
+}
+
+#ifdef _WIN32
+
+bool QueryServer::start(std::string& error) {
+    error = "The query server needs Unix domain sockets, which this build does not support";
+    return false;
+}
+
+void QueryServer::stop() {
+    stopping.store(true);
+}
+
+void QueryServer::wait() {}
+
+void QueryServer::acceptLoop() {}
+void QueryServer::workerLoop(int) {}
+void QueryServer::serve(int, int) {}
+
+#else
+
+bool QueryServer::start(std::string& error) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) {
+        error = "Socket path must be 1-" + std::to_string(sizeof(address.sun_path) - 1) + " characters";
+        return false;
+    }
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    // A socket left behind by an earlier run is replaced; any other file is not ours to remove
+    struct stat existing;
+    if (lstat(socketPath.c_str(), &existing) == 0) {
+        if (!S_ISSOCK(existing.st_mode)) {
+            error = "'" + socketPath + "' exists and is not a socket";
+            return false;
+        }
+        unlink(socketPath.c_str());
+    }
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        error = std::string("socket: ") + std::strerror(errno);
+        return false;
+    }
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listenFd, 64) != 0) {
+        error = "Cannot listen on '" + socketPath + "': " + std::strerror(errno);
+        close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+
+    for (int i = 0; i < workerCount; ++i) arenas.push_back(std::make_unique<SolveArena>());
+    for (int i = 0; i < workerCount; ++i) workers.emplace_back(&QueryServer::workerLoop, this, i);
+    acceptor = std::thread(&QueryServer::acceptLoop, this);
+    return true;
+}
+
+void QueryServer::stop() {
+    std::lock_guard<std::mutex> lock(queueLock);
+    if (stopping.exchange(true)) return;
+    // Wakes accept() and every blocked recv(); the fds are closed by their owners
+    if (listenFd >= 0) shutdown(listenFd, SHUT_RDWR);
+    for (int fd : active) shutdown(fd, SHUT_RDWR);
+    queueReady.notify_all();
+}
+
+void QueryServer::wait() {
+    {
+        std::unique_lock<std::mutex> lock(queueLock);
+        if (joined || listenFd < 0) return;
+        queueReady.wait(lock, [this] { return stopping.load(); });
+        joined = true;
+    }
+    acceptor.join();
+    for (std::thread& worker : workers) worker.join();
+    for (int fd : pending) close(fd);
+    pending.clear();
+    close(listenFd);
+    listenFd = -1;
+    unlink(socketPath.c_str());
+}
+
+void QueryServer::acceptLoop() {
+    PROFILE_THREAD("query server accept");
+    while (!stopping.load()) {
+        int fd = accept(listenFd, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            break;      // Shut down by stop()
+        }
+        std::lock_guard<std::mutex> lock(queueLock);
+        if (stopping.load()) {
+            close(fd);
+            break;
+        }
+        pending.push_back(fd);
+        queueReady.notify_all();
+    }
+}
+
+void QueryServer::workerLoop(int worker) {
+    PROFILE_THREAD("query server worker");
+    while (true) {
+        int fd;
+        {
+            std::unique_lock<std::mutex> lock(queueLock);
+            queueReady.wait(lock, [this] { return stopping.load() || !pending.empty(); });
+            if (stopping.load()) return;
+            fd = pending.front();
+            pending.pop_front();
+            active.insert(fd);
+        }
+        serve(fd, worker);
+        {
+            std::lock_guard<std::mutex> lock(queueLock);
+            active.erase(fd);
+        }
+        close(fd);
+    }
+}
+
+void QueryServer::serve(int fd, int worker) {
+    // Bounds how long a silent reader or a stalled writer holds this worker
+    timeval idle{};
+    idle.tv_sec = IDLE_TIMEOUT_SECONDS;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &idle, sizeof(idle));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &idle, sizeof(idle));
+
+    std::string buffer;
+    char chunk[4096];
+    bool closing = false;
+    bool shutdownAfter = false;
+    while (!closing) {
+        size_t newline = buffer.find('\n');
+        if (newline == std::string::npos) {
+            if (buffer.size() > MAX_LINE) {
+                const char reply[] = "ERR line too long\n";
+                send(fd, reply, sizeof(reply) - 1, MSG_NOSIGNAL);
+                return;
+            }
+            ssize_t got = recv(fd, chunk, sizeof(chunk), 0);
+            if (got < 0 && errno == EINTR) continue;
+            if (got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                const char reply[] = "ERR idle timeout\n";
+                send(fd, reply, sizeof(reply) - 1, MSG_NOSIGNAL);
+                return;
+            }
+            if (got <= 0) return;
+            buffer.append(chunk, static_cast<size_t>(got));
+            continue;
+        }
+
+        std::string line = buffer.substr(0, newline);
+        buffer.erase(0, newline + 1);
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        std::string reply = handle(line, worker, closing, shutdownAfter) + "\n";
+
+        bool delivered = true;
+        for (size_t sent = 0; sent < reply.size();) {
+            ssize_t n = send(fd, reply.data() + sent, reply.size() - sent, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) {
+                delivered = false;
+                break;
+            }
+            sent += static_cast<size_t>(n);
+        }
+        // After the reply: stop() shuts down this connection along with the others
+        if (shutdownAfter) stop();
+        if (!delivered) return;
+    }
+}
+
+#endif
+
+std::string QueryServer::handle(const std::string& line, int worker, bool& close, bool& shutdown) {
+    auto began = std::chrono::steady_clock::now();
+    std::vector<std::string> args = tokenize(line);
+    std::string verb = args.empty() ? "" : upper(args[0]);
+
+    Endpoint endpoint = Endpoint::Other;
+    std::string reply;
+    if (verb == "PING") {
+        endpoint = Endpoint::Ping;
+        reply = "OK pong";
+    } else if (verb == "GENERATE") {
+        endpoint = Endpoint::Generate;
+        reply = generate(args);
+    } else if (verb == "LOAD") {
+        endpoint = Endpoint::Load;
+        reply = load(args);
+    } else if (verb == "DROP") {
+        endpoint = Endpoint::Drop;
+        reply = drop(args);
+    } else if (verb == "LIST") {
+        endpoint = Endpoint::List;
+        reply = list();
+    } else if (verb == "SOLVE") {
+        endpoint = Endpoint::Solve;
+        reply = solve(args, worker);
+    } else if (verb == "STATS") {
+        endpoint = Endpoint::Stats;
+        reply = describeStats();
+    } else if (verb == "QUIT") {
+        close = true;
+        return "OK bye";
+    } else if (verb == "SHUTDOWN") {
+        close = true;
+        shutdown = true;
+        return "OK shutting down";
+    } else {
+        reply = args.empty() ? "ERR empty request" : "ERR unknown request '" + args[0] + "'";
+    }
+
+    long long nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - began).count();
+    record(endpoint, nanos, reply.compare(0, 3, "ERR") == 0);
+    return reply;
+}
+
+std::string QueryServer::generate(const std::vector<std::string>& args) {
+    PROFILE_ZONE("server", "generate");
+    int width = 0, height = 0;
+    if (args.size() < 4 || !parseInt(args[2], width) || !parseInt(args[3], height)) {
+        return "ERR usage: GENERATE <name> <width> <height> [seed=N] [braid=%] [rooms=N] [obstacles=%] [mode=4|8] [landmarks=K]";
+    }
+    if (width < 5 || height < 5 || width > 20001 || height > 20001) return "ERR width and height must be 5-20001";
+
+    std::map<std::string, int> options;
+    std::string error;
+    MovementMode mode;
+    if (!parseOptions(args, 4, options, error) || !parseMode(options, MovementMode::FourWay, mode, error)) {
+        return "ERR " + error;
+    }
+    GeneratorOptions opts;
+    opts.seed = static_cast<unsigned>(optionOr(options, "seed", 0));
+    opts.braidFraction = std::clamp(optionOr(options, "braid", 0), 0, 100) / 100.0;
+    opts.roomCount = optionOr(options, "rooms", 0);
+    if (opts.roomCount < 0 || opts.roomCount > MAX_ROOMS) return "ERR rooms must be 0-" + std::to_string(MAX_ROOMS);
+    opts.obstacleDensity = std::clamp(optionOr(options, "obstacles", 0), 0, 40) / 100.0;
+    error = admit(args[1], width, height);
+    if (!error.empty()) return "ERR " + error;
+
+    auto maze = std::make_unique<Maze>(width, height, opts);
+    maze->setMovementMode(mode);
+    std::ostringstream description;
+    description << "generated seed=" << maze->getSeed();
+    error = install(args[1], std::move(maze), optionOr(options, "landmarks", 0), description.str());
+    if (!error.empty()) return "ERR " + error;
+    return "OK " + args[1] + " " + description.str();
+}
+
+std::string QueryServer::load(const std::vector<std::string>& args) {
+    PROFILE_ZONE("server", "load");
+    if (args.size() < 3) return "ERR usage: LOAD <name> <path> [mode=4|8] [landmarks=K]";
+    std::map<std::string, int> options;
+    std::string error;
+    if (!parseOptions(args, 3, options, error)) return "ERR " + error;
+
+    const std::string& path = args[2];
+    std::unique_ptr<Maze> maze;
+    MovementMode fallback = MovementMode::FourWay;
+    if (endsWith(path, ".map")) {
+        maze = std::make_unique<Maze>(5, 5);
+        if (!MovingAI::loadMap(path, *maze, error)) return "ERR " + error;
+        fallback = MovementMode::EightWay;     // MovingAI optimal lengths are octile
+        error = admit(args[1], maze->getWidth(), maze->getHeight());
+    } else {
+        std::shared_ptr<MappedMaze> file = MappedMaze::open(path, error);
+        if (!file) return "ERR " + error;
+        // From the header, before the cells are allocated
+        error = admit(args[1], file->header().width, file->header().height);
+        if (error.empty()) maze = std::make_unique<Maze>(file);
+    }
+    if (!error.empty()) return "ERR " + error;
+    MovementMode mode;
+    if (!parseMode(options, fallback, mode, error)) return "ERR " + error;
+    maze->setMovementMode(mode);
+    error = install(args[1], std::move(maze), optionOr(options, "landmarks", 0), "loaded " + path);
+    if (!error.empty()) return "ERR " + error;
+    return "OK " + args[1] + " loaded";
+}
+
+std::string QueryServer::drop(const std::vector<std::string>& args) {
+    if (args.size() != 2) return "ERR usage: DROP <name>";
+    std::unique_lock<std::shared_mutex> lock(mazesLock);
+    // Workers mid-query hold their own reference; the replicas go when they finish
+    if (mazes.erase(args[1]) == 0) return "ERR unknown maze '" + args[1] + "'";
+    return "OK dropped " + args[1];
+}
+
+std::string QueryServer::list() const {
+    std::shared_lock<std::shared_mutex> lock(mazesLock);
+    std::ostringstream out;
+    out << "OK " << mazes.size();
+    for (const auto& [name, resident] : mazes) {
+        const Maze& maze = *resident->replicas.front();
+        out << "; " << name << " " << maze.getWidth() << "x" << maze.getHeight()
+            << " mode=" << (maze.getMovementMode() == MovementMode::EightWay ? 8 : 4)
+            << " landmarks=" << (maze.getLandmarks() ? maze.getLandmarks()->count() : 0)
+            << " " << resident->description;
+    }
+    return out.str();
+}
+
+std::string QueryServer::solve(const std::vector<std::string>& args, int worker) {
+    PROFILE_ZONE("server", "solve");
+    int sx, sy, gx, gy;
+    if (args.size() != 7 || !parseInt(args[3], sx) || !parseInt(args[4], sy) ||
+        !parseInt(args[5], gx) || !parseInt(args[6], gy)) {
+        return "ERR usage: SOLVE <name> <dijkstra|astar|bidirectional|jps> <sx> <sy> <gx> <gy>";
+    }
+    std::shared_ptr<Resident> resident = find(args[1]);
+    if (!resident) return "ERR unknown maze '" + args[1] + "'";
+
+    Maze& maze = *resident->replicas[worker];
+    if (sx < 0 || sy < 0 || gx < 0 || gy < 0 || sx >= maze.getWidth() || gx >= maze.getWidth() ||
+        sy >= maze.getHeight() || gy >= maze.getHeight()) {
+        return "ERR endpoint outside the " + std::to_string(maze.getWidth()) + "x" +
+               std::to_string(maze.getHeight()) + " maze";
+    }
+    if (!maze.isWalkable(sx, sy)) return "ERR start " + std::to_string(sx) + "," + std::to_string(sy) + " is a wall";
+    if (!maze.isWalkable(gx, gy)) return "ERR goal " + std::to_string(gx) + "," + std::to_string(gy) + " is a wall";
+    maze.setEndpoints(sx, sy, gx, gy);
+
+    SolveArena* arena = arenas[worker].get();
+    const std::string& algorithm = args[2];
+    AlgorithmResult result;
+    if (algorithm == "dijkstra") result = Dijkstra::solve(maze, nullptr, ResultDetail::Compact, arena);
+    else if (algorithm == "astar") result = AStar::solve(maze, nullptr, ResultDetail::Compact, arena);
+    else if (algorithm == "bidirectional") result = DoubleAStar::solve(maze, nullptr, ResultDetail::Compact, arena);
+    else if (algorithm == "jps") result = JumpPointSearch::solve(maze, nullptr, ResultDetail::Compact, arena);
+    else return "ERR unknown algorithm '" + algorithm + "' (dijkstra, astar, bidirectional, jps)";
+
+    std::ostringstream out;
+    if (!result.success) {
+        out << "OK found=0 nodes=" << result.metrics.nodesExplored << " us=" << result.metrics.timeTakenMs
+            << " reason=" << Utility::failureName(result.failure);
+        return out.str();
+    }
+    out << "OK found=1 cost=" << std::fixed << std::setprecision(4) << result.metrics.pathCost
+        << " length=" << result.metrics.pathLength
+        << " nodes=" << result.metrics.nodesExplored
+        << " us=" << result.metrics.timeTakenMs
+        << " moves=";
+    std::string moves(result.route.size() > 0 ? result.route.size() - 1 : 0, '0');
+    for (size_t i = 0; i < moves.size(); ++i) moves[i] = static_cast<char>('0' + result.route.move(i));
+    out << moves;
+    return out.str();
+}
+
+uint64_t QueryServer::replicaBytes(uint64_t width, uint64_t height) const {
+    return width * height * sizeof(Cell) * static_cast<uint64_t>(workerCount);
+}
+
+std::string QueryServer::fits(const std::string& name, uint64_t needed) const {
+    uint64_t used = reserved;
+    for (const auto& [resident, entry] : mazes) {
+        if (resident != name) used += entry->bytes;
+    }
+    if (used + needed <= memoryBudget) return "";
+    return "the maze needs " + std::to_string(needed >> 20) + " MB for " + std::to_string(workerCount) +
+           " workers; " + std::to_string((memoryBudget - std::min(used, memoryBudget)) >> 20) + " of the " +
+           std::to_string(memoryBudget >> 20) + " MB budget is free";
+}
+
+std::string QueryServer::admit(const std::string& name, uint64_t width, uint64_t height) const {
+    std::shared_lock<std::shared_mutex> lock(mazesLock);
+    return fits(name, replicaBytes(width, height));
+}
+
+std::string QueryServer::install(const std::string& name, std::unique_ptr<Maze> maze, int landmarks,
+                                 std::string description) {
+    auto resident = std::make_shared<Resident>();
+    resident->description = std::move(description);
+    resident->bytes = replicaBytes(maze->getWidth(), maze->getHeight());
+    {
+        // Another GENERATE/LOAD may have been admitted since: hold the room while copying
+        std::unique_lock<std::shared_mutex> lock(mazesLock);
+        std::string error = fits(name, resident->bytes);
+        if (!error.empty()) return error;
+        reserved += resident->bytes;
+    }
+
+    if (landmarks > 0) maze->setLandmarks(LandmarkTable::build(*maze, std::min(landmarks, 16)));
+    // Built before copying, so every replica starts with the index ready
+    maze->componentCount();
+    resident->replicas.reserve(workerCount);
+    for (int i = 1; i < workerCount; ++i) resident->replicas.push_back(std::make_unique<Maze>(*maze));
+    resident->replicas.insert(resident->replicas.begin(), std::move(maze));
+
+    std::unique_lock<std::shared_mutex> lock(mazesLock);
+    reserved -= resident->bytes;
+    mazes[name] = std::move(resident);
+    return "";
+}
+
+std::shared_ptr<QueryServer::Resident> QueryServer::find(const std::string& name) const {
+    std::shared_lock<std::shared_mutex> lock(mazesLock);
+    auto it = mazes.find(name);
+    return it == mazes.end() ? nullptr : it->second;
+}
+
+void QueryServer::record(Endpoint endpoint, long long nanos, bool failed) {
+    LatencyLog& log = latency[static_cast<size_t>(endpoint)];
+    std::lock_guard<std::mutex> lock(log.lock);
+    log.requests++;
+    if (failed) log.errors++;
+    if (log.samples.size() < LATENCY_SAMPLES) {
+        log.samples.push_back(nanos);
+    } else {
+        log.samples[log.next] = nanos;
+        log.next = (log.next + 1) % LATENCY_SAMPLES;
+    }
+}
+
+std::vector<QueryServer::EndpointStats> QueryServer::stats() const {
+    std::vector<EndpointStats> all;
+    for (size_t i = 0; i < static_cast<size_t>(Endpoint::Count); ++i) {
+        std::vector<long long> samples;
+        EndpointStats s;
+        s.endpoint = static_cast<Endpoint>(i);
+        {
+            std::lock_guard<std::mutex> lock(latency[i].lock);
+            s.requests = latency[i].requests;
+            s.errors = latency[i].errors;
+            samples = latency[i].samples;
+        }
+        if (samples.empty()) continue;
+        s.latency = Utility::summarizeTimes(samples);
+        std::sort(samples.begin(), samples.end());
+        s.p99 = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+        all.push_back(s);
+    }
+    return all;
+}
+
+std::string QueryServer::describeStats() const {
+    std::ostringstream out;
+    out << "OK" << std::fixed << std::setprecision(1);
+    const char* separator = " ";
+    for (const EndpointStats& s : stats()) {
+        out << separator << endpointName(s.endpoint) << " n=" << s.requests << " err=" << s.errors
+            << " mean_us=" << s.latency.averageTime / 1000.0
+            << " p50_us=" << s.latency.medianTime / 1000.0
+            << " p99_us=" << s.p99 / 1000.0
+            << " max_us=" << s.latency.worstTime / 1000.0;
+        separator = "; ";
+    }
+    return out.str();
+}
\ No newline at end of file
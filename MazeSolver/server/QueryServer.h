@@ -0,0 +1,143 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include "../core/Maze.h"
+#include "../core/SolveArena.h"
+#include "../core/Types.h"
+
+// Long-running path query service on a Unix domain socket. Mazes are generated or
+// loaded once, with their component index (and optionally ALT landmarks) built up front,
+// and stay resident until dropped, so a query costs one search instead of a process
+// start plus a regeneration.
+//
+// Protocol: one request per line, exactly one reply line per request, "OK ..." or "ERR <why>".
+//   PING
+//   GENERATE <name> <width> <height> [seed=N] [braid=%] [rooms=N] [obstacles=%] [mode=4|8] [landmarks=K]
+//   LOAD <name> <path> [mode=4|8] [landmarks=K]     .map is read as MovingAI, anything else as a maze file
+//   DROP <name>
+//   LIST
+//   SOLVE <name> <dijkstra|astar|bidirectional|jps> <sx> <sy> <gx> <gy>
+//       -> OK found=1 cost=C length=L nodes=N us=T moves=<one CompactPath move code per step>
+//       -> OK found=0 nodes=N us=T reason=<failure, to the end of the line>
+//       -> ERR when an endpoint is outside the maze or on a wall
+//   STATS          latency per endpoint, measured in the server from request to reply
+//   QUIT           closes this connection
+//   SHUTDOWN       stops the server
+//
+// Each connection is served start to end by one worker of a fixed pool; clients beyond
+// the pool wait in the accept queue. A client that sends nothing (or reads no replies)
+// for IDLE_TIMEOUT_SECONDS is disconnected, so idle connections can't pin the pool. Searches keep their state in the Maze's cells, so
+// a resident maze has one replica per worker (walls, indices and landmarks are shared or
+// copied once at load), and each worker solves from its own SolveArena: workers never
+// share mutable search state and repeat queries make no heap allocations in the solver.
+// Replicas cost width * height * sizeof(Cell) bytes per worker, so GENERATE and LOAD are
+// refused with ERR when the resident mazes would outgrow the memory budget.
+class QueryServer {
+public:
+    static constexpr size_t MAX_LINE = 4096;
+    static constexpr int IDLE_TIMEOUT_SECONDS = 30;   // A silent client gives its worker back after this
+    static constexpr int MAX_ROOMS = 100000;
+    static constexpr size_t LATENCY_SAMPLES = 4096;   // Kept per endpoint; the oldest are overwritten
+    static constexpr size_t DEFAULT_MEMORY_BUDGET_MB = 4096;   // For the cells of every replica together
+
+    enum class Endpoint { Ping, Generate, Load, Drop, List, Solve, Stats, Other, Count };
+
+    struct EndpointStats {
+        Endpoint endpoint = Endpoint::Other;
+        size_t requests = 0;
+        size_t errors = 0;
+        RobustMetrics latency;      // Over the retained samples, in nanoseconds
+        long long p99 = 0;          // Nanoseconds
+    };
+
+    explicit QueryServer(const std::string& socketPath, int workers = 4,
+                         size_t memoryBudgetMB = DEFAULT_MEMORY_BUDGET_MB);
+    ~QueryServer();
+    QueryServer(const QueryServer&) = delete;
+    QueryServer& operator=(const QueryServer&) = delete;
+
+    // Binds the socket and starts the accept thread and the pool. Returns false and
+    // fills 'error' if it can't listen (path in use by a non-socket, too long, ...).
+    bool start(std::string& error);
+    // Blocks until a client sends SHUTDOWN or stop() is called, then joins every thread
+    void wait();
+    // Stops accepting and closes every open connection; safe from any thread
+    void stop();
+
+    std::vector<EndpointStats> stats() const;
+    static const char* endpointName(Endpoint endpoint);
+
+private:
+    struct Resident {
+        std::vector<std::unique_ptr<Maze>> replicas;   // One per worker
+        std::string description;
+        uint64_t bytes = 0;                             // Cells of all replicas
+    };
+
+    struct LatencyLog {
+        mutable std::mutex lock;
+        size_t requests = 0;
+        size_t errors = 0;
+        std::vector<long long> samples;     // Ring of LATENCY_SAMPLES
+        size_t next = 0;
+    };
+
+    std::string socketPath;
+    int workerCount;
+    uint64_t memoryBudget;                  // Bytes
+    int listenFd = -1;
+
+    std::thread acceptor;
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<SolveArena>> arenas;    // One per worker
+
+    std::mutex queueLock;
+    std::condition_variable queueReady;
+    std::deque<int> pending;                // Accepted, not yet picked up by a worker
+    std::unordered_set<int> active;         // Being served; shut down by stop()
+    std::atomic<bool> stopping{false};
+    bool joined = false;
+
+    mutable std::shared_mutex mazesLock;
+    std::map<std::string, std::shared_ptr<Resident>> mazes;
+    uint64_t reserved = 0;                  // Bytes held by installs still copying replicas
+
+    LatencyLog latency[static_cast<size_t>(Endpoint::Count)];
+
+    void acceptLoop();
+    void workerLoop(int worker);
+    void serve(int fd, int worker);
+
+    // Runs one request line; sets 'close' for QUIT and SHUTDOWN, and 'shutdown' for
+    // SHUTDOWN (the caller stops the server once the reply is sent)
+    std::string handle(const std::string& line, int worker, bool& close, bool& shutdown);
+    std::string generate(const std::vector<std::string>& args);
+    std::string load(const std::vector<std::string>& args);
+    std::string drop(const std::vector<std::string>& args);
+    std::string list() const;
+    std::string solve(const std::vector<std::string>& args, int worker);
+    std::string describeStats() const;
+
+    // What 'workerCount' replicas of a width x height maze cost in cells
+    uint64_t replicaBytes(uint64_t width, uint64_t height) const;
+    // Empty if a width x height maze fits the budget next to every resident maze but
+    // the one it would replace under 'name'; else why not. Checked before building
+    // anything, and again by install() under the lock.
+    std::string admit(const std::string& name, uint64_t width, uint64_t height) const;
+    std::string fits(const std::string& name, uint64_t needed) const;   // Caller holds mazesLock
+    // Builds the indices once, then copies the maze for every other worker. Returns the
+    // budget error when a concurrent GENERATE/LOAD took the room first.
+    std::string install(const std::string& name, std::unique_ptr<Maze> maze, int landmarks, std::string description);
+    std::shared_ptr<Resident> find(const std::string& name) const;
+    void record(Endpoint endpoint, long long nanos, bool failed);
+};
\ No newline at end of file
@@ -0,0 +1,94 @@
+// The C API as an embedding program sees it: statuses, buffer sizing and rejected queries.
+#include "TestCheck.h"
+#include "../api/mazecore.h"
+#include <cstring>
+#include <vector>
+
+namespace {
+    const mazecore_algorithm ALGORITHMS[] = {
+        MAZECORE_DIJKSTRA, MAZECORE_ASTAR, MAZECORE_BIDIRECTIONAL_ASTAR, MAZECORE_JUMP_POINT_SEARCH,
+    };
+
+    // 9x5 open field split by a wall at x = 4, except for a gap at (4, 2) when 'gap' is set
+    std::vector<uint8_t> splitField(bool gap) {
+        std::vector<uint8_t> walls(9 * 5, 0);
+        for (int y = 0; y < 5; ++y) walls[y * 9 + 4] = 1;
+        if (gap) walls[2 * 9 + 4] = 0;
+        return walls;
+    }
+}
+
+TEST_CASE(queriesAndStatuses) {
+    CHECK(mazecore_api_version() == MAZECORE_API_VERSION);
+    mazecore_maze* maze = nullptr;
+    std::vector<uint8_t> walls = splitField(true);
+    CHECK(mazecore_create_from_walls(9, 5, walls.data(), &maze) == MAZECORE_OK);
+    if (!maze) return;
+    CHECK(mazecore_width(maze) == 9 && mazecore_height(maze) == 5);
+    CHECK(mazecore_is_wall(maze, 4, 0) == 1 && mazecore_is_wall(maze, 4, 2) == 0 && mazecore_is_wall(maze, -1, 0) == 1);
+
+    for (mazecore_algorithm algorithm : ALGORITHMS) {
+        uint32_t path[64];
+        mazecore_result result;
+        CHECK_MSG(mazecore_query(maze, algorithm, 0, 0, 8, 4, path, 64, &result) == MAZECORE_OK, algorithm);
+        CHECK_MSG(result.path_length == 13 && result.cost == 12.0, algorithm << ": " << result.cost);
+        CHECK_MSG(path[0] == 0 && path[12] == 4 * 9 + 8, algorithm);
+
+        // Too small: the needed size comes back, nothing is written past the capacity
+        uint32_t small[4] = {7, 7, 7, 7};
+        CHECK(mazecore_query(maze, algorithm, 0, 0, 8, 4, small, 3, &result) == MAZECORE_BUFFER_TOO_SMALL);
+        CHECK(result.path_length == 13 && small[3] == 7);
+        CHECK(std::strlen(mazecore_last_error()) > 0);
+        CHECK(mazecore_query(maze, algorithm, 0, 0, 8, 4, nullptr, 0, &result) == MAZECORE_OK);
+        CHECK(result.path_length == 13);
+
+        // Endpoints on a wall or outside: rejected before any search
+        CHECK(mazecore_query(maze, algorithm, 4, 0, 8, 4, path, 64, &result) == MAZECORE_INVALID_ARGUMENT);
+        CHECK(mazecore_query(maze, algorithm, 0, 0, 4, 4, path, 64, &result) == MAZECORE_INVALID_ARGUMENT);
+        CHECK(mazecore_query(maze, algorithm, 0, 0, 9, 4, path, 64, &result) == MAZECORE_INVALID_ARGUMENT);
+        CHECK(result.path_length == 0);
+    }
+    CHECK(mazecore_query(maze, static_cast<mazecore_algorithm>(42), 0, 0, 8, 4, nullptr, 0, nullptr) ==
+          MAZECORE_INVALID_ARGUMENT);
+    CHECK(mazecore_set_movement(maze, MAZECORE_EIGHT_WAY) == MAZECORE_OK);
+    CHECK(mazecore_set_movement(maze, static_cast<mazecore_movement>(6)) == MAZECORE_INVALID_ARGUMENT);
+    mazecore_free(maze);
+
+    // No gap: both sides open, never connected
+    walls = splitField(false);
+    CHECK(mazecore_create_from_walls(9, 5, walls.data(), &maze) == MAZECORE_OK);
+    for (mazecore_algorithm algorithm : ALGORITHMS) {
+        mazecore_result result;
+        CHECK_MSG(mazecore_query(maze, algorithm, 0, 0, 8, 4, nullptr, 0, &result) == MAZECORE_NO_PATH, algorithm);
+        CHECK(result.path_length == 0);
+    }
+    mazecore_free(maze);
+    mazecore_free(nullptr);
+}
+
+TEST_CASE(invalidArguments) {
+    mazecore_maze* maze = reinterpret_cast<mazecore_maze*>(1);
+    CHECK(mazecore_create(3, 3, nullptr, &maze) == MAZECORE_INVALID_ARGUMENT);
+    CHECK(maze == nullptr);
+    CHECK(mazecore_create(11, 11, nullptr, nullptr) == MAZECORE_INVALID_ARGUMENT);
+    CHECK(mazecore_create_from_walls(0, 5, nullptr, &maze) == MAZECORE_INVALID_ARGUMENT);
+    CHECK(mazecore_load("/nonexistent/maze.mazebin", &maze) == MAZECORE_IO_ERROR);
+    CHECK(mazecore_query(nullptr, MAZECORE_ASTAR, 1, 1, 3, 3, nullptr, 0, nullptr) == MAZECORE_INVALID_ARGUMENT);
+    CHECK(mazecore_width(nullptr) == 0);
+
+    mazecore_generator_options options{};
+    options.seed = 11;
+    options.braid_percent = 40;
+    CHECK(mazecore_create(31, 21, &options, &maze) == MAZECORE_OK);
+    CHECK(mazecore_build_landmarks(maze, 0) == MAZECORE_INVALID_ARGUMENT);
+    CHECK(mazecore_build_landmarks(maze, 4) == MAZECORE_OK);
+    mazecore_result plain, withLandmarks;
+    CHECK(mazecore_query(maze, MAZECORE_DIJKSTRA, 1, 1, 29, 19, nullptr, 0, &plain) == MAZECORE_OK);
+    CHECK(mazecore_query(maze, MAZECORE_ASTAR, 1, 1, 29, 19, nullptr, 0, &withLandmarks) == MAZECORE_OK);
+    CHECK_NEAR(withLandmarks.cost, plain.cost, "landmarks");
+    mazecore_free(maze);
+}
+
+int main() {
+    return TestCheck::runAll();
+}
@@ -0,0 +1,60 @@
+// Cell storage orders: every cell gets its own slot, padding stays bounded, and a
+// layout only moves cells in memory, never changes a search result.
+#include "TestCheck.h"
+#include "TestMazes.h"
+#include "../core/CellLayout.h"
+#include "../algorithms/AStar.h"
+#include "../algorithms/Dijkstra.h"
+#include <vector>
+
+using namespace TestMazes;
+
+TEST_CASE(slotsAreDistinctAndInRange) {
+    const int shapes[][2] = {{5, 5}, {21, 9}, {64, 64}, {65, 33}, {130, 257}, {1025, 7}};
+    for (auto [w, h] : shapes) {
+        for (CellOrder order : {CellOrder::RowMajor, CellOrder::Tiled, CellOrder::Morton}) {
+            CellLayout layout(order, w, h);
+            std::vector<bool> used(layout.size(), false);
+            bool ok = true;
+            for (int y = 0; y < h && ok; ++y) {
+                for (int x = 0; x < w && ok; ++x) {
+                    size_t slot = layout.slot(x, y);
+                    ok = slot < used.size() && !used[slot];
+                    if (ok) used[slot] = true;
+                }
+            }
+            CHECK_MSG(ok, CellLayout::name(order) << " " << w << "x" << h);
+        }
+    }
+}
+
+TEST_CASE(mortonPaddingIsBounded) {
+    // Just past a power of two: whole-grid Z-order would need 2048x2048 here
+    for (auto [w, h] : {std::pair<int, int>{1025, 1025}, {2001, 2001}, {1500, 300}, {4097, 64}}) {
+        CellLayout layout(CellOrder::Morton, w, h);
+        size_t cells = static_cast<size_t>(w) * h;
+        CHECK_MSG(layout.size() <= cells + cells / 8, w << "x" << h << " -> " << layout.size() << " slots");
+    }
+}
+
+TEST_CASE(layoutsSolveAlike) {
+    Maze maze = scenario(4);
+    maze.setEndpoints(1, 1, maze.getWidth() - 2, maze.getHeight() - 2);
+    for (MovementMode mode : {MovementMode::FourWay, MovementMode::EightWay}) {
+        maze.setMovementMode(mode);
+        maze.setCellOrder(CellOrder::RowMajor);
+        double expected = Dijkstra::solve(maze).metrics.pathCost;
+        for (CellOrder order : {CellOrder::Tiled, CellOrder::Morton}) {
+            maze.setCellOrder(order);
+            std::string context = describe(maze, CellLayout::name(order));
+            CHECK_NEAR(Dijkstra::solve(maze).metrics.pathCost, expected, context);
+            AlgorithmResult astar = AStar::solve(maze);
+            CHECK_NEAR(astar.metrics.pathCost, expected, context);
+            CHECK_MSG(validPath(maze, astar), context);
+        }
+    }
+}
+
+int main() {
+    return TestCheck::runAll();
+}
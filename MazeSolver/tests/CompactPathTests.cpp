@@ -0,0 +1,59 @@
+// CompactPath: the move-encoded route against the Cell* path it replaces.
+#include "TestCheck.h"
+#include "../core/CompactPath.h"
+#include "../core/Maze.h"
+#include "../core/Utility.h"
+#include "../algorithms/AStar.h"
+#include <cstdint>
+#include <vector>
+
+namespace {
+    Maze mixedMaze(unsigned seed, int width, int height) {
+        GeneratorOptions options;
+        options.seed = seed;
+        options.braidFraction = 0.4;
+        options.roomCount = 4;
+        options.obstacleDensity = 0.1;
+        return Maze(width, height, options);
+    }
+}
+
+TEST_CASE(compactPathRoundTrip) {
+    for (MovementMode mode : {MovementMode::FourWay, MovementMode::EightWay}) {
+        for (unsigned seed = 1; seed <= 10; ++seed) {
+            Maze maze = mixedMaze(seed, 31 + seed, 25 + 2 * seed);
+            maze.setMovementMode(mode);
+            AlgorithmResult full = AStar::solve(maze);
+            CHECK(full.success);
+            if (!full.success) continue;
+
+            CompactPath route = CompactPath::fromCells(full.path, maze);
+            CHECK(route.size() == full.path.size());
+            CHECK(route.cells(maze) == full.path);
+            CHECK_NEAR(route.cost(), Utility::pathCost(full.path), "seed " << seed);
+            CHECK(Utility::validatePath(maze, route));
+
+            std::vector<uint32_t> expected;
+            for (Cell* c : full.path) expected.push_back(static_cast<uint32_t>(c->y * maze.getWidth() + c->x));
+            CHECK(route.indices() == expected);
+            CHECK(route.startIndex() == expected.front());
+            CHECK(route.endIndex() == expected.back());
+
+            std::vector<uint32_t> backwards(expected.rbegin(), expected.rend());
+            CHECK(route.reversed().indices() == backwards);
+            CHECK(route.reversed().reversed().indices() == expected);
+
+            // Compact solves hand back the same route the full one reconstructs
+            AlgorithmResult compact = AStar::solve(maze, nullptr, ResultDetail::Compact);
+            CHECK(compact.path.empty());
+            CHECK(compact.route.indices() == expected);
+        }
+    }
+    CHECK(CompactPath().empty());
+    CHECK(CompactPath().size() == 0);
+    CHECK(CompactPath::fromCells({}, Maze(5, 5)).empty());
+}
+
+int main() {
+    return TestCheck::runAll();
+}
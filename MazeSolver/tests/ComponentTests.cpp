@@ -0,0 +1,179 @@
+// The component index: against a plain flood fill, under wall edits, and as the
+// early rejection every solver shares for unreachable goals and blocked endpoints.
+#include "TestCheck.h"
+#include "TestMazes.h"
+#include "../core/MazeFile.h"
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace TestMazes;
+
+namespace {
+    // Component label of every cell by breadth-first flood, -1 for walls
+    std::vector<int> floodLabels(Maze& maze, int& components) {
+        const int w = maze.getWidth(), h = maze.getHeight();
+        std::vector<int> label(static_cast<size_t>(w) * h, -1);
+        components = 0;
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                if (!maze.isWalkable(x, y) || label[y * w + x] != -1) continue;
+                std::deque<std::pair<int, int>> queue{{x, y}};
+                label[y * w + x] = components;
+                while (!queue.empty()) {
+                    auto [cx, cy] = queue.front();
+                    queue.pop_front();
+                    for (Cell* n : maze.getNeighbors(maze.getCellPtr(cx, cy))) {
+                        if (label[n->y * w + n->x] != -1) continue;
+                        label[n->y * w + n->x] = components;
+                        queue.emplace_back(n->x, n->y);
+                    }
+                }
+                components++;
+            }
+        }
+        return label;
+    }
+
+    void checkComponents(Maze& maze, const std::string& context) {
+        int components = 0;
+        std::vector<int> label = floodLabels(maze, components);
+        CHECK_MSG(maze.componentCount() == static_cast<size_t>(components), context);
+        std::mt19937 pick(7);
+        const int w = maze.getWidth(), h = maze.getHeight();
+        for (int i = 0; i < 400; ++i) {
+            int a = static_cast<int>(pick() % label.size()), b = static_cast<int>(pick() % label.size());
+            bool expected = label[a] != -1 && label[a] == label[b];
+            CHECK_MSG(maze.connected(a % w, a / w, b % w, b / w) == expected,
+                      context << " cells " << a << " and " << b);
+        }
+        CHECK(!maze.connected(-1, 0, 1, 1));
+        CHECK(!maze.connected(1, 1, w, h));
+    }
+}
+
+TEST_CASE(componentIndexMatchesFloodFill) {
+    for (unsigned seed = 1; seed <= 6; ++seed) {
+        // Imported walls with random noise: many small components
+        const int w = 40 + static_cast<int>(seed), h = 30;
+        std::mt19937 noise(seed);
+        std::vector<bool> walls(static_cast<size_t>(w) * h);
+        for (size_t i = 0; i < walls.size(); ++i) walls[i] = noise() % 100 < 45;
+        Maze maze(w, h, walls);
+        checkComponents(maze, "noise seed " + std::to_string(seed));
+
+        // Edits: opening merges in place, closing marks the index for a relabel
+        for (int i = 0; i < 60; ++i) {
+            int x = static_cast<int>(noise() % w), y = static_cast<int>(noise() % h);
+            CHECK(maze.setWall(x, y, maze.isWalkable(x, y)));     // Toggle
+            if (i % 10 == 9) checkComponents(maze, "after edits, seed " + std::to_string(seed));
+        }
+    }
+
+    // A perfect maze is one component; cutting a corridor cell splits it
+    GeneratorOptions options;
+    options.seed = 3;
+    Maze perfect(21, 21, options);
+    CHECK(perfect.componentCount() == 1);
+    CHECK(perfect.connected(1, 1, 19, 19));
+    AlgorithmResult route = Dijkstra::solve(perfect);
+    CHECK(route.success && route.path.size() > 2);
+    if (!route.success || route.path.size() <= 2) return;
+    Cell* cut = route.path[route.path.size() / 2];
+    CHECK(perfect.setWall(cut->x, cut->y, true));
+    CHECK(!perfect.connected(1, 1, 19, 19));
+    CHECK(perfect.setWall(cut->x, cut->y, false));
+    CHECK(perfect.connected(1, 1, 19, 19));
+    CHECK(perfect.componentCount() == 1);
+}
+
+TEST_CASE(closuresInOpenAreasKeepTheIndexExact) {
+    // Mostly open: most closures leave their component whole and skip the relabel,
+    // so the closed-over walls left in the forest get exercised by every later edit
+    for (unsigned seed = 1; seed <= 4; ++seed) {
+        const int w = 36, h = 28;
+        std::mt19937 noise(seed * 17);
+        std::vector<bool> walls(static_cast<size_t>(w) * h);
+        for (size_t i = 0; i < walls.size(); ++i) walls[i] = noise() % 100 < 15;
+        Maze maze(w, h, walls);
+        maze.componentCount();
+        for (int i = 0; i < 150; ++i) {
+            int x = static_cast<int>(noise() % w), y = static_cast<int>(noise() % h);
+            // Closing twice as often as opening, so regions do get cut off
+            CHECK(maze.setWall(x, y, noise() % 3 != 0));
+            if (i % 3 == 2) checkComponents(maze, "open area seed " + std::to_string(seed) + " edit " + std::to_string(i));
+        }
+    }
+}
+
+TEST_CASE(mappedMazeComponents) {
+    // A mapped maze builds its index from the file's bitmap on the first query
+    const std::string path = (std::filesystem::temp_directory_path() / "mazesolver_test_components.mazebin").string();
+    Maze original = scenario(7);
+    std::string error;
+    CHECK_MSG(MazeFile::save(original, path, error), error);
+    std::shared_ptr<MappedMaze> file = MappedMaze::open(path, error);
+    CHECK_MSG(file != nullptr, error);
+    if (!file) return;
+    Maze loaded(file);
+    checkComponents(loaded, "mapped");
+    CHECK(loaded.componentCount() == original.componentCount());
+    std::remove(path.c_str());
+}
+
+TEST_CASE(unreachableGoalIsReported) {
+    for (MovementMode mode : {MovementMode::FourWay, MovementMode::EightWay}) {
+        Maze maze = scenario(1);
+        maze.setMovementMode(mode);
+        const int gx = maze.getWidth() - 2, gy = maze.getHeight() - 2;
+        maze.setEndpoints(1, 1, gx, gy);
+
+        // Seal the goal in: it stays open, its neighbourhood does not
+        std::vector<std::pair<int, int>> sealed = openAround(maze, gx, gy);
+        for (auto [x, y] : sealed) CHECK(maze.setWall(x, y, true));
+        CHECK(!maze.connected(1, 1, gx, gy));
+
+        for (const auto& [name, solve] : allSolvers()) {
+            AlgorithmResult result = solve(maze);
+            CHECK_MSG(!result.success, describe(maze, name));
+            CHECK_MSG(result.failure == FailureReason::Unreachable, describe(maze, name) << " gave "
+                      << Utility::failureName(result.failure));
+            CHECK_MSG(result.path.empty() && result.route.empty(), describe(maze, name));
+        }
+
+        // Opening the way again merges the components back
+        for (auto [x, y] : sealed) CHECK(maze.setWall(x, y, false));
+        CHECK(maze.connected(1, 1, gx, gy));
+        for (const auto& [name, solve] : allSolvers()) CHECK_MSG(solve(maze).success, describe(maze, name));
+    }
+}
+
+TEST_CASE(wallAndOutsideEndpointsAreRejected) {
+    for (MovementMode mode : {MovementMode::FourWay, MovementMode::EightWay}) {
+        Maze maze = scenario(0);
+        maze.setMovementMode(mode);
+        const int w = maze.getWidth(), h = maze.getHeight();
+        // Walled-in corner start, border goal, wall beside an open start, and off the grid
+        const int cases[][4] = {
+            {0, 0, w - 2, h - 2}, {1, 1, w - 1, h - 2}, {0, 1, w - 2, h - 2}, {1, 1, 2 * w, 1}, {-1, 1, 1, 1},
+        };
+        for (const auto& c : cases) {
+            maze.setEndpoints(c[0], c[1], c[2], c[3]);
+            std::string where = " (" + std::to_string(c[0]) + "," + std::to_string(c[1]) + ") -> (" +
+                                std::to_string(c[2]) + "," + std::to_string(c[3]) + ")";
+            for (const auto& [name, solve] : allSolvers()) {
+                AlgorithmResult result = solve(maze);
+                CHECK_MSG(!result.success, describe(maze, name) << where);
+                CHECK_MSG(result.failure == FailureReason::MissingEndpoints, describe(maze, name) << where
+                          << " gave " << Utility::failureName(result.failure));
+            }
+        }
+    }
+}
+
+int main() {
+    return TestCheck::runAll();
+}
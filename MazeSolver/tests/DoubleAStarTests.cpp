@@ -0,0 +1,100 @@
+// Bidirectional A*: optimal on every kind of maze, and a clean NoPath when the two
+// searches can never meet.
+#include "TestCheck.h"
+#include "TestMazes.h"
+#include "../core/Landmarks.h"
+#include "../algorithms/Dijkstra.h"
+#include "../algorithms/DoubleAStar.h"
+#include <random>
+
+using namespace TestMazes;
+
+TEST_CASE(optimalOnEveryMaze) {
+    std::mt19937 pick(37);
+    for (int i = 0; i < 48; ++i) {
+        Maze maze = scenario(i);
+        maze.setMovementMode(i % 2 ? MovementMode::EightWay : MovementMode::FourWay);
+        if (i % 6 == 5) maze.setLandmarks(LandmarkTable::build(maze, 4));
+        std::vector<std::pair<int, int>> open = openCells(maze);
+
+        for (int q = 0; q < 3; ++q) {
+            auto [sx, sy] = open[pick() % open.size()];
+            auto [gx, gy] = open[pick() % open.size()];
+            maze.setEndpoints(sx, sy, gx, gy);
+            double expected = Dijkstra::solve(maze).metrics.pathCost;
+            for (ResultDetail detail : {ResultDetail::Full, ResultDetail::Compact}) {
+                AlgorithmResult result = DoubleAStar::solve(maze, nullptr, detail);
+                std::string context = describe(maze, detail == ResultDetail::Full ? "full" : "compact");
+                CHECK_MSG(result.success, context);
+                if (!result.success) continue;
+                CHECK_NEAR(result.metrics.pathCost, expected, context);
+                CHECK_MSG(validPath(maze, result), context);
+            }
+        }
+    }
+}
+
+TEST_CASE(startEqualsGoal) {
+    for (MovementMode mode : {MovementMode::FourWay, MovementMode::EightWay}) {
+        Maze maze = scenario(1);
+        maze.setMovementMode(mode);
+        maze.setEndpoints(1, 1, 1, 1);
+        AlgorithmResult result = DoubleAStar::solve(maze);
+        CHECK(result.success && result.metrics.pathLength == 1);
+        CHECK_NEAR(result.metrics.pathCost, 0.0, describe(maze, "start == goal"));
+    }
+}
+
+TEST_CASE(sealedGoalIsUnreachable) {
+    for (MovementMode mode : {MovementMode::FourWay, MovementMode::EightWay}) {
+        Maze maze = scenario(1);
+        maze.setMovementMode(mode);
+        const int gx = maze.getWidth() - 2, gy = maze.getHeight() - 2;
+        maze.setEndpoints(1, 1, gx, gy);
+        for (auto [x, y] : openAround(maze, gx, gy)) maze.setWall(x, y, true);
+        for (ResultDetail detail : {ResultDetail::Full, ResultDetail::Compact}) {
+            AlgorithmResult result = DoubleAStar::solve(maze, nullptr, detail);
+            CHECK_MSG(!result.success && result.failure == FailureReason::Unreachable,
+                      describe(maze, "sealed") << " gave " << Utility::failureName(result.failure));
+            CHECK(result.path.empty() && result.route.empty());
+        }
+    }
+}
+
+TEST_CASE(searchesThatNeverMeetEndWithNoPath) {
+    // The component check passes at setup; the walls close before the first step, so
+    // one side's open list empties without the two ever meeting
+    for (MovementMode mode : {MovementMode::FourWay, MovementMode::EightWay}) {
+        for (bool sealGoal : {true, false}) {
+            Maze maze = scenario(2);
+            maze.setMovementMode(mode);
+            const int gx = maze.getWidth() - 2, gy = maze.getHeight() - 2;
+            maze.setEndpoints(1, 1, gx, gy);
+            DoubleAStar::Stepper stepper(maze);
+            CHECK(!stepper.done());
+            int cx = sealGoal ? gx : 1, cy = sealGoal ? gy : 1;
+            for (auto [x, y] : openAround(maze, cx, cy)) maze.setWall(x, y, true);
+            while (!stepper.done()) stepper.step(64);
+            std::string context = describe(maze, sealGoal ? "goal sealed mid-search" : "start sealed mid-search");
+            CHECK_MSG(stepper.status() == SearchStepper::Status::NoPath, context);
+            CHECK_MSG(!stepper.result().success && stepper.result().failure == FailureReason::Exhausted, context);
+            CHECK_MSG(stepper.result().path.empty(), context);
+        }
+    }
+}
+
+TEST_CASE(wallEndpointsAreRejected) {
+    Maze maze = scenario(0);
+    const int w = maze.getWidth(), h = maze.getHeight();
+    const int cases[][4] = {{0, 0, w - 2, h - 2}, {1, 1, w - 1, h - 2}, {1, 1, 2 * w, 1}, {-1, 1, 1, 1}};
+    for (const auto& c : cases) {
+        maze.setEndpoints(c[0], c[1], c[2], c[3]);
+        AlgorithmResult result = DoubleAStar::solve(maze);
+        CHECK_MSG(!result.success && result.failure == FailureReason::MissingEndpoints,
+                  c[0] << "," << c[1] << " -> " << c[2] << "," << c[3]);
+    }
+}
+
+int main() {
+    return TestCheck::runAll();
+}
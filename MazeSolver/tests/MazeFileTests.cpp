@@ -0,0 +1,144 @@
+// The .mazebin format: a save/map round trip, and every kind of bad file refused at open.
+#include "TestCheck.h"
+#include "../core/Maze.h"
+#include "../core/MazeFile.h"
+#include "../algorithms/AStar.h"
+#include "../algorithms/Dijkstra.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+    std::string tempPath(const std::string& name) {
+        return (std::filesystem::temp_directory_path() / ("mazesolver_test_" + name)).string();
+    }
+
+    std::vector<char> readBytes(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    void writeBytes(const std::string& path, const std::vector<char>& bytes, size_t count) {
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(bytes.data(), count);
+    }
+
+    Maze sampleMaze() {
+        GeneratorOptions options;
+        options.seed = 99;
+        options.braidFraction = 0.4;
+        options.roomCount = 4;
+        options.obstacleDensity = 0.1;
+        Maze maze(67, 45, options);
+        maze.setEndpoints(1, 1, 65, 43);
+        return maze;
+    }
+}
+
+TEST_CASE(saveAndMapRoundTrip) {
+    const std::string path = tempPath("roundtrip.mazebin");
+    Maze original = sampleMaze();
+    std::string error;
+    CHECK_MSG(MazeFile::save(original, path, error), error);
+
+    std::shared_ptr<MappedMaze> file = MappedMaze::open(path, error);
+    CHECK_MSG(file != nullptr, error);
+    if (!file) return;
+    CHECK(file->verifyChecksum());
+    CHECK(file->fileSize() == sizeof(MazeFileHeader) + original.packWalls().size() * sizeof(uint64_t));
+    Maze loaded(file);
+    CHECK(loaded.isMapped());
+    CHECK(loaded.getWidth() == original.getWidth() && loaded.getHeight() == original.getHeight());
+    CHECK(loaded.getSeed() == original.getSeed());
+    CHECK(loaded.packWalls() == original.packWalls());
+    CHECK(loaded.getStart()->x == 1 && loaded.getGoal()->x == 65 && loaded.getGoal()->y == 43);
+    for (int y = -1; y <= original.getHeight(); ++y)
+        for (int x = -1; x <= original.getWidth(); ++x)
+            CHECK_MSG(loaded.isWalkable(x, y) == original.isWalkable(x, y), x << "," << y);
+    // Read-only: edits are refused rather than written through the mapping
+    CHECK(!loaded.setWall(1, 1, true));
+
+    for (MovementMode mode : {MovementMode::FourWay, MovementMode::EightWay}) {
+        original.setMovementMode(mode);
+        loaded.setMovementMode(mode);
+        double expected = Dijkstra::solve(original).metrics.pathCost;
+        CHECK_NEAR(Dijkstra::solve(loaded).metrics.pathCost, expected, "mapped Dijkstra");
+        CHECK_NEAR(AStar::solve(loaded).metrics.pathCost, expected, "mapped A*");
+    }
+    std::remove(path.c_str());
+}
+
+TEST_CASE(badFilesAreRefused) {
+    const std::string path = tempPath("corrupt.mazebin");
+    Maze original = sampleMaze();
+    std::string error;
+    CHECK_MSG(MazeFile::save(original, path, error), error);
+    const std::vector<char> bytes = readBytes(path);
+    CHECK(bytes.size() > sizeof(MazeFileHeader));
+    if (bytes.size() <= sizeof(MazeFileHeader)) return;
+
+    // A flipped wall bit still opens (only the header is checked) but fails the checksum
+    std::vector<char> flipped = bytes;
+    flipped[sizeof(MazeFileHeader) + 8] ^= 1;
+    writeBytes(path, flipped, flipped.size());
+    std::shared_ptr<MappedMaze> file = MappedMaze::open(path, error);
+    CHECK(file != nullptr);
+    if (file) CHECK(!file->verifyChecksum());
+    file.reset();
+
+    // Header edits that must each fail at open
+    const std::pair<const char*, std::function<void(MazeFileHeader&)>> corruptions[] = {
+        {"magic", [](MazeFileHeader& h) { h.magic[0] = 'X'; }},
+        {"version", [](MazeFileHeader& h) { h.version = MazeFile::VERSION + 1; }},
+        {"zero width", [](MazeFileHeader& h) { h.width = 0; }},
+        {"zero height", [](MazeFileHeader& h) { h.height = 0; }},
+        {"row words", [](MazeFileHeader& h) { h.wordsPerRow++; }},
+        {"start outside", [](MazeFileHeader& h) { h.startX = h.width; }},
+        {"goal outside", [](MazeFileHeader& h) { h.goalY = h.height + 5; }},
+        {"header size", [](MazeFileHeader& h) { h.headerSize = sizeof(MazeFileHeader) + 4; }},
+        {"height past the bitmap", [](MazeFileHeader& h) { h.height *= 2; }},
+        {"width past INT_MAX", [](MazeFileHeader& h) {
+            h.width = 0x80000000u;
+            h.wordsPerRow = WallGrid::wordsForWidth(h.width);
+        }},
+    };
+    for (const auto& [name, corrupt] : corruptions) {
+        std::vector<char> edited = bytes;
+        MazeFileHeader header;
+        std::memcpy(&header, edited.data(), sizeof(header));
+        corrupt(header);
+        std::memcpy(edited.data(), &header, sizeof(header));
+        writeBytes(path, edited, edited.size());
+        error.clear();
+        CHECK_MSG(MappedMaze::open(path, error) == nullptr, name);
+        CHECK_MSG(!error.empty(), name);
+    }
+
+    // Cut off inside the bitmap, and inside the header
+    for (size_t length : {bytes.size() / 2, sizeof(MazeFileHeader) - 1, size_t(0)}) {
+        writeBytes(path, bytes, length);
+        error.clear();
+        CHECK_MSG(MappedMaze::open(path, error) == nullptr, length << " bytes");
+        CHECK_MSG(!error.empty(), length << " bytes");
+    }
+    std::remove(path.c_str());
+    CHECK(MappedMaze::open(path, error) == nullptr);
+}
+
+TEST_CASE(saveNeedsEndpoints) {
+    const std::string path = tempPath("noendpoints.mazebin");
+    Maze maze = sampleMaze();
+    maze.setEndpoints(1, 1, 500, 500);     // Goal off the maze: getGoal() is null
+    std::string error;
+    CHECK(!MazeFile::save(maze, path, error));
+    CHECK_MSG(error == "Maze has no start or goal", error);
+    CHECK(!std::filesystem::exists(path));
+}
+
+int main() {
+    return TestCheck::runAll();
+}
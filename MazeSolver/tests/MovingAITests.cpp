@@ -0,0 +1,143 @@
+// MovingAI .map/.scen loading and the scenario runner's per-bucket counts.
+#include "TestCheck.h"
+#include "../core/MovingAI.h"
+#include "../algorithms/AStar.h"
+#include "../algorithms/Dijkstra.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+    std::string tempPath(const std::string& name) {
+        return (std::filesystem::temp_directory_path() / ("mazesolver_test_" + name)).string();
+    }
+
+    void writeText(const std::string& path, const std::string& text) {
+        std::ofstream(path, std::ios::trunc) << text;
+    }
+
+    // 6x4, with '@' and 'T' blocked and 'S'/'G' passable
+    const char* const MAP =
+        "type octile\n"
+        "height 4\n"
+        "width 6\n"
+        "map\n"
+        "......\n"
+        "..@@..\n"
+        "S.@..G\n"
+        ".T....\n";
+}
+
+TEST_CASE(loadMap) {
+    const std::string path = tempPath("small.map");
+    writeText(path, MAP);
+    Maze maze;
+    std::string error;
+    CHECK_MSG(MovingAI::loadMap(path, maze, error), error);
+    CHECK(maze.getWidth() == 6 && maze.getHeight() == 4);
+    CHECK(maze.isImported());
+    CHECK(maze.getMovementMode() == MovementMode::EightWay);
+    CHECK(maze.isWalkable(0, 0) && maze.isWalkable(0, 2) && maze.isWalkable(5, 2));
+    CHECK(!maze.isWalkable(2, 1) && !maze.isWalkable(3, 1) && !maze.isWalkable(1, 3));
+    CHECK(!maze.isWalkable(6, 0) && !maze.isWalkable(0, -1));
+
+    // Bad headers and short maps are refused with a reason
+    const char* const broken[] = {
+        "type octile\nheight 4\nwidth 6\n......\n",                      // No 'map' line
+        "type octile\nheight 4\ncolour red\nwidth 6\nmap\n",             // Unknown key
+        "type octile\nheight 4\nwidth 6\nmap\n......\n......\n",         // Two rows of four
+        "type octile\nheight 2\nwidth 6\nmap\n......\n....\n",           // Short row
+        "type octile\nheight 0\nwidth 6\nmap\n",
+    };
+    for (const char* text : broken) {
+        writeText(path, text);
+        error.clear();
+        CHECK_MSG(!MovingAI::loadMap(path, maze, error) && !error.empty(), text);
+    }
+    std::remove(path.c_str());
+    CHECK(!MovingAI::loadMap(path, maze, error));
+}
+
+TEST_CASE(loadScenario) {
+    const std::string path = tempPath("small.map.scen");
+    writeText(path, "version 1\n"
+                    "0\tsmall.map\t6\t4\t0\t0\t5\t0\t5.00000000\n"
+                    "\n"
+                    "3\tmaps/small.map\t6\t4\t4\t1\t5\t3\t2.41421356\n");
+    std::vector<MovingAI::Query> queries;
+    std::string error;
+    CHECK_MSG(MovingAI::loadScenario(path, queries, error), error);
+    CHECK(queries.size() == 2);
+    if (queries.size() == 2) {
+        CHECK(queries[0].bucket == 0 && queries[0].map == "small.map" && queries[0].mapWidth == 6);
+        CHECK(queries[1].bucket == 3 && queries[1].startX == 4 && queries[1].goalY == 3);
+        CHECK_NEAR(queries[1].optimalLength, 2.41421356, "optimal length");
+    }
+
+    writeText(path, "0\tsmall.map\t6\t4\t0\t0\t5\t0\t5.0\n");
+    CHECK(!MovingAI::loadScenario(path, queries, error));
+    writeText(path, "version 1\n0\tsmall.map\t6\t4\t0\t0\t5\n");
+    error.clear();
+    CHECK(!MovingAI::loadScenario(path, queries, error));
+    CHECK_MSG(error.find("line 2") != std::string::npos, error);
+
+    // Map names resolve next to the scenario first, directory prefix or not
+    const std::string mapPath = tempPath("small.map");
+    writeText(mapPath, MAP);
+    const std::string mapName = std::filesystem::path(mapPath).filename().string();
+    CHECK(MovingAI::resolveMapPath(path, "maps/" + mapName) == mapPath);
+    CHECK(MovingAI::resolveMapPath(path, mapName) == mapPath);
+    CHECK(MovingAI::resolveMapPath(path, "nosuch.map") == "nosuch.map");
+    std::remove(mapPath.c_str());
+    std::remove(path.c_str());
+}
+
+TEST_CASE(runQueriesCountsPerBucket) {
+    const std::string path = tempPath("run.map");
+    writeText(path, MAP);
+    Maze maze;
+    std::string error;
+    CHECK_MSG(MovingAI::loadMap(path, maze, error), error);
+    std::remove(path.c_str());
+
+    auto query = [](int bucket, int w, int h, int sx, int sy, int gx, int gy, double optimal) {
+        MovingAI::Query q;
+        q.bucket = bucket;
+        q.map = "run.map";
+        q.mapWidth = w;
+        q.mapHeight = h;
+        q.startX = sx;
+        q.startY = sy;
+        q.goalX = gx;
+        q.goalY = gy;
+        q.optimalLength = optimal;
+        return q;
+    };
+    const std::vector<MovingAI::Query> queries = {
+        query(0, 6, 4, 0, 0, 5, 0, 5.0),
+        query(0, 6, 4, 4, 1, 5, 3, 2.41421356),
+        query(0, 6, 4, 0, 0, 1, 0, 7.0),          // Solved, but not to the stated optimum
+        query(1, 7, 4, 0, 0, 5, 0, 5.0),          // Another map's size
+        query(1, 6, 4, 2, 1, 5, 0, 4.0),          // Start on '@'
+        query(1, 6, 4, 0, 0, 6, 0, 6.0),          // Goal off the map
+    };
+    CHECK(MovingAI::checkQuery(maze, queries[0]).empty());
+    for (size_t i = 3; i < queries.size(); ++i) CHECK_MSG(!MovingAI::checkQuery(maze, queries[i]).empty(), i);
+
+    for (auto algorithm : {&AStar::solve, &Dijkstra::solve}) {
+        auto solve = [algorithm](Maze& m) { return algorithm(m, nullptr, ResultDetail::Compact, nullptr); };
+        std::vector<MovingAI::BucketStats> stats = MovingAI::runQueries(maze, queries, solve);
+        CHECK(stats.size() == 2);
+        if (stats.size() != 2) continue;
+        CHECK(stats[0].bucket == 0 && stats[0].queries == 3 && stats[0].solved == 3);
+        CHECK(stats[0].optimal == 2 && stats[0].skipped == 0);
+        CHECK_NEAR(stats[0].total.pathCost, 5.0 + 2.41421356 + 1.0, "bucket 0 cost");
+        CHECK(stats[1].bucket == 1 && stats[1].queries == 3 && stats[1].skipped == 3 && stats[1].solved == 0);
+    }
+}
+
+int main() {
+    return TestCheck::runAll();
+}
@@ -0,0 +1,87 @@
+// Bidirectional A* on two threads: the same optimal costs as the serial search,
+// run after run, and the same clean failures.
+#include "TestCheck.h"
+#include "TestMazes.h"
+#include "../core/Landmarks.h"
+#include "../core/SolveArena.h"
+#include "../algorithms/Dijkstra.h"
+#include "../algorithms/DoubleAStar.h"
+#include <random>
+
+using namespace TestMazes;
+
+TEST_CASE(optimalOnEveryMaze) {
+    std::mt19937 pick(38);
+    for (int i = 0; i < 48; ++i) {
+        Maze maze = scenario(i);
+        maze.setMovementMode(i % 2 ? MovementMode::EightWay : MovementMode::FourWay);
+        if (i % 6 == 5) maze.setLandmarks(LandmarkTable::build(maze, 4));
+        std::vector<std::pair<int, int>> open = openCells(maze);
+
+        for (int q = 0; q < 3; ++q) {
+            auto [sx, sy] = open[pick() % open.size()];
+            auto [gx, gy] = open[pick() % open.size()];
+            maze.setEndpoints(sx, sy, gx, gy);
+            double expected = Dijkstra::solve(maze).metrics.pathCost;
+            // The two threads interleave differently every run; the cost must not
+            for (int run = 0; run < 4; ++run) {
+                ResultDetail detail = run % 2 ? ResultDetail::Compact : ResultDetail::Full;
+                AlgorithmResult result = DoubleAStar::solveParallel(maze, detail);
+                std::string context = describe(maze, "run " + std::to_string(run));
+                CHECK_MSG(result.success, context);
+                if (!result.success) continue;
+                CHECK_NEAR(result.metrics.pathCost, expected, context);
+                CHECK_MSG(validPath(maze, result), context);
+            }
+        }
+    }
+}
+
+TEST_CASE(startEqualsGoal) {
+    Maze maze = scenario(3);
+    maze.setEndpoints(1, 1, 1, 1);
+    AlgorithmResult result = DoubleAStar::solveParallel(maze);
+    CHECK(result.success && result.metrics.pathLength == 1);
+    CHECK_NEAR(result.metrics.pathCost, 0.0, "start == goal");
+}
+
+TEST_CASE(failuresAreReported) {
+    for (MovementMode mode : {MovementMode::FourWay, MovementMode::EightWay}) {
+        Maze maze = scenario(1);
+        maze.setMovementMode(mode);
+        const int gx = maze.getWidth() - 2, gy = maze.getHeight() - 2;
+
+        maze.setEndpoints(0, 0, gx, gy);
+        AlgorithmResult wall = DoubleAStar::solveParallel(maze);
+        CHECK_MSG(!wall.success && wall.failure == FailureReason::MissingEndpoints, describe(maze, "wall start"));
+        CHECK(wall.metrics.timeTakenMs > 0);
+        maze.setEndpoints(1, 1, gx, 2 * gy);
+        AlgorithmResult outside = DoubleAStar::solveParallel(maze);
+        CHECK_MSG(!outside.success && outside.failure == FailureReason::MissingEndpoints, describe(maze, "outside"));
+
+        maze.setEndpoints(1, 1, gx, gy);
+        for (auto [x, y] : openAround(maze, gx, gy)) maze.setWall(x, y, true);
+        AlgorithmResult sealed = DoubleAStar::solveParallel(maze, ResultDetail::Compact);
+        CHECK_MSG(!sealed.success && sealed.failure == FailureReason::Unreachable, describe(maze, "sealed"));
+        CHECK(sealed.path.empty() && sealed.route.empty());
+        // Every early exit reports its time the same way
+        CHECK(sealed.metrics.timeTakenMs > 0);
+    }
+}
+
+TEST_CASE(sharedArenaIsReused) {
+    Maze maze = scenario(2);
+    maze.setEndpoints(1, 1, maze.getWidth() - 2, maze.getHeight() - 2);
+    SolveArena arena;
+    AlgorithmResult first = DoubleAStar::solveParallel(maze, ResultDetail::Compact, &arena);
+    CHECK(first.success);
+    // Same size again: the labels fit where the last run's were
+    AlgorithmResult again = DoubleAStar::solveParallel(maze, ResultDetail::Compact, &arena);
+    CHECK(again.success && again.metrics.heapAllocations == 0);
+    CHECK_NEAR(again.metrics.pathCost, first.metrics.pathCost, "reused arena");
+    CHECK(arena.bytesInUse() >= 2 * maze.slotCount() * sizeof(double));
+}
+
+int main() {
+    return TestCheck::runAll();
+}
@@ -0,0 +1,184 @@
+// The query server end to end over its socket: SOLVE answers against a local solve,
+// and every malformed or impossible request gets an ERR line instead of a dead server.
+#include "TestCheck.h"
+#include "../core/Maze.h"
+#include "../core/MazeFile.h"
+#include "../algorithms/Dijkstra.h"
+#include "../server/QueryServer.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+    std::string tempPath(const std::string& name) {
+        return (std::filesystem::temp_directory_path() /
+                ("mazesolver_test_" + std::to_string(getpid()) + "_" + name)).string();
+    }
+
+    // One connection, one request line at a time
+    class Client {
+    public:
+        explicit Client(const std::string& socketPath) {
+            fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            sockaddr_un address{};
+            address.sun_family = AF_UNIX;
+            std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+            if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+                close(fd);
+                fd = -1;
+            }
+        }
+        ~Client() { if (fd >= 0) close(fd); }
+
+        bool connected() const { return fd >= 0; }
+
+        // The reply line without its newline; "" if the connection closed
+        std::string ask(const std::string& request) {
+            std::string line = request + "\n";
+            if (send(fd, line.data(), line.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(line.size())) return "";
+            std::string reply;
+            char c;
+            while (recv(fd, &c, 1, 0) == 1) {
+                if (c == '\n') return reply;
+                reply += c;
+            }
+            return "";
+        }
+
+    private:
+        int fd = -1;
+    };
+
+    bool startsWith(const std::string& text, const std::string& prefix) {
+        return text.compare(0, prefix.size(), prefix) == 0;
+    }
+
+    double field(const std::string& reply, const std::string& key) {
+        size_t at = reply.find(" " + key + "=");
+        return at == std::string::npos ? -1.0 : std::atof(reply.c_str() + at + key.size() + 2);
+    }
+
+    const char* const ALGORITHMS[] = {"dijkstra", "astar", "bidirectional", "jps"};
+}
+
+TEST_CASE(solveRepliesAndErrors) {
+    const std::string socketPath = tempPath("server.sock");
+    QueryServer server(socketPath, 2);
+    std::string error;
+    CHECK_MSG(server.start(error), error);
+    if (!error.empty()) return;
+
+    Client client(socketPath);
+    CHECK(client.connected());
+    CHECK(client.ask("PING") == "OK pong");
+    CHECK(startsWith(client.ask("GENERATE m 41 41 seed=7 braid=30"), "OK m"));
+
+    // Same seed and options locally: the server must agree with Dijkstra here
+    GeneratorOptions options;
+    options.seed = 7;
+    options.braidFraction = 0.3;
+    Maze local(41, 41, options);
+    local.setEndpoints(1, 1, 39, 39);
+    double expected = Dijkstra::solve(local).metrics.pathCost;
+    for (const char* algorithm : ALGORITHMS) {
+        std::string reply = client.ask(std::string("SOLVE m ") + algorithm + " 1 1 39 39");
+        CHECK_MSG(startsWith(reply, "OK found=1"), algorithm << ": " << reply);
+        CHECK_NEAR(field(reply, "cost"), expected, algorithm);
+        // One move code per step
+        size_t moves = reply.find("moves=");
+        CHECK_MSG(moves != std::string::npos && reply.size() - moves - 6 == static_cast<size_t>(expected), reply);
+    }
+
+    // Requests that must fail without taking the server down
+    const char* const rejected[] = {
+        "SOLVE m bidirectional 0 0 39 39",     // Start on a wall
+        "SOLVE m astar 1 1 40 39",              // Goal on the border wall
+        "SOLVE m jps 1 1 41 39",                // Goal outside
+        "SOLVE m dijkstra -1 1 39 39",
+        "SOLVE m bfs 1 1 39 39",                // Unknown algorithm
+        "SOLVE nosuch astar 1 1 39 39",
+        "SOLVE m astar 1 1",
+        "SOLVE m astar one 1 39 39",
+        "GENERATE r 41 41 rooms=1000000",
+        "GENERATE r 3 41",
+        "GENERATE r 41 41 mode=6",
+        "GENERATE r 41 41 seed",
+        "LOAD r /nonexistent/maze.mazebin",
+        "DROP nosuch",
+        "FROBNICATE",
+        "",
+    };
+    for (const char* request : rejected) {
+        for (const char* attempt : {"first", "again"}) {
+            std::string reply = client.ask(request);
+            CHECK_MSG(startsWith(reply, "ERR"), attempt << " '" << request << "' -> '" << reply << "'");
+        }
+    }
+    CHECK(client.ask("PING") == "OK pong");
+
+    // Open endpoints in separate components: a search result, not an error
+    const std::string mazePath = tempPath("split.mazebin");
+    std::vector<bool> walls(11 * 7, false);
+    for (int y = 0; y < 7; ++y) walls[y * 11 + 5] = true;
+    Maze split(11, 7, walls);
+    CHECK_MSG(MazeFile::save(split, mazePath, error), error);
+    CHECK(startsWith(client.ask("LOAD s " + mazePath), "OK s"));
+    for (const char* algorithm : ALGORITHMS) {
+        std::string reply = client.ask(std::string("SOLVE s ") + algorithm + " 1 1 9 5");
+        CHECK_MSG(startsWith(reply, "OK found=0") && reply.find("reason=") != std::string::npos, algorithm << ": " << reply);
+        reply = client.ask(std::string("SOLVE s ") + algorithm + " 1 1 3 5");
+        CHECK_MSG(startsWith(reply, "OK found=1") && field(reply, "cost") == 6.0, algorithm << ": " << reply);
+    }
+    CHECK(startsWith(client.ask("DROP s"), "OK"));
+    CHECK(startsWith(client.ask("SOLVE s astar 1 1 3 5"), "ERR"));
+
+    // A second connection is served by the other worker's replica
+    Client other(socketPath);
+    CHECK(startsWith(other.ask("SOLVE m astar 1 1 39 39"), "OK found=1"));
+    CHECK(other.ask("QUIT") == "OK bye");
+
+    std::string stats = client.ask("STATS");
+    CHECK_MSG(startsWith(stats, "OK") && stats.find("SOLVE n=") != std::string::npos, stats);
+    CHECK(client.ask("SHUTDOWN") == "OK shutting down");
+    server.wait();
+    CHECK(!std::filesystem::exists(socketPath));
+    std::remove(mazePath.c_str());
+}
+
+TEST_CASE(memoryBudgetRefusesOversizedMazes) {
+    const std::string socketPath = tempPath("budget.sock");
+    // 1 MB for two workers: one 101x101 maze fits (2 replicas of 10201 cells), two don't
+    QueryServer server(socketPath, 2, 1);
+    std::string error;
+    CHECK_MSG(server.start(error), error);
+    if (!error.empty()) return;
+
+    Client client(socketPath);
+    CHECK(startsWith(client.ask("GENERATE a 101 101 seed=3"), "OK a"));
+    std::string reply = client.ask("GENERATE big 401 401");
+    CHECK_MSG(startsWith(reply, "ERR") && reply.find("budget") != std::string::npos, reply);
+    CHECK_MSG(startsWith(client.ask("GENERATE b 101 101"), "ERR"), "second maze over budget");
+    // Replacing a maze only needs room for the difference
+    CHECK(startsWith(client.ask("GENERATE a 101 101 seed=4"), "OK a"));
+
+    const std::string mazePath = tempPath("budget.mazebin");
+    Maze large(401, 401);
+    CHECK_MSG(MazeFile::save(large, mazePath, error), error);
+    CHECK(startsWith(client.ask("LOAD big " + mazePath), "ERR"));
+    CHECK(startsWith(client.ask("DROP a"), "OK"));
+    CHECK(startsWith(client.ask("GENERATE b 101 101"), "OK b"));
+    CHECK(startsWith(client.ask("SOLVE b astar 1 1 99 99"), "OK found=1"));
+    CHECK(client.ask("SHUTDOWN") == "OK shutting down");
+    server.wait();
+    std::remove(mazePath.c_str());
+}
+
+int main() {
+    return TestCheck::runAll();
+}
@@ -0,0 +1,103 @@
+// Dijkstra, A* and JPS agree on every path cost, at both result levels, 4- and 8-way,
+// and no 8-way search squeezes diagonally past a wall corner. Also checks the generator
+// places the obstacle density it was asked for.
+#include "TestCheck.h"
+#include "TestMazes.h"
+#include "../core/Landmarks.h"
+#include "../algorithms/AStar.h"
+#include "../algorithms/Dijkstra.h"
+#include "../algorithms/JumpPointSearch.h"
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace TestMazes;
+
+TEST_CASE(everySolverMatchesDijkstraCost) {
+    std::mt19937 pick(42);
+    for (int i = 0; i < 48; ++i) {
+        Maze maze = scenario(i);
+        maze.setMovementMode(i % 2 ? MovementMode::EightWay : MovementMode::FourWay);
+        if (i % 6 == 5) maze.setLandmarks(LandmarkTable::build(maze, 4));
+        std::vector<std::pair<int, int>> open = openCells(maze);
+
+        for (int q = 0; q < 3; ++q) {
+            auto [sx, sy] = open[pick() % open.size()];
+            auto [gx, gy] = open[pick() % open.size()];
+            maze.setEndpoints(sx, sy, gx, gy);
+            AlgorithmResult reference = Dijkstra::solve(maze);
+            CHECK_MSG(reference.success, describe(maze, "Dijkstra"));
+            if (!reference.success) continue;
+
+            for (const auto& [name, solve] : allSolvers()) {
+                AlgorithmResult result = solve(maze);
+                CHECK_MSG(result.success, describe(maze, name));
+                if (!result.success) continue;
+                CHECK_NEAR(result.metrics.pathCost, reference.metrics.pathCost, describe(maze, name));
+                CHECK_MSG(validPath(maze, result), describe(maze, name));
+            }
+        }
+    }
+}
+
+TEST_CASE(startEqualsGoal) {
+    for (MovementMode mode : {MovementMode::FourWay, MovementMode::EightWay}) {
+        Maze maze = scenario(1);
+        maze.setMovementMode(mode);
+        maze.setEndpoints(1, 1, 1, 1);
+        for (const auto& [name, solve] : allSolvers()) {
+            AlgorithmResult result = solve(maze);
+            CHECK_MSG(result.success, describe(maze, name));
+            CHECK_MSG(result.metrics.pathLength == 1, describe(maze, name));
+            CHECK_NEAR(result.metrics.pathCost, 0.0, describe(maze, name));
+        }
+    }
+}
+
+TEST_CASE(diagonalsNeverCutCorners) {
+    // 6x6 with a border; (2,1) is a wall, so the diagonal (1,1) -> (2,2) would clip it
+    std::vector<bool> walls(36, false);
+    for (int i = 0; i < 6; ++i) walls[i] = walls[30 + i] = walls[i * 6] = walls[i * 6 + 5] = true;
+    walls[1 * 6 + 2] = true;
+    Maze maze(6, 6, walls);
+    maze.setMovementMode(MovementMode::EightWay);
+    maze.setEndpoints(1, 1, 2, 2);
+    for (const auto& [name, solve] : allSolvers()) {
+        AlgorithmResult result = solve(maze);
+        CHECK_MSG(result.success, name);
+        CHECK_NEAR(result.metrics.pathCost, 2.0, name);
+    }
+
+    // Both sides walled: the diagonal is the only contact, and it doesn't count
+    maze.setWall(1, 2, true);
+    for (const auto& [name, solve] : allSolvers()) {
+        AlgorithmResult result = solve(maze);
+        CHECK_MSG(!result.success && result.failure == FailureReason::Unreachable, name);
+    }
+}
+
+TEST_CASE(obstaclesReachTheirDensity) {
+    GeneratorOptions options;
+    options.seed = 7;
+    options.roomCount = 40;
+    options.maxRoomSize = 15;
+    for (double density : {0.05, 0.1, 0.2}) {
+        options.obstacleDensity = density;
+        Maze maze(151, 151, options);
+        // Exact up to rounding the target to whole cells
+        CHECK_MSG(std::abs(maze.getObstacleDensity() - density) < 1e-3,
+                  density << " asked, " << maze.getObstacleDensity() << " placed");
+        CHECK(AStar::solve(maze).success);
+    }
+
+    // Obstacles can't touch, so a dense target saturates below what was asked
+    options.obstacleDensity = 1.0;
+    Maze packed(151, 151, options);
+    CHECK_MSG(packed.getObstacleDensity() > 0.15 && packed.getObstacleDensity() < 1.0, packed.getObstacleDensity());
+    CHECK(AStar::solve(packed).success);
+}
+
+int main() {
+    return TestCheck::runAll();
+}
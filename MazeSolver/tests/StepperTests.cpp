@@ -0,0 +1,85 @@
+// The resumable step-wise API: stepping to the end gives the same search as solve().
+#include "TestCheck.h"
+#include "TestMazes.h"
+#include "../core/Landmarks.h"
+#include "../core/SearchStepper.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+
+using namespace TestMazes;
+
+TEST_CASE(steppersExpandLikeSolve) {
+    for (int i = 0; i < 12; ++i) {
+        Maze maze = scenario(i);
+        maze.setMovementMode(i % 2 ? MovementMode::EightWay : MovementMode::FourWay);
+        if (i % 4 == 3) maze.setLandmarks(LandmarkTable::build(maze, 4));
+        const std::pair<std::string, std::function<std::unique_ptr<SearchStepper>(Maze&)>> steppers[] = {
+            {"Dijkstra", [](Maze& m) { return Dijkstra::makeStepper(m); }},
+            {"A*", [](Maze& m) { return AStar::makeStepper(m); }},
+        };
+        for (const auto& [name, make] : steppers) {
+            std::unique_ptr<SearchStepper> stepper = make(maze);
+            while (!stepper->done()) stepper->step(5);
+            AlgorithmResult stepped = stepper->takeResult();
+            stepper.reset();
+            AlgorithmResult solved = name == "A*" ? AStar::solve(maze, noCallback) : Dijkstra::solve(maze, noCallback);
+            CHECK_MSG(stepped.visitedOrder == solved.visitedOrder, describe(maze, name));
+            CHECK_NEAR(stepped.metrics.pathCost, solved.metrics.pathCost, describe(maze, name));
+        }
+    }
+}
+
+TEST_CASE(runAndSolveShareOneDriver) {
+    // run() over a stepper and solve() over the same engine report the same search
+    Maze maze = scenario(5);
+    AStar::FourWayEngine engine(maze);
+    AlgorithmResult stepped = SearchStepper::run(engine, nullptr);
+    AlgorithmResult solved = AStar::solve(maze);
+    CHECK(stepped.success && solved.success);
+    CHECK(stepped.metrics.nodesExplored == solved.metrics.nodesExplored);
+    CHECK(stepped.metrics.heapPushes == solved.metrics.heapPushes);
+    CHECK(stepped.metrics.timeTakenMs > 0 && stepped.metrics.bytesAllocated > 0);
+
+    // A search that never finishes is cut off at the 2 s limit with its counters kept
+    AStar::FourWayEngine stuck(maze);
+    AlgorithmResult timedOut = SearchStepper::drive(stuck, false, [](size_t) {});
+    CHECK(!timedOut.success && timedOut.failure == FailureReason::TimedOut);
+    CHECK(timedOut.metrics.timeTakenMs >= 2000 * 1000);
+    CHECK(timedOut.metrics.bytesAllocated > 0 && timedOut.path.empty());
+}
+
+TEST_CASE(cancelStopsWithinOneBatch) {
+    // Large enough that neither search can finish inside the first batch
+    GeneratorOptions options;
+    options.seed = 31;
+    Maze maze(301, 301, options);
+    std::atomic<bool> cancel{false};
+    size_t events = 0;
+    // The callback plays the GUI: it cancels once it has seen a few events
+    auto callback = [&](Cell*, Cell*) {
+        if (++events == 10) cancel.store(true);
+    };
+    for (const auto& [name, make] : {std::make_pair("Dijkstra", &Dijkstra::makeStepper),
+                                     std::make_pair("A*", &AStar::makeStepper)}) {
+        cancel.store(false);
+        events = 0;
+        std::unique_ptr<SearchStepper> stepper = make(maze, nullptr);
+        AlgorithmResult result = SearchStepper::run(*stepper, callback, &cancel);
+        CHECK_MSG(!result.success && result.failure == FailureReason::Cancelled, name);
+        CHECK_MSG(result.metrics.nodesExplored <= SearchStepper::BATCH, name);
+        CHECK_MSG(result.path.empty(), name);
+    }
+
+    // Set before the start: no expansion at all
+    cancel.store(true);
+    AStar::FourWayEngine engine(maze);
+    AlgorithmResult result = SearchStepper::run(engine, nullptr, &cancel);
+    CHECK(result.failure == FailureReason::Cancelled && result.metrics.nodesExplored == 0);
+}
+
+int main() {
+    return TestCheck::runAll();
+}
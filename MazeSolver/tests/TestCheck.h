@@ -0,0 +1,71 @@
+#pragma once
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Just enough scaffolding for the behaviour tests: no framework, one executable per area,
+// exit code 0 when every check passed. CHECK records a failure and carries on, so a
+// single run reports every broken case.
+namespace TestCheck {
+    inline int& failures() {
+        static int count = 0;
+        return count;
+    }
+
+    inline void fail(const char* file, int line, const std::string& what) {
+        std::cout << "  " << file << ":" << line << ": FAILED " << what << "\n";
+        failures()++;
+    }
+
+    struct Case {
+        const char* name;
+        std::function<void()> body;
+    };
+
+    inline std::vector<Case>& cases() {
+        static std::vector<Case> all;
+        return all;
+    }
+
+    struct Registration {
+        Registration(const char* name, std::function<void()> body) { cases().push_back({name, std::move(body)}); }
+    };
+
+    inline int runAll() {
+        for (const Case& c : cases()) {
+            int before = failures();
+            c.body();
+            std::cout << (failures() == before ? "[  OK  ] " : "[FAILED] ") << c.name << "\n";
+        }
+        std::cout << cases().size() << " cases, " << failures() << " failed checks\n";
+        return failures() == 0 ? 0 : 1;
+    }
+}
+
+#define TEST_CASE(name)                                                            \
+    static void name();                                                            \
+    static TestCheck::Registration name##Registration(#name, name);                \
+    static void name()
+
+#define CHECK(condition)                                                           \
+    do {                                                                           \
+        if (!(condition)) TestCheck::fail(__FILE__, __LINE__, #condition);         \
+    } while (0)
+
+// 'context' is streamed into the failure message (which maze, which solver, ...)
+#define CHECK_MSG(condition, context)                                              \
+    do {                                                                           \
+        if (!(condition)) {                                                        \
+            std::ostringstream detail_;                                            \
+            detail_ << #condition << " [" << context << "]";                       \
+            TestCheck::fail(__FILE__, __LINE__, detail_.str());                    \
+        }                                                                          \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, context)                                      \
+    CHECK_MSG(std::abs((actual) - (expected)) < 1e-6,                              \
+              context << ": " << (actual) << " vs " << (expected))
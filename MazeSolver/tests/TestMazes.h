@@ -0,0 +1,71 @@
+#pragma once
+#include "../core/Maze.h"
+#include "../core/Utility.h"
+#include "../algorithms/AStar.h"
+#include "../algorithms/Dijkstra.h"
+#include "../algorithms/JumpPointSearch.h"
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Mazes and path checks shared by the solver tests
+namespace TestMazes {
+    // Perfect, braided, open-room and obstacle mazes of assorted sizes
+    inline Maze scenario(int index) {
+        GeneratorOptions options;
+        options.seed = 1000 + index;
+        switch (index % 4) {
+            case 1: options.braidFraction = 0.5; break;
+            case 2: options.roomCount = 6; break;
+            case 3: options.braidFraction = 1.0; options.obstacleDensity = 0.2; options.roomCount = 3; break;
+        }
+        return Maze(15 + (index * 7) % 40, 15 + (index * 11) % 30, options);
+    }
+
+    inline std::vector<std::pair<int, int>> openCells(const Maze& maze) {
+        std::vector<std::pair<int, int>> open;
+        for (int y = 0; y < maze.getHeight(); ++y)
+            for (int x = 0; x < maze.getWidth(); ++x)
+                if (maze.isWalkable(x, y)) open.emplace_back(x, y);
+        return open;
+    }
+
+    inline std::string describe(const Maze& maze, const std::string& solver) {
+        return solver + " on " + std::to_string(maze.getWidth()) + "x" + std::to_string(maze.getHeight()) +
+               (maze.getMovementMode() == MovementMode::EightWay ? " 8-way" : " 4-way") +
+               " seed " + std::to_string(maze.getSeed());
+    }
+
+    // Whichever form the result carries the path in
+    inline bool validPath(Maze& maze, const AlgorithmResult& result) {
+        return result.path.empty() ? Utility::validatePath(maze, result.route) : Utility::validatePath(maze, result.path);
+    }
+
+    // The walkable neighbours of (x, y), for sealing a cell in with setWall
+    inline std::vector<std::pair<int, int>> openAround(const Maze& maze, int x, int y) {
+        std::vector<std::pair<int, int>> around;
+        for (int dy = -1; dy <= 1; ++dy)
+            for (int dx = -1; dx <= 1; ++dx)
+                if ((dx || dy) && maze.isWalkable(x + dx, y + dy)) around.emplace_back(x + dx, y + dy);
+        return around;
+    }
+
+    typedef std::function<AlgorithmResult(Maze&)> Solver;
+
+    inline const auto noCallback = [](Cell*, Cell*) {};
+
+    // Both result levels of the one-directional solvers, plus the engine Dijkstra
+    // only runs when watched
+    inline std::vector<std::pair<std::string, Solver>> allSolvers() {
+        return {
+            {"Dijkstra", [](Maze& m) { return Dijkstra::solve(m); }},
+            {"Dijkstra compact", [](Maze& m) { return Dijkstra::solve(m, nullptr, ResultDetail::Compact); }},
+            {"Dijkstra engine", [](Maze& m) { return Dijkstra::solve(m, noCallback); }},
+            {"A*", [](Maze& m) { return AStar::solve(m); }},
+            {"A* compact", [](Maze& m) { return AStar::solve(m, nullptr, ResultDetail::Compact); }},
+            {"JPS", [](Maze& m) { return JumpPointSearch::solve(m); }},
+            {"JPS compact", [](Maze& m) { return JumpPointSearch::solve(m, nullptr, ResultDetail::Compact); }},
+        };
+    }
+}
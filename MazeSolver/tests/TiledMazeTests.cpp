@@ -0,0 +1,95 @@
+// The tiled on-disk representation and the out-of-core searches over it.
+#include "TestCheck.h"
+#include "../core/Maze.h"
+#include "../core/TiledMaze.h"
+#include "../algorithms/Dijkstra.h"
+#include "../algorithms/OutOfCoreSearch.h"
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+    std::string tempPath(const std::string& name) {
+        return (std::filesystem::temp_directory_path() / ("mazesolver_test_" + name)).string();
+    }
+
+    Maze mixedMaze(unsigned seed, int width, int height) {
+        GeneratorOptions options;
+        options.seed = seed;
+        options.braidFraction = 0.4;
+        options.roomCount = 4;
+        options.obstacleDensity = 0.1;
+        return Maze(width, height, options);
+    }
+}
+
+TEST_CASE(tiledFileRoundTrip) {
+    const std::string path = tempPath("roundtrip.mazetile");
+    // Not a multiple of the tile size, so the edge tiles carry padding
+    Maze original = mixedMaze(5, 151, 133);
+    original.setEndpoints(1, 1, 149, 131);
+    std::string error;
+    CHECK_MSG(TiledMaze::save(original, path, 64, error), error);
+
+    // Four tiles of cache for a 3x3-tile maze: the walk below has to evict
+    std::unique_ptr<TiledMaze> tiled = TiledMaze::open(path, 4, error);
+    CHECK_MSG(tiled != nullptr, error);
+    if (!tiled) return;
+    CHECK(tiled->getWidth() == 151 && tiled->getHeight() == 133 && tiled->getTileSize() == 64);
+    CHECK(tiled->getStartX() == 1 && tiled->getGoalX() == 149 && tiled->getGoalY() == 131);
+    for (int y = -1; y <= original.getHeight(); ++y)
+        for (int x = -1; x <= original.getWidth(); ++x)
+            CHECK_MSG(tiled->isWalkable(x, y) == original.isWalkable(x, y), x << "," << y);
+    CHECK(tiled->stats().evictions > 0);
+
+    for (MovementMode mode : {MovementMode::FourWay, MovementMode::EightWay}) {
+        original.setMovementMode(mode);
+        double expected = Dijkstra::solve(original).metrics.pathCost;
+        OutOfCoreResult astar = OutOfCoreSearch::astar(*tiled, 1, 1, 149, 131, mode);
+        CHECK(astar.success);
+        CHECK_NEAR(astar.metrics.pathCost, expected, "out-of-core A*");
+        CHECK(OutOfCoreSearch::validate(*tiled, 1, 1, 149, 131, mode, astar.moves));
+        if (mode == MovementMode::FourWay) {
+            OutOfCoreResult bfs = OutOfCoreSearch::bfs(*tiled, 1, 1, 149, 131, mode, false);
+            CHECK(bfs.success);
+            CHECK_NEAR(bfs.metrics.pathCost, expected, "out-of-core BFS");
+        }
+        OutOfCoreResult wall = OutOfCoreSearch::astar(*tiled, 0, 0, 149, 131, mode);
+        CHECK(!wall.success && wall.failure == FailureReason::MissingEndpoints);
+    }
+    tiled.reset();
+    std::remove(path.c_str());
+}
+
+TEST_CASE(labelStoreSpillsToScratchFile) {
+    const std::string path = tempPath("spill.mazetile");
+    Maze original = mixedMaze(9, 151, 133);
+    original.setEndpoints(1, 1, 149, 131);
+    std::string error;
+    CHECK_MSG(TiledMaze::save(original, path, 64, error), error);
+    std::unique_ptr<TiledMaze> tiled = TiledMaze::open(path, 4, error);
+    CHECK_MSG(tiled != nullptr, error);
+    if (!tiled) return;
+
+    // One resident label tile: every step across a tile border pages labels in and out
+    for (MovementMode mode : {MovementMode::FourWay, MovementMode::EightWay}) {
+        original.setMovementMode(mode);
+        double expected = Dijkstra::solve(original).metrics.pathCost;
+        OutOfCoreResult astar = OutOfCoreSearch::astar(*tiled, 1, 1, 149, 131, mode, true, 30000, 1);
+        CHECK_MSG(astar.success, astar.error);
+        CHECK(astar.labelSpills > 0);
+        CHECK_NEAR(astar.metrics.pathCost, expected, "spilling A*");
+        CHECK(OutOfCoreSearch::validate(*tiled, 1, 1, 149, 131, mode, astar.moves));
+        OutOfCoreResult bfs = OutOfCoreSearch::bfs(*tiled, 1, 1, 149, 131, mode, false, 30000, 1);
+        CHECK_MSG(bfs.success, bfs.error);
+        CHECK(bfs.labelSpills > 0);
+        CHECK(bfs.metrics.pathLength == OutOfCoreSearch::bfs(*tiled, 1, 1, 149, 131, mode).metrics.pathLength);
+    }
+    tiled.reset();
+    std::remove(path.c_str());
+}
+
+int main() {
+    return TestCheck::runAll();
+}